@@ -30,6 +30,10 @@
     ngx_log_error(NGX_LOG_ERR, log, 0, args);
 
 extern const char *json_content_str;
+extern const char *bin_content_str;
+
+/* Samples per signal the applications copy in rp_get_signals() */
+extern const ngx_int_t c_signal_length;
 
 typedef int (*rp_parse_body_func)(ngx_http_request_t *r);
 
@@ -38,6 +42,12 @@ typedef struct ngx_http_rp_loc_conf_s {
     ngx_str_t       bazaar_dir;
     ngx_str_t       bazaar_server;
     ngx_str_t       tmp_dir;
+    /* Samples allocated per signal for rp_get_signals(), rp_get_signals()
+     * does not get the capacity, so it can not be below c_signal_length
+     */
+    ngx_int_t       signal_length;
+    /* How long a data request waits for new signals */
+    ngx_msec_t      signal_wait;
     /* Internal structures */
     /* Be careful to use this only in local modules (it must be NULL all other
      * time.
@@ -93,6 +103,8 @@ int rp_module_cmd_again(cJSON **json_root, ngx_pool_t *pool);
 
 ngx_int_t rp_module_redirect(ngx_http_request_t *r, const char *location);
 ngx_int_t rp_module_send_response(ngx_http_request_t *r, cJSON **json_root);
+ngx_int_t rp_module_send_buffers(ngx_http_request_t *r, const char *content_type,
+                                 ngx_chain_t *out, off_t len);
 
 extern ngx_module_t ngx_http_rp_module;
 
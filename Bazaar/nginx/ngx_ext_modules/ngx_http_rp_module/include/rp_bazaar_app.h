@@ -53,6 +53,8 @@ typedef const char  *(*rp_app_desc_func)(void);
 typedef int          (*rp_set_params_func)(rp_app_params_t *p, int len);
 typedef int          (*rp_get_params_func)(rp_app_params_t **p);
 typedef int          (*rp_get_signals_func)(float ***s, int *sig_num, int *sig_len);
+/* Optional functions: */
+typedef void         (*rp_set_signals_notify_func)(void (*func)(void));
 
 /*WebSocket Server part*/
 typedef void		(*rp_ws_set_params_interval_func)(int);
@@ -64,6 +66,10 @@ typedef const char     *(*rp_ws_get_signals_func)(void);
 typedef int		(*rp_ws_set_params_func)(const char *_params);
 typedef int		(*rp_ws_set_signals_func)(const char *_signals);
 typedef void	(*rp_ws_gzip_func)(const char *_in, void* _data, size_t* _size);
+typedef const char     *(*rp_ws_get_signals_binary_func)(size_t *_size);
+typedef const char     *(*rp_ws_gzip_data_func)(const char *_in, size_t *_size);
+typedef void		(*rp_ws_set_signals_notify_func)(void (*_func)(void));
+typedef void		(*rp_ws_send_all_signals_func)(void);
 
 typedef struct rp_bazaar_app_s {
     /* Initialization function - called when app. is loaded */
@@ -83,6 +89,10 @@ typedef struct rp_bazaar_app_s {
     rp_get_params_func       get_params_func;
     /* Retrieves last good signals from the application */
     rp_get_signals_func      get_signals_func;
+    /* Registers the function the application calls when it has new signals.
+     * Optional, without it the data endpoint polls get_signals_func
+     */
+    rp_set_signals_notify_func set_signals_notify_func;
 
 	/*WebSocket Server part*/
 
@@ -98,6 +108,11 @@ typedef struct rp_bazaar_app_s {
 	rp_ws_set_params_interval_func ws_set_params_demo_func;
 	rp_ws_set_params_func verify_app_license_func;
 	rp_ws_gzip_func ws_gzip_func;
+	/* Optional, applications built with older rp_sdk do not have it */
+	rp_ws_get_signals_binary_func ws_get_signals_binary_func;
+	rp_ws_gzip_data_func ws_gzip_data_func;
+	rp_ws_set_signals_notify_func ws_set_signals_notify_func;
+	rp_ws_send_all_signals_func ws_send_all_signals_func;
 
     /* Dynamic library handle */
     void            *handle;
@@ -24,6 +24,8 @@
 
 /* Main handler */
 ngx_int_t rp_data_cmd_handler(ngx_http_request_t *r);
+/* Binary signals handler, see rp_data_bin_handler() for the format */
+ngx_int_t rp_data_bin_handler(ngx_http_request_t *r);
 
 /* Read out request body for POST */
 void rp_data_post_read(ngx_http_request_t *r);
@@ -41,6 +43,8 @@ int rp_data_set_signals(ngx_http_request_t *r, cJSON **json_root);
 int rp_data_get_signals(ngx_http_request_t *r, cJSON **json_root);
 /* Clear dirty flag in case of re-send */
 void rp_data_clear_signals_dirty();
+/* Called by the application (from any thread) when it has new signals */
+void rp_data_signals_ready(void);
 
 /* Helper functions */
 int rp_data_parse_and_set_params(cJSON *params_root);
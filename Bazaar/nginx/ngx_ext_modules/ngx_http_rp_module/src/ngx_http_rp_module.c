@@ -41,12 +41,17 @@
 
 /* constants */
 const char *json_content_str = "application/json";
+const char *bin_content_str  = "application/octet-stream";
 const char *c_bazaar_dir     = "/opt/redpitaya/www/apps";
 const char *c_bazaar_server  = "http://bazaar.redpitaya.com/";
 const char *c_tmp_dir        = "/tmp";
 
 const char *c_bazaar_uri = "/bazaar";
 const char *c_data_uri   = "/data";
+const char *c_data_bin_uri = "/data/bin";
+
+const ngx_int_t  c_signal_length = 2048;
+const ngx_msec_t c_signal_wait   = 200;
 
 ngx_http_rp_module_ctx_t rp_module_ctx;
 
@@ -81,6 +86,18 @@ ngx_command_t ngx_http_rp_commands[] = {
       NGX_HTTP_LOC_CONF_OFFSET,
       offsetof(ngx_http_rp_loc_conf_t, tmp_dir),
       NULL },
+    { ngx_string("rp_signal_length"),
+      NGX_HTTP_LOC_CONF|NGX_HTTP_SRV_CONF|NGX_HTTP_MAIN_CONF|NGX_CONF_TAKE1,
+      ngx_conf_set_num_slot,
+      NGX_HTTP_LOC_CONF_OFFSET,
+      offsetof(ngx_http_rp_loc_conf_t, signal_length),
+      NULL },
+    { ngx_string("rp_signal_wait"),
+      NGX_HTTP_LOC_CONF|NGX_HTTP_SRV_CONF|NGX_HTTP_MAIN_CONF|NGX_CONF_TAKE1,
+      ngx_conf_set_msec_slot,
+      NGX_HTTP_LOC_CONF_OFFSET,
+      offsetof(ngx_http_rp_loc_conf_t, signal_wait),
+      NULL },
     { ngx_string("rp_module_cmd"),
       NGX_HTTP_LOC_CONF|NGX_HTTP_SRV_CONF|NGX_HTTP_MAIN_CONF|NGX_CONF_NOARGS,
       ngx_http_rp_bazaar_cmd,
@@ -145,6 +162,8 @@ void *ngx_http_rp_create_loc_conf(ngx_conf_t *cf)
     }
 
     ngx_memset(conf, 0, sizeof(ngx_http_rp_loc_conf_t));
+    conf->signal_length = NGX_CONF_UNSET;
+    conf->signal_wait   = NGX_CONF_UNSET_MSEC;
 
     return conf;
 }
@@ -189,6 +208,16 @@ char *ngx_http_rp_merge_loc_conf(ngx_conf_t *cf, void *parent, void *child)
 
     ngx_conf_merge_str_value(conf->tmp_dir, prev->tmp_dir,
                              c_tmp_dir);
+    ngx_conf_merge_value(conf->signal_length, prev->signal_length,
+                         c_signal_length);
+    ngx_conf_merge_msec_value(conf->signal_wait, prev->signal_wait,
+                              c_signal_wait);
+
+    if(conf->signal_length < c_signal_length) {
+        rp_error(cf->log, "rp_signal_length must be at least %d",
+                 (int)c_signal_length);
+        return NGX_CONF_ERROR;
+    }
 
     if(stat((const char *)conf->bazaar_dir.data, &stat_buf) < 0) {
         rp_error(cf->log, "Can not open local Bazaar directory (%s): %s",
@@ -231,6 +260,12 @@ ngx_int_t ngx_http_rp_bazaar_cmd_handler(ngx_http_request_t *r)
         return rp_bazaar_cmd_handler(r);
     }
 
+    /* Binary data endpoint, must be checked before the data endpoint */
+    if((r->uri.len >= strlen(c_data_bin_uri)) &&
+       (ngx_strncmp(r->uri.data, c_data_bin_uri, strlen(c_data_bin_uri)) == 0)) {
+        return rp_data_bin_handler(r);
+    }
+
     /* Data endpoint */
     if((r->uri.len >= strlen(c_data_uri)) &&
        (ngx_strncmp(r->uri.data, c_data_uri, strlen(c_data_uri)) == 0)) {
@@ -371,9 +406,6 @@ ngx_int_t rp_module_send_response(ngx_http_request_t *r, cJSON **json_root)
     }
     out.buf = b;
     out.next = NULL;
-    r->headers_out.content_type_len = strlen(json_content_str);
-    r->headers_out.content_type.len = strlen(json_content_str);
-    r->headers_out.content_type.data = (u_char *)json_content_str;
 
     out_buffer = cJSON_PrintUnformatted(*json_root, r->pool);
     if(out_buffer == NULL) {
@@ -390,9 +422,6 @@ ngx_int_t rp_module_send_response(ngx_http_request_t *r, cJSON **json_root)
     b->last_buf = b->last_in_chain = 1;
     b->sync     = b->flush = 1;
 
-    r->headers_out.status = NGX_HTTP_OK;
-    r->headers_out.content_length_n = out_buffer_len;
-
     /* Debug purpopses - output params & status */
     j_params = cJSON_GetObjectItem(*json_root, "params");
     if(j_params != NULL) {
@@ -413,13 +442,39 @@ ngx_int_t rp_module_send_response(ngx_http_request_t *r, cJSON **json_root)
 
     cJSON_Delete(*json_root, r->pool);
 
-    rc = ngx_http_send_header(r);
-
     /* If error while sending OK output we re-send it */
+    rc = rp_module_send_buffers(r, json_content_str, &out, out_buffer_len);
     if((rc == NGX_ERROR) && (r->method == NGX_HTTP_GET) && j_status &&
        (j_status->valuestring[0] = 'O') && (j_status->valuestring[1] == 'K')) {
         rp_data_clear_signals_dirty();
     }
+
+    return rc;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/**
+ * @brief Sends the headers and the whole output chain.
+ *
+ * The last buffer in the chain must have last_buf set. Buffers may point to
+ * static memory, the chain is completely written when the function returns.
+ *
+ * @retval NGX_DONE   the response was sent
+ * @retval other      returned value from ngx_http_send_header()
+ */
+ngx_int_t rp_module_send_buffers(ngx_http_request_t *r, const char *content_type,
+                                 ngx_chain_t *out, off_t len)
+{
+    ngx_int_t rc;
+
+    r->headers_out.content_type_len = strlen(content_type);
+    r->headers_out.content_type.len = strlen(content_type);
+    r->headers_out.content_type.data = (u_char *)content_type;
+    r->headers_out.status = NGX_HTTP_OK;
+    r->headers_out.content_length_n = len;
+
+    rc = ngx_http_send_header(r);
     if (rc == NGX_ERROR || rc > NGX_OK || r->header_only) {
         return rc;
     }
@@ -431,10 +486,10 @@ ngx_int_t rp_module_send_response(ngx_http_request_t *r, cJSON **json_root)
     /* send the buffer chain of your response */
     /* Temp, got from ruby-forum.com - put socket to blocking */
     ngx_blocking(r->connection->fd);
-    rc = ngx_http_output_filter(r, &out);
+    rc = ngx_http_output_filter(r, out);
     while(rc == NGX_AGAIN) {
         r->connection->write->ready = 1;
-        rc = ngx_http_output_filter(r, &out);
+        rc = ngx_http_output_filter(r, NULL);
         if(rc == NGX_ERROR)
             break;
     }
@@ -443,4 +498,3 @@ ngx_int_t rp_module_send_response(ngx_http_request_t *r, cJSON **json_root)
 
     return NGX_DONE;
 }
-
@@ -36,6 +36,7 @@ const char *c_rp_set_params_str   = "rp_set_params";
 const char *c_rp_get_params_str   = "rp_get_params";
 const char *c_rp_set_signals_str  = "rp_set_signals";
 const char *c_rp_get_signals_str  = "rp_get_signals";
+const char *c_rp_set_signals_notify_str = "rp_set_signals_notify";
 
 //start web socket function str
 
@@ -48,6 +49,10 @@ const char *c_ws_get_params_str   = "ws_get_params";
 const char *c_ws_set_signals_str  = "ws_set_signals";
 const char *c_ws_get_signals_str  = "ws_get_signals";
 const char* c_ws_gzip_str = "ws_gzip";
+const char *c_ws_get_signals_binary_str = "ws_get_signals_binary";
+const char *c_ws_gzip_data_str = "ws_gzip_data";
+const char *c_ws_set_signals_notify_str = "ws_set_signals_notify";
+const char *c_ws_send_all_signals_str = "ws_send_all_signals";
 // end web socket function str
 
 /** Get MAC address of a specific NIC via sysfs */
@@ -404,6 +409,9 @@ int rp_bazaar_app_load_module(const char *app_file, rp_bazaar_app_t *app)
     if(!app->get_signals_func)
         return -7;
 
+    /* Optional, signals are polled if it is missing */
+    app->set_signals_notify_func = dlsym(app->handle, c_rp_set_signals_notify_str);
+
     // start web socket functionality
     app->ws_api_supported = 1;
     app->ws_set_params_interval_func = dlsym(app->handle, c_ws_set_params_interval_str);
@@ -469,6 +477,15 @@ int rp_bazaar_app_load_module(const char *app_file, rp_bazaar_app_t *app)
         fprintf(stderr, "Cannot resolve '%s' function.\n", c_ws_gzip_str);
     }
 
+    /* Optional, signals are sent as JSON only if it is missing */
+    app->ws_get_signals_binary_func = dlsym(app->handle, c_ws_get_signals_binary_str);
+    /* Optional, ws_gzip is used if it is missing */
+    app->ws_gzip_data_func = dlsym(app->handle, c_ws_gzip_data_str);
+    /* Optional, signals are only polled if it is missing */
+    app->ws_set_signals_notify_func = dlsym(app->handle, c_ws_set_signals_notify_str);
+    /* Optional, clients that missed a signal frame are not resynced if it is missing */
+    app->ws_send_all_signals_func = dlsym(app->handle, c_ws_send_all_signals_str);
+
     // end web socket functionality
 
     app->file_name = (char *)malloc(strlen(app_file)+1);
@@ -485,6 +502,9 @@ int rp_bazaar_app_unload_module(rp_bazaar_app_t *app)
 {
     stop_ws_server();
     if(app->handle) {
+        if(app->initialized && app->set_signals_notify_func) {
+            app->set_signals_notify_func(NULL);
+        }
         if(app->initialized && app->exit_func) {
             app->exit_func();
         }
@@ -22,6 +22,7 @@
 #include "ngx_http_rp_module.h"
 #include "rp_bazaar_cmd.h"
 #include "rp_bazaar_app.h"
+#include "rp_data_cmd.h"
 #include "cJSON.h"
 #include <ws_server.h>
 #include <stdlib.h>
@@ -524,6 +525,9 @@ int rp_bazaar_start(ngx_http_request_t *r,
     rp_module_ctx.app.initialized=1;
     fprintf(stderr, "Application loaded succesfully!\n");
 
+    if(rp_module_ctx.app.set_signals_notify_func)
+        rp_module_ctx.app.set_signals_notify_func(rp_data_signals_ready);
+
     //start web socket server
     if(rp_module_ctx.app.ws_api_supported)
     {
@@ -539,6 +543,10 @@ int rp_bazaar_start(ngx_http_request_t *r,
         params.get_signals_func = rp_module_ctx.app.ws_get_signals_func;
         params.set_signals_func = rp_module_ctx.app.ws_set_signals_func;
         params.gzip_func = rp_module_ctx.app.ws_gzip_func;
+        params.get_signals_binary_func = rp_module_ctx.app.ws_get_signals_binary_func;
+        params.gzip_data_func = rp_module_ctx.app.ws_gzip_data_func;
+        params.set_signals_notify_func = rp_module_ctx.app.ws_set_signals_notify_func;
+        params.send_all_signals_func = rp_module_ctx.app.ws_send_all_signals_func;
         fprintf(stderr, "Starting WS-server\n");
 
         start_ws_server(&params);
@@ -21,10 +21,35 @@
 #include "rp_data_cmd.h"
 #include "cJSON.h"
 
+#include <pthread.h>
+#include <errno.h>
+#include <math.h>
+
+/* number of signals rp_get_signals() can return */
+#define RP_DATA_SIGNALS_NUM 3
+
 /* last good result container */
 static float **rp_signals = NULL;
+static int     rp_signals_len = 0;
 static int     rp_signals_dirty = 0;
 
+/* bumped by rp_data_signals_ready() */
+static pthread_mutex_t rp_signals_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  rp_signals_cond  = PTHREAD_COND_INITIALIZER;
+static unsigned int    rp_signals_seq   = 0;
+
+/* binary response header, see rp_data_bin_handler() */
+typedef struct rp_data_bin_hdr_s {
+    char     magic[4];
+    uint16_t version;
+    uint16_t sig_num;
+    uint32_t sig_len;
+    uint32_t json_size;
+} rp_data_bin_hdr_t;
+
+#define RP_DATA_BIN_MAGIC   "RPDT"
+#define RP_DATA_BIN_VERSION 1
+
 #define TRACE(args...) fprintf(stderr, args)
 
 
@@ -410,52 +435,156 @@ int rp_data_get_params(ngx_http_request_t *r, cJSON **json_root)
 
 
 /*----------------------------------------------------------------------------*/
-int rp_data_get_signals(ngx_http_request_t *r, cJSON **json_root)
+/**
+ * @brief (Re)allocates the last good result container.
+ *
+ * @param[in]  len  number of samples per signal
+ * @retval     0    success
+ * @retval    -1    failure
+ */
+static int rp_data_alloc_signals(int len)
 {
-    int rp_sig_num, rp_sig_len, ret_val;
-    cJSON *data_root, *sig_root, *d1, *d2, *g1;
-    /* TODO: Make it configurable */
-    int retries = 200; /* Approx in [ms] */
+    int i;
+
+    if((rp_signals != NULL) && (rp_signals_len == len))
+        return 0;
 
     if(rp_signals == NULL) {
-        int i;
-        rp_signals = (float **)malloc(3 * sizeof(float *));
-        for(i = 0; i < 3; i++) {
-            rp_signals[i] = (float *)malloc(2048 * sizeof(float));
+        rp_signals = (float **)calloc(RP_DATA_SIGNALS_NUM, sizeof(float *));
+        if(rp_signals == NULL)
+            return -1;
+    }
+
+    for(i = 0; i < RP_DATA_SIGNALS_NUM; i++) {
+        free(rp_signals[i]);
+        rp_signals[i] = (float *)calloc(len, sizeof(float));
+        if(rp_signals[i] == NULL) {
+            rp_signals_len = 0;
+            return -1;
         }
     }
+    rp_signals_len = len;
+    rp_signals_dirty = 0;
 
-    data_root = cJSON_GetObjectItem(*json_root, "datasets");
-    if(data_root == NULL) {
-        return rp_module_cmd_error(json_root, 
-                                   "Can not find 'data'", NULL, 
-                                   r->pool);
+    return 0;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/**
+ * @brief Retrieves signals from the application into rp_signals.
+ *
+ * If the application has no new signals the function waits for them up to
+ * the configured rp_signal_wait. Applications which export
+ * rp_set_signals_notify() wake us up when the signals are ready, the others
+ * are polled every millisecond.
+ *
+ * @param[in]  r        HTTP request as defined by NGINX framework
+ * @param[out] sig_num  number of signals
+ * @param[out] sig_len  number of samples per signal
+ * @retval     0        new signals
+ * @retval    -1        no new signals, rp_signals holds the last good ones
+ * @retval    -2        signals are not complete yet
+ * @retval    -3        failure while allocating the container
+ */
+static int rp_data_fetch_signals(ngx_http_request_t *r, int *sig_num,
+                                 int *sig_len)
+{
+    ngx_http_rp_loc_conf_t *lc;
+    struct timespec deadline;
+    unsigned int seq;
+    int ret_val, rc = 0;
+    int retries;
+    ngx_int_t len;
+
+    lc = ngx_http_get_module_loc_conf(r, ngx_http_rp_module);
+
+    /* Applications always copy their full signal length */
+    len = ngx_max(lc->signal_length, c_signal_length);
+    if(rp_data_alloc_signals(len) < 0) {
+        rp_error(r->connection->log, "Can not allocate signals (%d samples)",
+                 (int)len);
+        return -3;
     }
-    
-    ret_val =
-        rp_module_ctx.app.get_signals_func((float ***)&rp_signals, &rp_sig_num, 
-                                           &rp_sig_len);
-
-    while(ret_val == -1) {
-        ret_val =
-            rp_module_ctx.app.get_signals_func((float ***)&rp_signals, 
-                                               &rp_sig_num, &rp_sig_len);
-
-        if(ret_val == -2) 
-            break;
-        if(retries-- <= 0) {
-            /* Use old signals */
-            break;
-        } else {
+
+    *sig_num = 0;
+    *sig_len = 0;
+
+    pthread_mutex_lock(&rp_signals_mutex);
+    seq = rp_signals_seq;
+    pthread_mutex_unlock(&rp_signals_mutex);
+
+    ret_val = rp_module_ctx.app.get_signals_func((float ***)&rp_signals,
+                                                 sig_num, sig_len);
+
+    if(!rp_module_ctx.app.set_signals_notify_func) {
+        retries = lc->signal_wait; /* Approx in [ms] */
+        while((ret_val == -1) && (retries-- > 0)) {
             usleep(1000);
+            ret_val =
+                rp_module_ctx.app.get_signals_func((float ***)&rp_signals,
+                                                   sig_num, sig_len);
         }
+    } else if(ret_val == -1) {
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec  += lc->signal_wait / 1000;
+        deadline.tv_nsec += (lc->signal_wait % 1000) * 1000000;
+        if(deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+
+        while((ret_val == -1) && (rc != ETIMEDOUT)) {
+            pthread_mutex_lock(&rp_signals_mutex);
+            while((seq == rp_signals_seq) && (rc != ETIMEDOUT)) {
+                rc = pthread_cond_timedwait(&rp_signals_cond,
+                                            &rp_signals_mutex, &deadline);
+            }
+            seq = rp_signals_seq;
+            pthread_mutex_unlock(&rp_signals_mutex);
+
+            ret_val =
+                rp_module_ctx.app.get_signals_func((float ***)&rp_signals,
+                                                   sig_num, sig_len);
+        }
+    }
+
+    if(*sig_num > RP_DATA_SIGNALS_NUM)
+        *sig_num = RP_DATA_SIGNALS_NUM;
+    if(*sig_len > rp_signals_len) {
+        rp_error(r->connection->log, "Application returned %d samples, "
+                 "rp_signal_length is %d", *sig_len, rp_signals_len);
+        *sig_len = rp_signals_len;
     }
-    ret_val = ret_val;
+
     /* In case we are repeating the transmission */
     if((rp_signals_dirty == 0) && (ret_val == -1))
         ret_val = 0;
     rp_signals_dirty = 1;
 
+    return ret_val;
+}
+
+
+/*----------------------------------------------------------------------------*/
+int rp_data_get_signals(ngx_http_request_t *r, cJSON **json_root)
+{
+    int rp_sig_num, rp_sig_len, ret_val;
+    cJSON *data_root, *sig_root, *d1, *d2, *g1;
+
+    data_root = cJSON_GetObjectItem(*json_root, "datasets");
+    if(data_root == NULL) {
+        return rp_module_cmd_error(json_root, 
+                                   "Can not find 'data'", NULL, 
+                                   r->pool);
+    }
+
+    ret_val = rp_data_fetch_signals(r, &rp_sig_num, &rp_sig_len);
+    if(ret_val == -3) {
+        return rp_module_cmd_error(json_root, "Can not allocate signals",
+                                   NULL, r->pool);
+    }
+
     cJSON_AddItemToObject(data_root, "g1",
                           g1=cJSON_CreateArray(r->pool), r->pool);
 
@@ -475,6 +604,178 @@ int rp_data_get_signals(ngx_http_request_t *r, cJSON **json_root)
     return ret_val;
 }
 
+
+/*----------------------------------------------------------------------------*/
+/**
+ * @brief Prints the JSON part of the binary response.
+ *
+ * Same content as the /data GET response without the signals:
+ * {"app":{"id":...},"datasets":{"params":{...}},"status":...}
+ *
+ * @retval  NULL  failure while allocating or retrieving the parameters
+ */
+static ngx_buf_t *rp_data_bin_json(ngx_http_request_t *r, const char *app_id,
+                                   const char *status)
+{
+    rp_app_params_t *rp_params = NULL;
+    int rp_params_cnt, i;
+    size_t size;
+    ngx_buf_t *b;
+    char *p, *end;
+
+    rp_params_cnt = rp_module_ctx.app.get_params_func(&rp_params);
+    if(rp_params == NULL)
+        return NULL;
+
+    size = strlen(app_id) + strlen(status) + 64;
+    for(i = 0; i < rp_params_cnt; i++)
+        size += strlen(rp_params[i].name) + 24;
+
+    b = ngx_create_temp_buf(r->pool, size);
+    if(b != NULL) {
+        p = (char *)b->pos;
+        end = p + size;
+        p += snprintf(p, end - p, "{\"app\":{\"id\":\"%s\"},"
+                      "\"datasets\":{\"params\":{", app_id);
+        for(i = 0; i < rp_params_cnt; i++) {
+            float value = rp_params[i].value;
+            p += snprintf(p, end - p, "%s\"%s\":%.9g", i ? "," : "",
+                          rp_params[i].name, isfinite(value) ? value : 0);
+        }
+        p += snprintf(p, end - p, "}},\"status\":\"%s\"}", status);
+        b->last = (u_char *)p;
+    }
+
+    for(i = 0; i < rp_params_cnt; i++) {
+        if(rp_params[i].name)
+            free((char *)rp_params[i].name);
+    }
+    free(rp_params);
+
+    return b;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/**
+ * @brief Handler function for /data/bin GET requests.
+ *
+ * Returns the same data as /data GET without building the JSON tree. The
+ * signals are sent directly from the last good result container.
+ * All values are little-endian:
+ *
+ *   char     magic[4]   "RPDT"
+ *   uint16_t version
+ *   uint16_t sig_num
+ *   uint32_t sig_len    number of samples per signal
+ *   uint32_t json_size
+ *   float    signals[sig_num][sig_len]
+ *   char     json[json_size]  app id, params and status like in /data
+ *
+ * Errors are returned as JSON, the same as from /data.
+ *
+ * @retval NGX_HTTP_NOT_ALLOWED            The required operation is not allowed
+ * @retval NGX_HTTP_INTERNAL_SERVER_ERROR  Failure while allocating the response
+ * @retval other                           returned value from rp_module_send_buffers()
+ */
+ngx_int_t rp_data_bin_handler(ngx_http_request_t *r)
+{
+    int rp_sig_num, rp_sig_len, ret_val, i;
+    rp_data_bin_hdr_t *hdr;
+    ngx_buf_t *b;
+    ngx_chain_t *out, **ll;
+    off_t len;
+    ngx_int_t rc;
+    cJSON *json_root;
+    char *app_id;
+
+    if(!(r->method & NGX_HTTP_GET)) {
+        return NGX_HTTP_NOT_ALLOWED;
+    }
+
+    rc = ngx_http_discard_request_body(r);
+    if(rc != NGX_OK) {
+        return rc;
+    }
+
+    if(!rp_module_ctx.app.handle) {
+        json_root = cJSON_CreateObject(r->pool);
+        if(json_root == NULL) {
+            rp_error(r->connection->log, "Can not allocate cJSON object");
+            return NGX_HTTP_INTERNAL_SERVER_ERROR;
+        }
+        rp_error(r->connection->log, "Application not loaded");
+        rp_module_cmd_error(&json_root, "Application not loaded", NULL,
+                            r->pool);
+        return rp_module_send_response(r, &json_root);
+    }
+
+    app_id = rp_module_ctx.app.id;
+    if (!app_id) {
+        app_id = "unknown";
+    }
+
+    ret_val = rp_data_fetch_signals(r, &rp_sig_num, &rp_sig_len);
+    if(ret_val == -3) {
+        return NGX_HTTP_INTERNAL_SERVER_ERROR;
+    }
+
+    b = ngx_create_temp_buf(r->pool, sizeof(rp_data_bin_hdr_t));
+    if(b == NULL) {
+        return NGX_HTTP_INTERNAL_SERVER_ERROR;
+    }
+    hdr = (rp_data_bin_hdr_t *)b->pos;
+    memcpy(hdr->magic, RP_DATA_BIN_MAGIC, sizeof(hdr->magic));
+    hdr->version = RP_DATA_BIN_VERSION;
+    hdr->sig_num = rp_sig_num;
+    hdr->sig_len = rp_sig_len;
+    b->last += sizeof(rp_data_bin_hdr_t);
+
+    out = ngx_alloc_chain_link(r->pool);
+    if(out == NULL) {
+        return NGX_HTTP_INTERNAL_SERVER_ERROR;
+    }
+    out->buf = b;
+    ll = &out->next;
+    len = b->last - b->pos;
+
+    for(i = 0; i < rp_sig_num; i++) {
+        b = ngx_calloc_buf(r->pool);
+        *ll = ngx_alloc_chain_link(r->pool);
+        if((b == NULL) || (*ll == NULL)) {
+            return NGX_HTTP_INTERNAL_SERVER_ERROR;
+        }
+        b->pos = (u_char *)&rp_signals[i][0];
+        b->last = b->pos + rp_sig_len * sizeof(float);
+        b->memory = 1;
+        (*ll)->buf = b;
+        ll = &(*ll)->next;
+        len += b->last - b->pos;
+    }
+
+    b = rp_data_bin_json(r, app_id, (ret_val == 0) ? "OK" : "AGAIN");
+    *ll = ngx_alloc_chain_link(r->pool);
+    if((b == NULL) || (*ll == NULL)) {
+        rp_error(r->connection->log, "Can not retrieve parameters");
+        return NGX_HTTP_INTERNAL_SERVER_ERROR;
+    }
+    b->last_buf = b->last_in_chain = 1;
+    b->sync     = b->flush = 1;
+    (*ll)->buf = b;
+    (*ll)->next = NULL;
+    len += b->last - b->pos;
+    hdr->json_size = b->last - b->pos;
+
+    rc = rp_module_send_buffers(r, bin_content_str, out, len);
+
+    /* If error while sending OK output we re-send it */
+    if((rc == NGX_ERROR) && (ret_val == 0)) {
+        rp_data_clear_signals_dirty();
+    }
+
+    return rc;
+}
+
 /*----------------------------------------------------------------------------*/
 /**
  * @brief Clear Signal Dirty flag
@@ -483,3 +784,19 @@ void rp_data_clear_signals_dirty()
 {
     rp_signals_dirty = 0;
 }
+
+
+/*----------------------------------------------------------------------------*/
+/**
+ * @brief Wakes up requests waiting for new signals.
+ *
+ * Registered with the application's rp_set_signals_notify(). Called from
+ * the application threads.
+ */
+void rp_data_signals_ready(void)
+{
+    pthread_mutex_lock(&rp_signals_mutex);
+    rp_signals_seq++;
+    pthread_cond_broadcast(&rp_signals_cond);
+    pthread_mutex_unlock(&rp_signals_mutex);
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <libjson.h>
 
 class CBaseParameter  //base class for parameter and signal
@@ -27,4 +28,6 @@ public:
 	virtual bool IsNewValue() const = 0;
 	virtual void ClearNewValue() = 0;
 	virtual bool NeedSend(bool _no_need=false) const { return _no_need; };
+	virtual bool IsBinaryMode() const { return false; };	// signal is sent as raw array in the binary frame
+	virtual void WriteBinary(std::string& _frame) const {};	// append signal record to the binary frame
 };
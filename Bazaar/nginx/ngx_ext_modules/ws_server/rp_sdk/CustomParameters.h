@@ -4,6 +4,7 @@
 #include <string.h>
 
 #include "Parameter.h"
+#include "SignalFrame.h"
 
 #define CONFIG_VAR 1
 
@@ -186,11 +187,13 @@ template <typename Type> class CCustomSignal : public CParameter<Type, std::vect
 public:
 	CCustomSignal(std::string _name, int _size, Type _def_value)
 		:CParameter<Type, std::vector<Type> >(_name, CBaseParameter::RO, std::vector<Type>(_size, _def_value)),
-		m_Dirty(true){}
+		m_Dirty(true),
+		m_Binary(false){}
 
 	CCustomSignal(std::string _name, CBaseParameter::AccessMode _access_mode, int _size, Type _def_value)
 		:CParameter<Type, std::vector<Type> >(_name, _access_mode, std::vector<Type>(_size, _def_value)),
-		m_Dirty(true) {}
+		m_Dirty(true),
+		m_Binary(false) {}
 
 	~CCustomSignal()
 	{
@@ -270,8 +273,27 @@ public:
 		m_Dirty = true;
 		return true;
 	}
+
+	// Send the signal as raw array in the binary frame instead of JSON.
+	// The web application must be able to decode binary frames.
+	void SetBinaryMode(bool _binary)
+	{
+		m_Binary = _binary && SignalFrameTypeOf<Type>::value != SF_UNSUPPORTED;
+	}
+
+	bool IsBinaryMode() const
+	{
+		return m_Binary;
+	}
+
+	void WriteBinary(std::string& _frame) const
+	{
+		SignalFrameAppend(_frame, this->m_Value.name, SignalFrameTypeOf<Type>::value,
+			this->m_Value.value.data(), this->m_Value.value.size(), sizeof(Type));
+	}
 private:
 	bool m_Dirty;
+	bool m_Binary;
 };
 
 //custom CIntParameter
@@ -358,6 +380,17 @@ public:
 		:CCustomSignal(_name, _access_mode, _size, _def_value){};
 };
 
+//custom CShortSignal
+class CShortSignal : public CCustomSignal<int16_t>
+{
+public:
+	CShortSignal(std::string _name, int _size, int16_t _def_value)
+		:CCustomSignal(_name, _size, _def_value){};
+
+	CShortSignal(std::string _name, CBaseParameter::AccessMode _access_mode, int _size, int16_t _def_value)
+		:CCustomSignal(_name, _access_mode, _size, _def_value){};
+};
+
 //custom CByteSignal
 class CByteSignal : public CCustomSignal<uint8_t>
 {
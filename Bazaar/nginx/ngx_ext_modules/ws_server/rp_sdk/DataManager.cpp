@@ -6,6 +6,7 @@
 #include "misc.h"
 
 #include "gziping.h"
+#include "SignalFrame.h"
 
 CStringParameter InCommandParam("in_command", CBaseParameter::WO, "", 1);
 CStringParameter OutCommandParam("out_command", CBaseParameter::RO, "", 1);
@@ -40,6 +41,9 @@ CDataManager::CDataManager()
 	, m_param_interval(20)
 	, m_signal_interval(20)
 	, m_send_all_params(true)
+	, m_send_all_signals(false)
+	, m_signals_frame()
+	, m_signals_notify(nullptr)
 {
 }
 
@@ -129,11 +133,22 @@ std::string CDataManager::GetSignalsJson()
 	UpdateSignals();
 	JSONNode signals(JSON_NODE);
 	signals.set_name("signals");
+	uint16_t binary_count = 0;
+	bool send_all = m_send_all_signals.exchange(false);
+	m_signals_frame.clear();
 	for(size_t i=0; i < m_signals.size(); i++) {
-		if(NeedSend(*m_signals[i])) {
-			JSONNode n(JSON_NODE);
-			n = m_signals[i]->GetJSONObject();
-			signals.push_back(n);
+		if(NeedSend(*m_signals[i])
+			|| (send_all && m_signals[i]->GetAccessMode() != CBaseParameter::AccessMode::WO)) {
+			if(m_signals[i]->IsBinaryMode()) {
+				if(binary_count == 0)
+					SignalFrameBegin(m_signals_frame);
+				m_signals[i]->WriteBinary(m_signals_frame);
+				binary_count++;
+			} else {
+				JSONNode n(JSON_NODE);
+				n = m_signals[i]->GetJSONObject();
+				signals.push_back(n);
+			}
 			m_signals[i]->Update();
 		}
 	}
@@ -142,7 +157,15 @@ std::string CDataManager::GetSignalsJson()
 	data_node.set_name("data");
 	data_node.push_back(signals);
 	PostUpdateSignals();
-	return data_node.write();
+	std::string json = data_node.write();
+	if(binary_count)
+		SignalFrameEnd(m_signals_frame, binary_count, json);
+	return json;
+}
+
+const std::string& CDataManager::GetSignalsFrame()
+{
+	return m_signals_frame;
 }
 
 void CDataManager::OnNewParams(std::string _params)
@@ -228,6 +251,23 @@ void CDataManager::SendAllParams()
 	m_send_all_params = true;
 }
 
+void CDataManager::SendAllSignals()
+{
+	m_send_all_signals = true;
+}
+
+void CDataManager::NotifySignalsReady()
+{
+	signals_notify_func func = m_signals_notify.load();
+	if(func)
+		func();
+}
+
+void CDataManager::SetSignalsNotify(signals_notify_func _func)
+{
+	m_signals_notify = _func;
+}
+
 // DEPRECATED
 std::map<std::string, bool> CDataManager::GetFeatures(const std::string& app_id)
 {
@@ -289,6 +329,39 @@ extern "C" const char* ws_get_signals(void)
 	return res.c_str();
 }
 
+extern "C" void ws_set_signals_notify(signals_notify_func _func)
+{
+	CDataManager * man = CDataManager::GetInstance();
+	if(man)
+	{
+		man->SetSignalsNotify(_func);
+		dbg_printf("Set signals notify\n");
+	}
+}
+
+// Called by the websocket server when a client missed a signal frame,
+// the next ws_get_signals call returns every signal
+extern "C" void ws_send_all_signals(void)
+{
+	CDataManager * man = CDataManager::GetInstance();
+	if(man)
+		man->SendAllSignals();
+}
+
+// Binary frame prepared by the last ws_get_signals call
+extern "C" const char* ws_get_signals_binary(size_t *_size)
+{
+	CDataManager * man = CDataManager::GetInstance();
+	*_size = 0;
+	if(man)
+	{
+		const std::string& frame = man->GetSignalsFrame();
+		*_size = frame.size();
+		return frame.data();
+	}
+	return NULL;
+}
+
 extern "C" void ws_set_params_interval(int _interval)
 {
 	CDataManager * man = CDataManager::GetInstance();
@@ -339,3 +412,14 @@ extern "C" void ws_gzip(const char* _in, void* _out, size_t* _size)
 	memcpy(_out, out.data(), out.size());
 	*_size = out.size();
 }
+
+// Same as ws_gzip, but the result stays in a buffer owned by the library
+// until the next call from the same thread
+extern "C" const char* ws_gzip_data(const char* _in, size_t* _size)
+{
+	thread_local std::string out;
+	out.clear();
+	Gziping(_in, out);
+	*_size = out.size();
+	return out.data();
+}
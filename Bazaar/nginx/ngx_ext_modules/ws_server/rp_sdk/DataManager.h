@@ -2,8 +2,12 @@
 
 #include <vector>
 #include <map>
+#include <string>
+#include <atomic>
 #include "BaseParameter.h"
 
+typedef void (*signals_notify_func)(void);
+
 struct Data {
 	char* data;
 	size_t size;
@@ -23,6 +27,9 @@ private:
 	int m_param_interval; //parameters send time interval in milliseconds
 	int m_signal_interval; //signals send time interval in milliseconds
 	bool m_send_all_params;
+	std::atomic<bool> m_send_all_signals; // the next GetSignalsJson call sends every signal
+	std::string m_signals_frame; // binary frame built by the last GetSignalsJson call
+	std::atomic<signals_notify_func> m_signals_notify; // set by the websocket server
 
 public:
 	static CDataManager* GetInstance();
@@ -51,6 +58,7 @@ public:
 
 	std::string GetParamsJson(); //get all parameters in JSON-formatted string
 	std::string GetSignalsJson(); //get all signals in JSON-formatted string
+	const std::string& GetSignalsFrame(); //binary frame with signals in binary mode, empty if none of them changed
 
 	void OnNewParams(std::string _params); //is involved when new data received from server, data is JSON-formatted string
 	void OnNewSignals(std::string _signals); //is involved when new data received from server, data is JSON-formatted string
@@ -62,6 +70,12 @@ public:
 	void SetSignalInterval(int _interval);
 
 	void SendAllParams();
+	void SendAllSignals();
+
+	// Tells the websocket server that new signal data is ready, it sends signals without waiting
+	// for the signal interval. Can be called from any thread.
+	void NotifySignalsReady();
+	void SetSignalsNotify(signals_notify_func _func);
 
 	// DEPRECATED
 	std::map<std::string, bool> GetFeatures(const std::string& app_id);
@@ -83,6 +97,10 @@ extern "C" int ws_get_params_interval(void);
 extern "C" int ws_get_signals_interval(void);
 extern "C" const char * ws_get_params(void);
 extern "C" const char * ws_get_signals(void);
+extern "C" const char * ws_get_signals_binary(size_t *_size);
 extern "C" int ws_set_params(const char *_params);
 extern "C" int ws_set_signals(const char *_signals);
 extern "C" void ws_gzip(const char* _in, void* _out, size_t* size_);
+extern "C" const char* ws_gzip_data(const char* _in, size_t* _size);
+extern "C" void ws_set_signals_notify(signals_notify_func _func);
+extern "C" void ws_send_all_signals(void);
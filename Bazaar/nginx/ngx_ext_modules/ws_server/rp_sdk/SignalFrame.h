@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Binary signal frame. Sent instead of the gzipped JSON when at least one
+ * signal in binary mode has changed. All values are little-endian.
+ *
+ * Header (16 bytes):
+ *   char     magic[4]   "RPSG"
+ *   uint16_t version
+ *   uint16_t count      number of signal records
+ *   uint32_t json_size  size of the JSON text at the end of the frame
+ *   uint32_t reserved
+ *
+ * Signal record:
+ *   uint16_t name_size
+ *   uint8_t  type       SignalFrameType
+ *   uint8_t  flags      0 for records written here, SF_RECORD_DELTA is set
+ *                       by the websocket server (see ws_server/signal_delta.h)
+ *   uint32_t size       number of elements
+ *   char     name[name_size], padded with zeros to 8 bytes
+ *   data     size elements of the type, padded with zeros to 8 bytes
+ *
+ * JSON text: the usual {"signals":{...}} object with signals that are not
+ * in binary mode.
+ *
+ * Record data always starts on an 8 byte boundary, so the browser can wrap it
+ * in a typed array without copying.
+ */
+
+#define SIGNAL_FRAME_MAGIC	"RPSG"
+#define SIGNAL_FRAME_VERSION	1
+#define SIGNAL_FRAME_HEADER	16
+
+enum SignalFrameType
+{
+	SF_UNSUPPORTED = 0,
+	SF_FLOAT32,
+	SF_INT16,
+	SF_INT32,
+	SF_UINT8,
+	SF_FLOAT64
+};
+
+#define SF_RECORD_DELTA	0x01
+
+inline size_t SignalFrameTypeSize(uint8_t _type)
+{
+	switch(_type)
+	{
+		case SF_FLOAT32: return 4;
+		case SF_INT16: return 2;
+		case SF_INT32: return 4;
+		case SF_UINT8: return 1;
+		case SF_FLOAT64: return 8;
+		default: return 0;
+	}
+}
+
+template <typename T> struct SignalFrameTypeOf	{ static const uint8_t value = SF_UNSUPPORTED; };
+template <> struct SignalFrameTypeOf<float>	{ static const uint8_t value = SF_FLOAT32; };
+template <> struct SignalFrameTypeOf<int16_t>	{ static const uint8_t value = SF_INT16; };
+template <> struct SignalFrameTypeOf<int32_t>	{ static const uint8_t value = SF_INT32; };
+template <> struct SignalFrameTypeOf<uint8_t>	{ static const uint8_t value = SF_UINT8; };
+template <> struct SignalFrameTypeOf<double>	{ static const uint8_t value = SF_FLOAT64; };
+
+inline void SignalFramePad(std::string& _frame)
+{
+	_frame.append((8 - _frame.size() % 8) % 8, '\0');
+}
+
+inline void SignalFrameBegin(std::string& _frame)
+{
+	_frame.assign(SIGNAL_FRAME_HEADER, '\0');
+	memcpy(&_frame[0], SIGNAL_FRAME_MAGIC, 4);
+	uint16_t version = SIGNAL_FRAME_VERSION;
+	memcpy(&_frame[4], &version, sizeof(version));
+}
+
+inline void SignalFrameAppend(std::string& _frame, const std::string& _name, uint8_t _type, const void* _data, uint32_t _size, size_t _elem_size)
+{
+	uint16_t name_size = _name.size();
+	uint8_t flags = 0;
+	_frame.append((const char*)&name_size, sizeof(name_size));
+	_frame.append((const char*)&_type, sizeof(_type));
+	_frame.append((const char*)&flags, sizeof(flags));
+	_frame.append((const char*)&_size, sizeof(_size));
+	_frame.append(_name);
+	SignalFramePad(_frame);
+	_frame.append((const char*)_data, _size * _elem_size);
+	SignalFramePad(_frame);
+}
+
+inline void SignalFrameEnd(std::string& _frame, uint16_t _count, const std::string& _json)
+{
+	uint32_t json_size = _json.size();
+	memcpy(&_frame[6], &_count, sizeof(_count));
+	memcpy(&_frame[8], &json_size, sizeof(json_size));
+	_frame.append(_json);
+}
@@ -8,9 +8,12 @@
 
 #include <fstream>
 #include <iostream>
+#include <sstream>
 #include <streambuf>
 #include <string>
 #include <future>
+#include <algorithm>
+#include <cstring>
 
 #include <math.h>
 
@@ -21,12 +24,16 @@ using websocketpp::lib::bind;
 
 rp_websocket_server::rp_websocket_server()
     : m_params(NULL)
+    , m_push_pending(false)
+    , m_push_mode(false)
     , m_OnClosed(false)
 {
 }
 
 rp_websocket_server::rp_websocket_server(struct server_parameters* params)
     : m_params(params)
+    , m_push_pending(false)
+    , m_push_mode(false)
 {
     // set up access channels to only log interesting things
     m_endpoint.clear_access_channels(websocketpp::log::alevel::all);
@@ -48,8 +55,12 @@ rp_websocket_server::rp_websocket_server(struct server_parameters* params)
     m_endpoint.get_alog().write(websocketpp::log::alevel::app, "ws_server constructor");
 
     std::stringstream ss;
-    ss << "default params: signal_interval = "<< params->signal_interval <<", param_interval =" << params->param_interval;
+    ss << "default params: signal_interval = "<< params->signal_interval <<", param_interval =" << params->param_interval << ", keyframe_interval = " << params->keyframe_interval << ", max_queue_frames = " << params->max_queue_frames
+       << ", max_push_rate = " << params->max_push_rate << ", push_fallback_interval = " << params->push_fallback_interval;
     m_endpoint.get_alog().write(websocketpp::log::alevel::app,ss.str());
+
+    m_signal_delta.set_keyframe_interval(params->keyframe_interval);
+    m_metrics_time = std::chrono::steady_clock::now();
 }
 
 rp_websocket_server::~rp_websocket_server()
@@ -83,11 +94,16 @@ void rp_websocket_server::run(std::string docroot, uint16_t port) {
 	}
 }
 
-void rp_websocket_server::set_signal_timer() {
+void rp_websocket_server::set_signal_timer(int interval) {
 
 	if(m_signal_timer!=NULL)
 		m_signal_timer->cancel();
-	int interval = m_params->get_signals_interval_func != 0 ? m_params->get_signals_interval_func() : m_params->signal_interval;
+	if (interval < 0) {
+		interval = m_params->get_signals_interval_func != 0 ? m_params->get_signals_interval_func() : m_params->signal_interval;
+		// In push mode the timer only covers updates the application did not notify about
+		if (m_push_mode && m_params->push_fallback_interval > interval)
+			interval = m_params->push_fallback_interval;
+	}
 	// fprintf(stderr, "set_signal_timer interval %d\n", interval);
 	m_signal_timer = m_endpoint.set_timer(
 		interval,
@@ -118,12 +134,58 @@ void rp_websocket_server::set_param_timer() {
 void rp_websocket_server::on_signal_timer(websocketpp::lib::error_code const & ec) {
 
 	if (ec) {
+		// Rescheduled
+		if (ec == websocketpp::transport::error::make_error_code(websocketpp::transport::error::operation_aborted))
+			return;
 		m_endpoint.get_alog().write(websocketpp::log::alevel::app,
 				"Signal timer Error: "+ec.message());
 		return;
 	}
 
+	send_signals();
+	// set timer for next check
+	set_signal_timer();
+}
+
+void rp_websocket_server::notify_signals() {
+	// Notifications that come before the pending one is handled are merged
+	if (!m_push_pending.exchange(true)) {
+		m_endpoint.get_io_service().post(bind(&rp_websocket_server::on_signals_ready, this));
+	}
+}
+
+// Sends signals right away, unless the last send was less than
+// 1 / max_push_rate ago. Then the send is delayed until that time
+void rp_websocket_server::on_signals_ready() {
+	m_push_pending = false;
+	m_push_mode = true;
+
+	auto min_interval = std::chrono::milliseconds(m_params->max_push_rate > 0 ? 1000 / m_params->max_push_rate : 0);
+	auto elapsed = std::chrono::steady_clock::now() - m_signals_time;
+	if (elapsed >= min_interval) {
+		send_signals();
+		set_signal_timer();
+	} else {
+		auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(min_interval - elapsed).count();
+		set_signal_timer(wait > 0 ? wait : 1);
+	}
+}
+
+void rp_websocket_server::send_signals() {
+
+	m_signals_time = std::chrono::steady_clock::now();
 	con_list::iterator it;
+
+	// Applications send only the changed signals. A client that missed a frame
+	// or has just connected needs every signal, ask for all of them once
+	if (m_params->send_all_signals_func != 0) {
+		for (it = m_connections.begin(); it != m_connections.end(); ++it) {
+			if (it->second.resync) {
+				m_params->send_all_signals_func();
+				break;
+			}
+		}
+	}
 	const char* signals = m_params->get_signals_func();
 
 //	m_endpoint.get_alog().write(websocketpp::log::alevel::app, "on_signal_timer");
@@ -134,18 +196,43 @@ void rp_websocket_server::on_signal_timer(websocketpp::lib::error_code const & e
 		m_endpoint.get_alog().write(websocketpp::log::alevel::app, signals);
 	}
 
-	std::string js(signals);
-	static char buf[1000000];
-	size_t size;
-	m_params->gzip_func(js.c_str(), buf, &size);
-
-	if (size) {
+	// The binary frame already carries the JSON part. Clients that got the
+	// previous frame receive only the changed ranges. Each message is built
+	// once and shared by all connections
+	size_t frame_size = 0;
+	const char* frame = m_params->get_signals_binary_func != 0 ? m_params->get_signals_binary_func(&frame_size) : NULL;
+	if (frame && frame_size) {
+		uint64_t sequence = m_signal_delta.update(frame, frame_size);
+		server::message_ptr delta_msg;
+		server::message_ptr key_msg;
 		for (it = m_connections.begin(); it != m_connections.end(); ++it) {
-			m_endpoint.send(*it, buf, size, websocketpp::frame::opcode::binary);
+			server::message_ptr msg;
+			if (!it->second.resync && m_signal_delta.can_use_delta(it->second.last_frame)) {
+				if (!delta_msg)
+					delta_msg = make_message(m_signal_delta.delta().data(), m_signal_delta.delta().size());
+				msg = delta_msg;
+			} else {
+				if (!key_msg)
+					key_msg = make_message(m_signal_delta.keyframe().data(), m_signal_delta.keyframe().size());
+				msg = key_msg;
+			}
+			// A dropped frame breaks the delta chain, the client gets the next keyframe
+			if (send_message(it, msg, true)) {
+				it->second.last_frame = sequence;
+				it->second.resync = false;
+			} else {
+				it->second.resync = true;
+			}
+		}
+	} else {
+		server::message_ptr msg = make_gzip_message(signals);
+		if (msg) {
+			for (it = m_connections.begin(); it != m_connections.end(); ++it) {
+				it->second.resync = !send_message(it, msg, true);
+			}
 		}
 	}
-	// set timer for next check
-	set_signal_timer();
+	log_metrics(false);
 }
 
 void rp_websocket_server::on_param_timer(websocketpp::lib::error_code const & ec) {
@@ -166,20 +253,95 @@ void rp_websocket_server::on_param_timer(websocketpp::lib::error_code const & ec
 		m_endpoint.get_alog().write(websocketpp::log::alevel::app, params);
 	}
 
-	std::string js(params);
-	static char buf[1000000];
-	size_t size;
-	m_params->gzip_func(js.c_str(), buf, &size);
-
-	if (size) {
+	// Parameters carry only changed values, they are never dropped
+	server::message_ptr msg = make_gzip_message(params);
+	if (msg) {
 		for (it = m_connections.begin(); it != m_connections.end(); ++it) {
-			m_endpoint.send(*it, buf, size, websocketpp::frame::opcode::binary);
+			send_message(it, msg, false);
 		}
 	}
 	// set timer for next check
 	set_param_timer();
 }
 
+// Builds a ready to write binary message. websocketpp does not copy or
+// reframe prepared messages, so one message is queued to every connection.
+// Server frames are not masked, the header is the same for all clients
+rp_websocket_server::server::message_ptr rp_websocket_server::make_message(const char* data, size_t size) {
+	server::message_ptr msg = websocketpp::lib::make_shared<message_type>(
+		websocketpp::config::asio::con_msg_manager_type::ptr(), websocketpp::frame::opcode::binary, 0);
+	websocketpp::frame::basic_header header(websocketpp::frame::opcode::binary, size, true, false);
+	websocketpp::frame::extended_header ext_header(size);
+	msg->set_header(websocketpp::frame::prepare_header(header, ext_header));
+	msg->set_payload(data, size);
+	msg->set_prepared(true);
+	return msg;
+}
+
+rp_websocket_server::server::message_ptr rp_websocket_server::make_gzip_message(const char* json) {
+	size_t size = 0;
+	if (m_params->gzip_data_func != 0) {
+		const char* data = m_params->gzip_data_func(json, &size);
+		return size ? make_message(data, size) : server::message_ptr();
+	}
+
+	// Old applications write into a caller buffer without a size limit
+	size_t len = strlen(json);
+	if (m_gzip_buf.size() < len + len / 100 + 1024)
+		m_gzip_buf.resize(len + len / 100 + 1024);
+	m_params->gzip_func(json, &m_gzip_buf[0], &size);
+	return size ? make_message(m_gzip_buf.data(), size) : server::message_ptr();
+}
+
+// Returns false if the message was not queued. A droppable message is skipped
+// while the client still has more than max_queue_frames such messages unsent
+bool rp_websocket_server::send_message(con_list::iterator it, server::message_ptr msg, bool can_drop) {
+	websocketpp::lib::error_code ec;
+	server::connection_ptr con = m_endpoint.get_con_from_hdl(it->first, ec);
+	if (ec)
+		return false;
+
+	connection_state& state = it->second;
+	size_t size = msg->get_header().size() + msg->get_payload().size();
+	if (can_drop) {
+		state.queue_bytes = con->get_buffered_amount();
+		state.max_queue_bytes = std::max(state.max_queue_bytes, state.queue_bytes);
+		if (state.queue_bytes > size * m_params->max_queue_frames) {
+			state.dropped_frames++;
+			return false;
+		}
+	}
+
+	m_endpoint.send(it->first, msg, ec);
+	if (ec) {
+		m_endpoint.get_alog().write(websocketpp::log::alevel::app, "Send error: " + ec.message());
+		return false;
+	}
+	if (can_drop)
+		state.sent_frames++;
+	return true;
+}
+
+void rp_websocket_server::log_metrics(bool force) {
+	auto now = std::chrono::steady_clock::now();
+	if (!force && now - m_metrics_time < std::chrono::seconds(10))
+		return;
+	m_metrics_time = now;
+
+	for (con_list::iterator it = m_connections.begin(); it != m_connections.end(); ++it) {
+		websocketpp::lib::error_code ec;
+		server::connection_ptr con = m_endpoint.get_con_from_hdl(it->first, ec);
+		if (ec)
+			continue;
+		const connection_state& state = it->second;
+		std::stringstream ss;
+		ss << "client " << con->get_remote_endpoint()
+		   << ": queue " << state.queue_bytes << " bytes (max " << state.max_queue_bytes
+		   << "), sent frames " << state.sent_frames << ", dropped frames " << state.dropped_frames;
+		m_endpoint.get_alog().write(websocketpp::log::alevel::app, ss.str());
+	}
+}
+
 void rp_websocket_server::on_http(connection_hdl hdl) {
 
 	// Upgrade our connection handle to a full connection_ptr
@@ -231,12 +393,19 @@ void rp_websocket_server::on_http(connection_hdl hdl) {
 void rp_websocket_server::on_open(connection_hdl hdl)
 {
 	m_endpoint.get_alog().write(websocketpp::log::alevel::app, "ws server on connection");
-	m_connections.insert(hdl);
+	m_connections[hdl] = connection_state();
 }
 
 void rp_websocket_server::on_close(connection_hdl hdl) {
 	m_endpoint.get_alog().write(websocketpp::log::alevel::app, "ws server connection closed");
-	m_connections.erase(hdl);
+	con_list::iterator it = m_connections.find(hdl);
+	if (it != m_connections.end()) {
+		std::stringstream ss;
+		ss << "sent frames " << it->second.sent_frames << ", dropped frames " << it->second.dropped_frames
+		   << ", max queue " << it->second.max_queue_bytes << " bytes";
+		m_endpoint.get_alog().write(websocketpp::log::alevel::app, ss.str());
+		m_connections.erase(it);
+	}
 
 	if (!m_OnClosed) {
 		exit(-1);
@@ -293,6 +462,8 @@ void rp_websocket_server::stop()
 	m_OnClosed = true;
 
 	m_endpoint.get_alog().write(websocketpp::log::alevel::app, "stop ws_server");
+	if (m_params->set_signals_notify_func != 0)
+		m_params->set_signals_notify_func(NULL);
 
 	m_endpoint.stop_listening();
 	m_endpoint.stop();
@@ -301,7 +472,7 @@ void rp_websocket_server::stop()
 	con_list::iterator it;
 
 	for (it = m_connections.begin(); it != m_connections.end(); ++it) {
-		connection_hdl hdl = *it;
+		connection_hdl hdl = it->first;
 
 		try{
               		m_endpoint.close(hdl, websocketpp::close::status::normal, "shutdown");
@@ -3,11 +3,14 @@
 #include <websocketpp/server.hpp>
 #include <websocketpp/common/thread.hpp>
 //#include <websocketpp/extensions/permessage_deflate/enabled.hpp>
-#include <set>
+#include <map>
 #include <fstream>
+#include <chrono>
+#include <atomic>
 
 #include "libjson/_internal/Source/JSONNode.h"
 #include "ws_server.h"
+#include "signal_delta.h"
 
 //class config2{};
 
@@ -31,24 +34,51 @@ public:
     void join();
     void stop();
 
-    void set_signal_timer();
+    void set_signal_timer(int interval = -1);
     void set_param_timer();
 
+    // Thread safe, called by the application when new signal data is ready
+    void notify_signals();
+
     void on_signal_timer(websocketpp::lib::error_code const & ec);
     void on_param_timer(websocketpp::lib::error_code const & ec);
+    void on_signals_ready();
     void on_http(connection_hdl hdl);
     void on_open(connection_hdl hdl);
     void on_close(connection_hdl hdl);
     void on_message(connection_hdl hdl, server::message_ptr msg);
 
 private:
-    typedef std::set<connection_hdl,std::owner_less<connection_hdl>> con_list;
+    typedef websocketpp::config::asio::message_type message_type;
+
+    struct connection_state {
+        uint64_t last_frame = 0; // sequence of the last binary signal frame sent
+        bool resync = true;      // the client missed signals, the next frame must carry all of them
+        // metrics
+        uint64_t sent_frames = 0;
+        uint64_t dropped_frames = 0;
+        size_t   queue_bytes = 0;     // unsent bytes at the last signal tick
+        size_t   max_queue_bytes = 0;
+    };
+    typedef std::map<connection_hdl,connection_state,std::owner_less<connection_hdl>> con_list;
+
+    void send_signals();
+    server::message_ptr make_message(const char* data, size_t size);
+    server::message_ptr make_gzip_message(const char* json);
+    bool send_message(con_list::iterator it, server::message_ptr msg, bool can_drop);
+    void log_metrics(bool force);
 
     struct server_parameters* m_params;
     server m_endpoint;
     con_list m_connections;
     server::timer_ptr m_signal_timer;
     server::timer_ptr m_param_timer;
+    signal_delta m_signal_delta;
+    std::string m_gzip_buf; // for applications without ws_gzip_data
+    std::chrono::steady_clock::time_point m_metrics_time;
+    std::chrono::steady_clock::time_point m_signals_time; // last signals send
+    std::atomic<bool> m_push_pending;
+    bool m_push_mode; // the application notifies about new data
     websocketpp::lib::thread m_thread;
     std::string m_docroot;
 	std::ofstream m_out;
@@ -0,0 +1,173 @@
+#include "signal_delta.h"
+#include "rp_sdk/SignalFrame.h"
+
+#include <string.h>
+#include <vector>
+
+namespace {
+
+inline size_t padded(size_t size)
+{
+	return (size + 7) / 8 * 8;
+}
+
+template <typename T>
+inline void append(std::string& out, T value)
+{
+	out.append((const char*)&value, sizeof(value));
+}
+
+}
+
+signal_delta::signal_delta()
+	: m_keyframe_interval(50)
+	, m_since_keyframe(0)
+	, m_sequence(0)
+	, m_has_delta(false)
+	, m_keyframe()
+	, m_delta()
+	, m_reference()
+{
+}
+
+void signal_delta::set_keyframe_interval(int interval)
+{
+	m_keyframe_interval = interval;
+}
+
+uint64_t signal_delta::update(const char* frame, size_t size)
+{
+	m_keyframe.assign(frame, size);
+	m_sequence++;
+	m_has_delta = encode_delta();
+	return m_sequence;
+}
+
+bool signal_delta::can_use_delta(uint64_t last_sequence) const
+{
+	return m_has_delta && last_sequence != 0 && last_sequence + 1 == m_sequence;
+}
+
+// Parses the new frame, replaces the reference with its signals and, unless
+// a keyframe is due, writes the delta frame against the old reference
+bool signal_delta::encode_delta()
+{
+	bool build = m_keyframe_interval > 0 && ++m_since_keyframe < m_keyframe_interval;
+	if (!build)
+		m_since_keyframe = 0;
+
+	std::map<std::string, reference> old_reference;
+	old_reference.swap(m_reference);
+	m_delta.clear();
+
+	const char* frame = m_keyframe.data();
+	size_t size = m_keyframe.size();
+	if (size < SIGNAL_FRAME_HEADER || memcmp(frame, SIGNAL_FRAME_MAGIC, 4) != 0)
+		return false;
+
+	uint16_t count;
+	uint32_t json_size;
+	memcpy(&count, frame + 6, sizeof(count));
+	memcpy(&json_size, frame + 8, sizeof(json_size));
+
+	if (build)
+		SignalFrameBegin(m_delta);
+
+	size_t offset = SIGNAL_FRAME_HEADER;
+	for (uint16_t i = 0; i < count; i++) {
+		uint16_t name_size;
+		uint8_t type;
+		uint32_t elements;
+		if (offset + 8 > size)
+			return false;
+		memcpy(&name_size, frame + offset, sizeof(name_size));
+		type = frame[offset + 2];
+		memcpy(&elements, frame + offset + 4, sizeof(elements));
+		offset += 8;
+
+		size_t elem_size = SignalFrameTypeSize(type);
+		size_t data_size = (size_t)elements * elem_size;
+		if (elem_size == 0 || offset + padded(name_size) + data_size > size)
+			return false;
+
+		std::string name(frame + offset, name_size);
+		offset += padded(name_size);
+		const char* data = frame + offset;
+		offset += padded(data_size);
+
+		if (build) {
+			auto it = old_reference.find(name);
+			const reference* ref = NULL;
+			if (it != old_reference.end() && it->second.type == type && it->second.size == elements)
+				ref = &it->second;
+			encode_record(name, type, elements, data, elem_size, ref);
+		}
+
+		reference& ref = m_reference[name];
+		ref.type = type;
+		ref.size = elements;
+		ref.data.assign(data, data_size);
+	}
+
+	if (offset + json_size > size)
+		return false;
+
+	if (build)
+		SignalFrameEnd(m_delta, count, std::string(frame + offset, json_size));
+	return build;
+}
+
+void signal_delta::encode_record(const std::string& name, uint8_t type, uint32_t size,
+	const char* data, size_t elem_size, const reference* ref)
+{
+	if (ref == NULL) {
+		SignalFrameAppend(m_delta, name, type, data, size, elem_size);
+		return;
+	}
+
+	// Changed element ranges. Ranges closer than the cost of a range header
+	// are merged
+	const char* old = ref->data.data();
+	const uint32_t gap = 16 / elem_size + 1;
+	std::vector<std::pair<uint32_t, uint32_t>> ranges;
+	size_t delta_size = 8;
+	if (memcmp(old, data, size * elem_size) != 0) {
+		uint32_t i = 0;
+		while (i < size) {
+			if (memcmp(old + i * elem_size, data + i * elem_size, elem_size) == 0) {
+				i++;
+				continue;
+			}
+			uint32_t start = i;
+			uint32_t end = i + 1;
+			for (uint32_t j = end; j < size && j < end + gap; j++) {
+				if (memcmp(old + j * elem_size, data + j * elem_size, elem_size) != 0)
+					end = j + 1;
+			}
+			ranges.push_back(std::make_pair(start, end - start));
+			delta_size += 8 + padded((end - start) * elem_size);
+			i = end;
+		}
+	}
+
+	// Not worth it, send the whole array
+	if (delta_size * 4 > padded(size * elem_size) * 3) {
+		SignalFrameAppend(m_delta, name, type, data, size, elem_size);
+		return;
+	}
+
+	append<uint16_t>(m_delta, name.size());
+	append<uint8_t>(m_delta, type);
+	append<uint8_t>(m_delta, SF_RECORD_DELTA);
+	append<uint32_t>(m_delta, size);
+	m_delta.append(name);
+	SignalFramePad(m_delta);
+	append<uint32_t>(m_delta, ranges.size());
+	append<uint32_t>(m_delta, 0);
+	for (auto& range : ranges) {
+		append<uint32_t>(m_delta, range.first);
+		append<uint32_t>(m_delta, range.second);
+		m_delta.append(data + range.first * elem_size, range.second * elem_size);
+		SignalFramePad(m_delta);
+	}
+}
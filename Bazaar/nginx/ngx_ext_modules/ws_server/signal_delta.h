@@ -0,0 +1,61 @@
+#pragma once
+#include <string>
+#include <map>
+#include <stdint.h>
+
+/*
+ * Delta encoding of binary signal frames (see rp_sdk/SignalFrame.h).
+ *
+ * Every frame is kept as the reference for the next one. A delta frame has
+ * the same layout as the full frame, but records of signals that were in the
+ * previous frame with the same type and size carry only the changed element
+ * ranges (record flag SF_RECORD_DELTA):
+ *
+ *   uint32_t range_count
+ *   uint32_t reserved
+ *   range_count times:
+ *     uint32_t start
+ *     uint32_t count
+ *     data     count elements, padded with zeros to 8 bytes
+ *
+ * A delta frame can be applied only by a client that received the previous
+ * frame. Everyone else, and everyone every keyframe_interval frames, gets the
+ * full frame.
+ */
+class signal_delta {
+public:
+	signal_delta();
+
+	// 0 disables delta frames
+	void set_keyframe_interval(int interval);
+
+	// Takes a new full frame. Returns the sequence number of the frame
+	uint64_t update(const char* frame, size_t size);
+
+	// Sequence number of the last frame, 0 if there was none
+	uint64_t sequence() const { return m_sequence; }
+	// True if a client that received frame last_sequence can take the delta frame
+	bool can_use_delta(uint64_t last_sequence) const;
+
+	const std::string& keyframe() const { return m_keyframe; }
+	const std::string& delta() const { return m_delta; }
+
+private:
+	struct reference {
+		uint8_t type;
+		uint32_t size;
+		std::string data;
+	};
+
+	bool encode_delta();
+	void encode_record(const std::string& name, uint8_t type, uint32_t size,
+		const char* data, size_t elem_size, const reference* ref);
+
+	int m_keyframe_interval;
+	int m_since_keyframe;
+	uint64_t m_sequence;
+	bool m_has_delta;
+	std::string m_keyframe;
+	std::string m_delta;
+	std::map<std::string, reference> m_reference;
+};
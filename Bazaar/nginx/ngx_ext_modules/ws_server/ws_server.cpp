@@ -8,8 +8,19 @@
 #include <sstream>
 #include <iostream>
 #include <stdexcept>
+#include <mutex>
 
 rp_websocket_server * s = NULL;
+// Guards s against the application thread that calls signals_ready()
+static std::mutex s_mutex;
+static void (*s_set_signals_notify)(void (*)(void)) = NULL;
+
+static void signals_ready(void)
+{
+	std::lock_guard<std::mutex> lock(s_mutex);
+	if(s)
+		s->notify_signals();
+}
 
 void start_ws_server(const struct server_parameters * _params)
 {
@@ -29,6 +40,10 @@ void start_ws_server(const struct server_parameters * _params)
 		loaded_params->get_signals_func = _params->get_signals_func;
 		loaded_params->set_signals_func = _params->set_signals_func;
 		loaded_params->gzip_func = _params->gzip_func;
+		loaded_params->get_signals_binary_func = _params->get_signals_binary_func;
+		loaded_params->gzip_data_func = _params->gzip_data_func;
+		loaded_params->set_signals_notify_func = _params->set_signals_notify_func;
+		loaded_params->send_all_signals_func = _params->send_all_signals_func;
 	}
 	if(_params != 0 && _params->port != 0)
 		loaded_params->port = _params->port;
@@ -38,10 +53,18 @@ void start_ws_server(const struct server_parameters * _params)
 		loaded_params->param_interval = _params->param_interval;
 
 	int port=loaded_params->port;
-	s = rp_websocket_server::create(loaded_params);
+	rp_websocket_server *server = rp_websocket_server::create(loaded_params);
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+		s = server;
+	}
  	std::string docroot=".";
 	fprintf(stderr, "Running...\n");
-	s->start(docroot, port);
+	server->start(docroot, port);
+	if(loaded_params->set_signals_notify_func != 0) {
+		s_set_signals_notify = loaded_params->set_signals_notify_func;
+		s_set_signals_notify(signals_ready);
+	}
 	fprintf(stderr, "Running...[DONE]\n");
 	}catch(std::exception &ex){
 		fprintf(stderr, "Error: start_ws_server() %s\n",ex.what());
@@ -51,14 +74,24 @@ void start_ws_server(const struct server_parameters * _params)
 void stop_ws_server()
 {
 	fprintf(stderr, "stop_ws_server()\n");
-	if(s) {
+	if(s_set_signals_notify) {
+		s_set_signals_notify(NULL);
+		s_set_signals_notify = NULL;
+	}
+	rp_websocket_server *server = NULL;
+	{
+		// A running signals_ready() finishes before the server is released
+		std::lock_guard<std::mutex> lock(s_mutex);
+		server = s;
+		s = NULL;
+	}
+	if(server) {
 		try{
-	    	s->stop();
+	    	server->stop();
 		}catch(std::exception &ex){
 			fprintf(stderr, "Error: stop_ws_server() %s\n",ex.what());
 		}
-	    delete s;
-	    s = NULL;
+	    delete server;
 	}
 }
 
@@ -73,6 +106,10 @@ struct server_parameters * load_params()
         	/* Config does not exist */
 		params->signal_interval = 20;
 		params->param_interval = 20;
+		params->keyframe_interval = 50;
+		params->max_queue_frames = 2;
+		params->max_push_rate = 30;
+		params->push_fallback_interval = 500;
 		params->port = 9002;
         	return params;
 	}
@@ -86,5 +123,9 @@ struct server_parameters * load_params()
 	params->signal_interval = n.at("s_send_interval").as_int();
 	params->param_interval = n.at("p_send_interval").as_int();
 	params->port = n.at("port").as_int();
+	params->keyframe_interval = n.find("s_keyframe_interval") != n.end() ? n.at("s_keyframe_interval").as_int() : 50;
+	params->max_queue_frames = n.find("s_max_queue_frames") != n.end() ? n.at("s_max_queue_frames").as_int() : 2;
+	params->max_push_rate = n.find("s_max_push_rate") != n.end() ? n.at("s_max_push_rate").as_int() : 30;
+	params->push_fallback_interval = n.find("s_push_fallback_interval") != n.end() ? n.at("s_push_fallback_interval").as_int() : 500;
 	return params;
 }
@@ -12,6 +12,11 @@ typedef const char     *(*ws_get_signals_func)(void);
 typedef int		(*ws_set_params_func)(const char *_params);
 typedef int		(*ws_set_signals_func)(const char *_signals);
 typedef void	(*ws_gzip_func)(const char *_in, void* _out, size_t* _size);
+typedef const char     *(*ws_get_signals_binary_func)(size_t *_size);
+typedef const char     *(*ws_gzip_data_func)(const char *_in, size_t *_size);
+typedef void		(*ws_signals_notify_func)(void);
+typedef void		(*ws_set_signals_notify_func)(ws_signals_notify_func _func);
+typedef void		(*ws_send_all_signals_func)(void);
 
 // The following struct can be used to define specific parameters
 struct server_parameters {
@@ -24,8 +29,16 @@ struct server_parameters {
 	ws_set_params_func set_params_func;
 	ws_set_signals_func set_signals_func;
 	ws_gzip_func gzip_func;
+	ws_get_signals_binary_func get_signals_binary_func; // optional
+	ws_gzip_data_func gzip_data_func; // optional, gzip_func is used without it
+	ws_set_signals_notify_func set_signals_notify_func; // optional, signals are only polled without it
+	ws_send_all_signals_func send_all_signals_func; // optional, clients that missed a frame are not resynced without it
 	int signal_interval; // in ms
 	int param_interval; // in ms
+	int keyframe_interval; // full binary signal frame every N frames, 0 - no delta frames
+	int max_queue_frames; // signal frames are dropped for a client with more unsent data
+	int max_push_rate; // in Hz, limit for signal frames sent on application notifications, 0 - no limit
+	int push_fallback_interval; // in ms, signal polling interval after the application started to notify
 	int port;
 };
 
@@ -942,6 +942,11 @@ int rp_get_signals(float ***s, int *sig_num, int *sig_len)
     return 0;
 }
 
+void rp_set_signals_notify(void (*func)(void))
+{
+    rp_osc_set_signals_notify(func);
+}
+
 int rp_create_signals(float ***a_signals)
 {
     int i;
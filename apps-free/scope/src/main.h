@@ -150,6 +150,7 @@ int rp_app_exit(void);
 int rp_set_params(rp_app_params_t *p, int len);
 int rp_get_params(rp_app_params_t **p);
 int rp_get_signals(float ***s, int *sig_num, int *sig_len);
+void rp_set_signals_notify(void (*func)(void));
 
 /* Internal helper functions */
 int  rp_create_signals(float ***a_signals);
@@ -37,6 +37,7 @@ pthread_mutex_t       rp_osc_sig_mutex = PTHREAD_MUTEX_INITIALIZER;
 float               **rp_osc_signals;
 int                   rp_osc_signals_dirty = 0;
 int                   rp_osc_sig_last_idx = 0;
+void                (*rp_osc_signals_notify)(void) = NULL;
 float               **rp_tmp_signals; /* used for calculation, only from worker */
 
 /* Signals directly pointing at the FPGA mem space */
@@ -199,6 +200,8 @@ int rp_osc_get_signals(float ***signals, int *sig_idx)
 /*----------------------------------------------------------------------------------*/
 int rp_osc_set_signals(float **source, int index)
 {
+    void (*notify)(void);
+
     pthread_mutex_lock(&rp_osc_sig_mutex);
 
     memcpy(&rp_osc_signals[0][0], &source[0][0], sizeof(float)*SIGNAL_LENGTH);
@@ -207,12 +210,25 @@ int rp_osc_set_signals(float **source, int index)
     rp_osc_sig_last_idx = index;
 
     rp_osc_signals_dirty = 1;
+    notify = rp_osc_signals_notify;
     pthread_mutex_unlock(&rp_osc_sig_mutex);
 
+    if(notify)
+        notify();
+
     return 0;
 }
 
 
+/*----------------------------------------------------------------------------------*/
+void rp_osc_set_signals_notify(void (*func)(void))
+{
+    pthread_mutex_lock(&rp_osc_sig_mutex);
+    rp_osc_signals_notify = func;
+    pthread_mutex_unlock(&rp_osc_sig_mutex);
+}
+
+
 /*----------------------------------------------------------------------------------*/
 int rp_osc_set_meas_data(rp_osc_meas_res_t ch1_meas, rp_osc_meas_res_t ch2_meas)
 {
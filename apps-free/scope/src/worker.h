@@ -47,6 +47,8 @@ int rp_osc_get_signals(float ***signals, int *sig_idx);
  * and marks it dirty 
  */
 int rp_osc_set_signals(float **source, int index);
+/* Sets the function called after rp_osc_set_signals(), NULL removes it */
+void rp_osc_set_signals_notify(void (*func)(void));
 /* Fills the output measuremenet data with last measurements
  */
 int rp_osc_set_meas_data(rp_osc_meas_res_t ch1_meas, rp_osc_meas_res_t ch2_meas);
@@ -0,0 +1,91 @@
+/*
+ * Decoder of binary signal frames sent by the websocket server when
+ * the application puts some of its signals into binary mode.
+ * The frame layout is described in rp_sdk/SignalFrame.h
+ */
+
+(function(SIGNAL_FRAME, undefined) {
+
+    var HEADER_SIZE = 16;
+    var RECORD_DELTA = 0x01;
+    var TYPES = {
+        1: Float32Array,
+        2: Int16Array,
+        3: Int32Array,
+        4: Uint8Array,
+        5: Float64Array
+    };
+
+    var bytesToString = function(bytes) {
+        var text = '';
+        for (var i = 0; i < bytes.length; i += 32768) {
+            text += String.fromCharCode.apply(null, bytes.subarray(i, Math.min(i + 32768, bytes.length)));
+        }
+        return text;
+    }
+
+    // Checks for the "RPSG" magic. Gzipped JSON starts with 0x1f 0x8b
+    SIGNAL_FRAME.isFrame = function(bytes) {
+        return bytes.length >= HEADER_SIZE &&
+            bytes[0] == 0x52 && bytes[1] == 0x50 && bytes[2] == 0x53 && bytes[3] == 0x47;
+    }
+
+    // Last value of every signal, delta records are applied on top of it.
+    // The server sends a full frame first on every new connection
+    SIGNAL_FRAME.last = {};
+
+    // Returns the same object as JSON.parse of the gzipped message: { signals: {...} }
+    // Values of binary signals are typed arrays
+    SIGNAL_FRAME.decode = function(buffer) {
+        var view = new DataView(buffer);
+        var count = view.getUint16(6, true);
+        var json_size = view.getUint32(8, true);
+        var offset = HEADER_SIZE;
+        var signals = {};
+
+        for (var i = 0; i < count; i++) {
+            var name_size = view.getUint16(offset, true);
+            var type = TYPES[view.getUint8(offset + 2)];
+            var flags = view.getUint8(offset + 3);
+            var size = view.getUint32(offset + 4, true);
+            offset += 8;
+            var name = bytesToString(new Uint8Array(buffer, offset, name_size));
+            offset += Math.ceil(name_size / 8) * 8;
+            if (type === undefined)
+                throw new Error('Unknown signal type in frame');
+
+            var value;
+            if (flags & RECORD_DELTA) {
+                var last = SIGNAL_FRAME.last[name];
+                if (last === undefined || last.length != size)
+                    throw new Error('Delta record without a previous value: ' + name);
+                value = last.slice();
+                var ranges = view.getUint32(offset, true);
+                offset += 8;
+                for (var r = 0; r < ranges; r++) {
+                    var start = view.getUint32(offset, true);
+                    var len = view.getUint32(offset + 4, true);
+                    offset += 8;
+                    value.set(new type(buffer, offset, len), start);
+                    offset += Math.ceil(len * type.BYTES_PER_ELEMENT / 8) * 8;
+                }
+            } else {
+                value = new type(buffer, offset, size);
+                offset += Math.ceil(size * type.BYTES_PER_ELEMENT / 8) * 8;
+            }
+            SIGNAL_FRAME.last[name] = value;
+            signals[name] = {
+                size: size,
+                value: value
+            };
+        }
+
+        var receive = JSON.parse(bytesToString(new Uint8Array(buffer, offset, json_size)));
+        if (receive.signals === undefined)
+            receive.signals = {};
+        for (var k in signals)
+            receive.signals[k] = signals[k];
+        return receive;
+    }
+
+}(window.SIGNAL_FRAME = window.SIGNAL_FRAME || {}));
@@ -691,13 +691,19 @@
                 var data = new Uint8Array(ev.data);
                 OSC.compressed_data += data.length;
 
-                var inflate = new Zlib.Gunzip(data);
-                var decompressed = inflate.decompress();
-                var arr = new Uint16Array(decompressed)
-                var text = OSC.convertUnpacked(arr);
-                OSC.decompressed_data += text.length;
+                var receive;
+                if (SIGNAL_FRAME.isFrame(data)) {
+                    OSC.decompressed_data += data.length;
+                    receive = SIGNAL_FRAME.decode(ev.data);
+                } else {
+                    var inflate = new Zlib.Gunzip(data);
+                    var decompressed = inflate.decompress();
+                    var arr = new Uint16Array(decompressed)
+                    var text = OSC.convertUnpacked(arr);
+                    OSC.decompressed_data += text.length;
 
-                var receive = JSON.parse(text);
+                    receive = JSON.parse(text);
+                }
 
                 if (receive.parameters) {
                     if ((Object.keys(OSC.params.orig).length == 0) && (Object.keys(receive.parameters).length == 0)) {
@@ -740,7 +746,11 @@
                     var changed = false;
                     for (var k in receive.signals) {
                         changed = true;
-                        OSC.latest_signal[k] = JSON.parse(JSON.stringify(receive.signals[k]));
+                        // Typed arrays from a binary frame are not shared, no need for a deep copy
+                        if (ArrayBuffer.isView(receive.signals[k].value))
+                            OSC.latest_signal[k] = receive.signals[k];
+                        else
+                            OSC.latest_signal[k] = JSON.parse(JSON.stringify(receive.signals[k]));
                     }
                     if ('ch1' in receive.signals) {
                         var split = OSC.repackSignals(OSC.latest_signal);
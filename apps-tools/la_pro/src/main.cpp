@@ -227,6 +227,7 @@ int rp_app_init(void) {
 
 	CDataManager::GetInstance()->SetParamInterval(parameterPeriiod.Value());
 	CDataManager::GetInstance()->SetSignalInterval(signalPeriiod.Value());
+	ch1.SetBinaryMode(true);
 
 	return 0;
 }
@@ -464,17 +464,23 @@
                 try {
                     var data = new Uint8Array(ev.data);
                     OSC.compressed_data += data.length;
-                    var inflate = pako.inflate(data);
-                    // var text = String.fromCharCode.apply(null, new Uint8Array(inflate));
-                    var bytes = new Uint8Array(inflate);
-                    var text = '';
-                    for(var i = 0; i < Math.ceil(bytes.length / 32768.0); i++) {
-                      text += String.fromCharCode.apply(null, bytes.slice(i * 32768, Math.min((i+1) * 32768, bytes.length)))
-                    }
+                    var receive;
+                    if (SIGNAL_FRAME.isFrame(data)) {
+                        OSC.decompressed_data += data.length;
+                        receive = SIGNAL_FRAME.decode(ev.data);
+                    } else {
+                        var inflate = pako.inflate(data);
+                        // var text = String.fromCharCode.apply(null, new Uint8Array(inflate));
+                        var bytes = new Uint8Array(inflate);
+                        var text = '';
+                        for(var i = 0; i < Math.ceil(bytes.length / 32768.0); i++) {
+                          text += String.fromCharCode.apply(null, bytes.slice(i * 32768, Math.min((i+1) * 32768, bytes.length)))
+                        }
 
 
-                    OSC.decompressed_data += text.length;
-                    var receive = JSON.parse(text);
+                        OSC.decompressed_data += text.length;
+                        receive = JSON.parse(text);
+                    }
 
                     if (receive.parameters) {
                         OSC.parameterStack.push(receive.parameters);
@@ -56,10 +56,16 @@ uint16_t g_save_counter = 0; // By default, a save check every 40 ticks. One tic
 const std::vector<std::string> g_savedParams = {"OSC_CH1_IN_GAIN","OSC_CH2_IN_GAIN","OSC_CH3_IN_GAIN","OSC_CH4_IN_GAIN",
                                                 "OSC_CH1_IN_AC_DC","OSC_CH2_IN_AC_DC","OSC_CH3_IN_AC_DC","OSC_CH4_IN_AC_DC"};
 
+// Called from the oscilloscope thread, the web server sends new signals right away
+void onOscViewReady(){
+    CDataManager::GetInstance()->NotifySignalsReady();
+}
+
 void updateParametersByConfig(){
     configGet(getHomeDirectory() + "/.config/redpitaya/apps/scopegenpro/config.json");
 
     initOscAfterLoad();
+    initMathAfterLoad();
 
     if (rp_HPIsFastDAC_PresentOrDefault()){
         initGenAfterLoad();
@@ -116,6 +122,7 @@ int rp_app_init(void) {
     // Need run after init parameters
     updateParametersByConfig();
     createDirTree("/tmp/scopegenpro");
+    rpApp_OscSetViewReadyCallback(onOscViewReady);
     rpApp_OscRunMainThread();
     return 0;
 }
@@ -125,6 +132,7 @@ int rp_app_exit(void) {
 
     deleteSweepController();
 
+    rpApp_OscSetViewReadyCallback(NULL);
     rpApp_Release();
 
     return 0;
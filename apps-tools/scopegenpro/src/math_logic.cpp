@@ -40,7 +40,7 @@ CIntParameter mathSource[2]             = INIT2("OSC_MATH_SRC","", CBaseParamete
 
 
 auto initMathAfterLoad() -> void{
-
+    math.SetBinaryMode(true);
 }
 
 auto updateMathParametersToWEB(bool is_auto_scale) -> void{
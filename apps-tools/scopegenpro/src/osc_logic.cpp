@@ -92,6 +92,10 @@ CBooleanParameter   request_normalize("REQUEST_NORMALIZE", CBaseParameter::RW,tr
 CBooleanParameter   request_view("REQUEST_VIEW", CBaseParameter::RW,true,0,CONFIG_VAR);
 
 auto initOscAfterLoad() -> void{
+    for(auto ch = 0u; ch < MAX_ADC_CHANNELS ; ch++){
+        outCh[ch].SetBinaryMode(true);
+    }
+
 if (rp_HPGetFastADCIsAC_DCOrDefault()){
         for(auto ch = 0u; ch < g_adc_channels ; ch++){
             rp_AcqSetAC_DC((rp_channel_t)ch,inAC_DC[ch].Value() == 0 ? RP_AC:RP_DC);
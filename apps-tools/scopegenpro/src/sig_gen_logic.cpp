@@ -357,6 +357,10 @@ auto setSweepParameters(bool force) -> void {
 }
 
 auto initGenAfterLoad() -> void{
+    for(int i = 0; i < MAX_DAC_CHANNELS; i++){
+        outSignal[i].SetBinaryMode(true);
+    }
+
     if (!rp_HPIsFastDAC_PresentOrDefault())
         return;
 
@@ -411,17 +411,23 @@
                     try {
                         var data = new Uint8Array(ev.data);
                         SPEC.compressed_data += data.length;
-                        var inflate = pako.inflate(data);
-                        // var text = SPEC.handleCodePoints(inflate);
+                        var receive;
+                        if (SIGNAL_FRAME.isFrame(data)) {
+                            SPEC.decompressed_data += data.length;
+                            receive = SIGNAL_FRAME.decode(ev.data);
+                        } else {
+                            var inflate = pako.inflate(data);
+                            // var text = SPEC.handleCodePoints(inflate);
 
-                        var bytes = new Uint8Array(inflate);
-                        var text = '';
-                        for(var i = 0; i < Math.ceil(bytes.length / 32768.0); i++) {
-                          text += String.fromCharCode.apply(null, bytes.slice(i * 32768, Math.min((i+1) * 32768, bytes.length)))
-                        }
+                            var bytes = new Uint8Array(inflate);
+                            var text = '';
+                            for(var i = 0; i < Math.ceil(bytes.length / 32768.0); i++) {
+                              text += String.fromCharCode.apply(null, bytes.slice(i * 32768, Math.min((i+1) * 32768, bytes.length)))
+                            }
 
-                        SPEC.decompressed_data += text.length;
-                        var receive = JSON.parse(text);
+                            SPEC.decompressed_data += text.length;
+                            receive = JSON.parse(text);
+                        }
 
                         if (receive.parameters) {
                             //console.log(receive.parameters);
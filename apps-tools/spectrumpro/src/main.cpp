@@ -968,6 +968,17 @@ extern "C" int rp_app_init(void)
     for(auto ch = 0u; ch < MAX_ADC_CHANNELS + 1; ch++)
         data[ch] = new float[CH_SIGNAL_DATA];
 
+    s_xaxis.SetBinaryMode(true);
+    s_xaxis_full.SetBinaryMode(true);
+    for(auto ch = 0u; ch < MAX_ADC_CHANNELS; ch++){
+        s_view[ch].SetBinaryMode(true);
+        s_view_min[ch].SetBinaryMode(true);
+        s_view_max[ch].SetBinaryMode(true);
+        s_full[ch].SetBinaryMode(true);
+        s_min_full[ch].SetBinaryMode(true);
+        s_max_full[ch].SetBinaryMode(true);
+    }
+
     rp_Init();
     rp_Reset();
 
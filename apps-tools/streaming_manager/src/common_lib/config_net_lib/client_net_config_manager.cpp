@@ -61,6 +61,8 @@ auto ClientNetConfigManager::removeHadlers() -> void{
     startADCDoneNofiy.disconnect_all();
     startDACDoneNofiy.disconnect_all();
 
+    headerV2AcceptedNofiy.disconnect_all();
+
     errorNofiy.disconnect_all();
 }
 
@@ -172,13 +174,19 @@ auto ClientNetConfigManager::receiveCommand(uint32_t command,std::weak_ptr<Clien
     if (c == CNetConfigManager::ECommands::MASTER_CONNETED){
         g_client_mutex.lock();
         sender->m_mode = broadcast_lib::AB_SERVER_MASTER;
+        sender->m_headerVersion = net_lib::HV_V1;
         g_client_mutex.unlock();
+        // Ask for the compact header before any other command, the streaming server applies it on start
+        sender->m_manager->sendData(CNetConfigManager::ECommands::REQUEST_HEADER_V2);
         serverConnectedNofiy(sender->m_manager->getHost());
     }
     if (c == CNetConfigManager::ECommands::SLAVE_CONNECTED){
         g_client_mutex.lock();
         sender->m_mode = broadcast_lib::AB_SERVER_SLAVE;
+        sender->m_headerVersion = net_lib::HV_V1;
         g_client_mutex.unlock();
+        // Ask for the compact header before any other command, the streaming server applies it on start
+        sender->m_manager->sendData(CNetConfigManager::ECommands::REQUEST_HEADER_V2);
         serverConnectedNofiy(sender->m_manager->getHost());
     }
 
@@ -318,6 +326,13 @@ auto ClientNetConfigManager::receiveCommand(uint32_t command,std::weak_ptr<Clien
     if (c == CNetConfigManager::ECommands::CONFIG_FILE_MISSED){
         configFileMissedNotify(sender->m_manager->getHost());
     }
+
+    if (c == CNetConfigManager::ECommands::HEADER_V2_ACCEPTED){
+        g_client_mutex.lock();
+        sender->m_headerVersion = net_lib::HV_V2;
+        g_client_mutex.unlock();
+        headerV2AcceptedNofiy(sender->m_manager->getHost());
+    }
 }
 
 auto ClientNetConfigManager::isServersConnected() -> bool{
@@ -639,6 +654,16 @@ auto ClientNetConfigManager::getModeByHost(const std::string &host) -> broadcast
     return broadcast_lib::AB_NONE;
 }
 
+auto ClientNetConfigManager::getHeaderVersionByHost(const std::string &host) -> net_lib::EHeaderVersion{
+    const std::lock_guard<std::mutex> lock(g_client_mutex);
+    auto it = std::find_if(std::begin(m_clients),std::end(m_clients),[&host](const std::shared_ptr<Clients> c){
+        return c->m_manager->getHost()  == host;
+    });
+    if (it != std::end(m_clients)){
+        return it->operator->()->m_headerVersion;
+    }
+    return net_lib::HV_V1;
+}
 
 auto ClientNetConfigManager::sendLoopbackStart(const std::string &host) -> bool{
     auto it = std::find_if(std::begin(m_clients),std::end(m_clients),[&host](const std::shared_ptr<Clients> c){
@@ -54,6 +54,7 @@ public:
     auto requestConfig(const std::string &host) -> bool;
     auto requestTestConfig(const std::string &host) -> bool;
     auto getModeByHost(const std::string &host) -> broadcast_lib::EMode;
+    auto getHeaderVersionByHost(const std::string &host) -> net_lib::EHeaderVersion;
     auto getLocalSettingsOfHost(const std::string &host) -> CStreamSettings*;
     auto getLocalTestSettingsOfHost(const std::string &host) -> CStreamSettings*;
 
@@ -103,6 +104,7 @@ public:
     sigslot::signal<std::string&> startDACDoneNofiy;
 
     sigslot::signal<std::string&> configFileMissedNotify;
+    sigslot::signal<std::string&> headerV2AcceptedNofiy;
 
 
     sigslot::signal<ClientNetConfigManager::Errors,std::string,error_code> errorNofiy;
@@ -119,6 +121,7 @@ private:
         CStreamSettings m_testSettings;
         std::shared_ptr<CNetConfigManager> m_manager;
         broadcast_lib::EMode m_mode;
+        net_lib::EHeaderVersion m_headerVersion = net_lib::HV_V1;
     };
 
     std::shared_ptr<broadcast_lib::CAsioBroadcastSocket> m_pBroadcast;
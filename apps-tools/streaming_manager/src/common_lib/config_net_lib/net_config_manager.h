@@ -76,7 +76,11 @@ public:
         GET_SERVER_MODE                     =   51,
         GET_SERVER_TEST_MODE                =   52,
 
-        CONFIG_FILE_MISSED                  =   53
+        CONFIG_FILE_MISSED                  =   53,
+
+        // Compact streaming header. Old servers ignore the request, so v1 stays by default.
+        REQUEST_HEADER_V2                   =   54,
+        HEADER_V2_ACCEPTED                  =   55
     };
 
     using Ptr = std::shared_ptr<CNetConfigManager>;
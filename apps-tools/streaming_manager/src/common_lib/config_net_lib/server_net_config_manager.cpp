@@ -8,7 +8,8 @@ ServerNetConfigManager::ServerNetConfigManager(std::string defualt_file_settings
     m_pNetConfManager(nullptr),
     m_currentState(States::NORMAL),
     m_file_settings(defualt_file_settings_path),
-    m_mode(mode)
+    m_mode(mode),
+    m_headerVersion(net_lib::HV_V1)
 {
     m_pNetConfManager = std::make_shared<CNetConfigManager>();
     m_pNetConfManager->receivedCommandNotify.connect(&ServerNetConfigManager::receiveCommand,this);
@@ -54,6 +55,7 @@ auto ServerNetConfigManager::isConnected() -> bool{
 auto ServerNetConfigManager::connected(std::string) -> void {
 //    aprintf(stderr,"[DEBUG:connected] %s\n",host.c_str());
     m_currentState = States::NORMAL;
+    m_headerVersion = net_lib::HV_V1;
     clientConnectedNofiy();
     if (m_mode == broadcast_lib::AB_SERVER_MASTER)
         m_pNetConfManager->sendData(CNetConfigManager::ECommands::MASTER_CONNETED);
@@ -63,6 +65,7 @@ auto ServerNetConfigManager::connected(std::string) -> void {
 
 auto ServerNetConfigManager::disconnected(std::string) -> void{
 //    aprintf(stderr,"[DEBUG:disconnected] %s\n",host.c_str());
+    m_headerVersion = net_lib::HV_V1;
     clientDisconnectedNofiy();
 }
 
@@ -211,6 +214,15 @@ auto ServerNetConfigManager::receiveCommand(uint32_t command) -> void{
     if (c== CNetConfigManager::ECommands::GET_SERVER_TEST_MODE){
         getServerModeTestNofiy();
     }
+
+    if (c== CNetConfigManager::ECommands::REQUEST_HEADER_V2){
+        m_headerVersion = net_lib::HV_V2;
+        m_pNetConfManager->sendData(CNetConfigManager::ECommands::HEADER_V2_ACCEPTED);
+    }
+}
+
+auto ServerNetConfigManager::getHeaderVersion() -> net_lib::EHeaderVersion{
+    return m_headerVersion;
 }
 
 auto ServerNetConfigManager::receiveValueStr(std::string key,std::string value) -> void {
@@ -1,6 +1,7 @@
 #ifndef CONFIG_NET_LIB_SNCM_H
 #define CONFIG_NET_LIB_SNCM_H
 
+#include <atomic>
 #include "settings_lib/stream_settings.h"
 #include "broadcast_lib/asio_broadcast_socket.h"
 #include "net_config_manager.h"
@@ -58,6 +59,9 @@ public:
     auto sendServerStoppedLoopBackMode() -> bool;
     auto sendStreamServerBusy() -> bool;
 
+    // Streaming header version requested by the connected client
+    auto getHeaderVersion() -> net_lib::EHeaderVersion;
+
     auto getSettingsRef() -> CStreamSettings&;
     auto getSettings() -> const CStreamSettings;
     auto getTempSettings() -> const CStreamSettings;
@@ -111,6 +115,7 @@ private:
 //    EventList<> m_callbacks;
     std::string m_file_settings;
     broadcast_lib::EMode m_mode;
+    std::atomic<net_lib::EHeaderVersion> m_headerVersion;
     CStreamSettings m_settings;
     CStreamSettings m_testSettings;
 };
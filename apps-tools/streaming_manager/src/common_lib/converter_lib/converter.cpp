@@ -5,6 +5,15 @@
 #include <time.h>
 #include <functional>
 #include <cstdlib>
+#include <charconv>
+#include <thread>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <vector>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 #include "converter.h"
 #include "data_lib/neon_asm.h"
@@ -23,6 +32,7 @@ auto CConverter::create() -> CConverter::Ptr{
 CConverter::CConverter()
 {
     m_stopWriteCSV = false;
+    m_threads = MAX(std::thread::hardware_concurrency(),1u);
 }
 
 
@@ -36,6 +46,14 @@ auto CConverter::stopWriteToCSV() -> void {
     m_stopWriteCSV = true;
 }
 
+auto CConverter::setThreads(uint32_t threads) -> void{
+    m_threads = threads;
+}
+
+auto CConverter::getThreads() -> uint32_t{
+    return m_threads;
+}
+
 bool CConverter::convertToCSV(std::string _file_name, std::string _prefix){
     return convertToCSV(_file_name,-2,-2,_prefix);
 }
@@ -53,80 +71,371 @@ bool CConverter::convertToCSV(std::string _file_name,int32_t start_seg, int32_t
         std::string csv_file = _file_name.substr(0, _file_name.size()-3) + "csv";
 
         aprintf(stdout,"%s %s\n",_prefix.c_str(),csv_file.c_str());
-        std::fstream fs;
-        std::fstream fs_out;
-        fs.open(_file_name, std::ios::binary | std::ofstream::in | std::ofstream::out);
-        fs_out.open(csv_file, std::ofstream::in |  std::ofstream::trunc | std::ofstream::out);
-        if (fs.fail() || fs_out.fail()) {
-            aprintf(stderr,"Error open files\n");
-            ret = false;
+        if (m_threads){
+            ret = convertPipelined(_file_name,csv_file,start_seg,end_seg,_prefix);
         }else{
-            fs.seekg(0, std::ios::end);
-            int64_t Length = fs.tellg();
-            int64_t position = 0;
-            int32_t curSegment = 0;
-            uint64_t samplePos = 0;
-            int     channels = 0;
-            start_seg = MAX(start_seg,1);
-            while(position >= 0){
-                auto freeSize = getFreeSpaceDisk(csv_file);
-                if (freeSize <= USING_FREE_SPACE){
-                    aprintf(stdout,"%s Disk is full\n",_prefix.c_str());
-                    ret = false;
-                    break;
+            ret = convertSequential(_file_name,csv_file,start_seg,end_seg,_prefix);
+        }
+        aprintf(stdout, "\n%s Ended converting\n",_prefix.c_str());
+    }catch (std::exception& e)
+	{
+        aprintf(stderr,"%s Error: convertToCSV() : %s\n",_prefix.c_str(),e.what());
+        ret = false;
+	}
+    return ret;
+}
+
+auto CConverter::convertSequential(std::string _file_name,std::string csv_file,int32_t start_seg, int32_t end_seg,std::string _prefix) -> bool{
+    bool ret = true;
+    std::fstream fs;
+    std::fstream fs_out;
+    fs.open(_file_name, std::ios::binary | std::ofstream::in | std::ofstream::out);
+    fs_out.open(csv_file, std::ofstream::in |  std::ofstream::trunc | std::ofstream::out);
+    if (fs.fail() || fs_out.fail()) {
+        aprintf(stderr,"Error open files\n");
+        ret = false;
+    }else{
+        fs.seekg(0, std::ios::end);
+        int64_t Length = fs.tellg();
+        int64_t position = 0;
+        int32_t curSegment = 0;
+        uint64_t samplePos = 0;
+        int     channels = 0;
+        start_seg = MAX(start_seg,1);
+        while(position >= 0){
+            auto freeSize = getFreeSpaceDisk(csv_file);
+            if (freeSize <= USING_FREE_SPACE){
+                aprintf(stdout,"%s Disk is full\n",_prefix.c_str());
+                ret = false;
+                break;
+            }
+            if (m_stopWriteCSV){
+                aprintf(stdout,"%s Abort writing to CSV file\n",_prefix.c_str());
+                ret = false;
+                break;
+            }
+            curSegment++;
+            bool notSkip = (start_seg <= curSegment) && ((end_seg != -2 && end_seg >= curSegment) || end_seg == -2);
+            auto csv_seg = readCSV(&fs,&position, &channels,&samplePos, !notSkip);
+            if (end_seg == -2){
+                if (position >=0) {
+                    aprintf(stdout, "\r%s PROGRESS: %d %",_prefix.c_str(),(position * 100) / Length);
+                }else{
+                    if (position == -2){
+                        aprintf(stdout, "\r%s PROGRESS: 100 %",_prefix.c_str());
+                    }
                 }
-                if (m_stopWriteCSV){
-                    aprintf(stdout,"%s Abort writing to CSV file\n",_prefix.c_str());
-                    ret = false;
-                    break;
+            }else{
+                if (curSegment - start_seg >= 0 && (end_seg-1) > start_seg) {
+                    aprintf(stdout, "\r%s PROGRESS: %d %",_prefix.c_str(),((curSegment - start_seg - 1) * 100) / (end_seg - start_seg));
                 }
-                curSegment++;
-                bool notSkip = (start_seg <= curSegment) && ((end_seg != -2 && end_seg >= curSegment) || end_seg == -2);
-                auto csv_seg = readCSV(&fs,&position, &channels,&samplePos, !notSkip);
-                if (end_seg == -2){
-                    if (position >=0) {
-                        aprintf(stdout, "\r%s PROGRESS: %d %",_prefix.c_str(),(position * 100) / Length);
-                    }else{
-                        if (position == -2){
-                            aprintf(stdout, "\r%s PROGRESS: 100 %",_prefix.c_str());
-                        }
+            }
+
+            if (notSkip && csv_seg){
+                csv_seg->seekg(0, csv_seg->beg);
+                fs_out << csv_seg->rdbuf();
+                fs_out.flush();
+                fs_out.sync();
+            }
+            delete csv_seg;
+
+            if (end_seg != -2 && end_seg < curSegment){
+                break;
+            }
+
+            if (fs.fail() || fs_out.fail()) {
+                aprintf(stdout, "\n%s Error write to CSV file\n",_prefix.c_str());
+                if (fs.fail())  aprintf(stdout, "\n%s FS is fail\n",_prefix.c_str());
+                if (fs_out.fail())  aprintf(stdout, "\n%s FS out is fail\n",_prefix.c_str());
+
+                ret = false;
+                break;
+            }
+
+        }
+    }
+    return ret;
+}
+
+namespace {
+
+struct SSegmentJob{
+    uint64_t index = 0;
+    bool     notSkip = false;
+    CBinInfo::BinHeader header;
+    std::vector<char> data;
+    uint64_t samplePos = 0;
+    int      progress = -1;
+    std::string text;
+};
+
+using SSegmentJobPtr = std::shared_ptr<SSegmentJob>;
+
+// Same text as "stream << value" in readCSV: integers as is, float as %g
+template<typename T>
+auto putNumber(char *p,char *end,T value) -> char*{
+    return std::to_chars(p,end,value).ptr;
+}
+
+template<>
+auto putNumber(char *p,char *end,float value) -> char*{
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    return std::to_chars(p,end,value,std::chars_format::general,6).ptr;
+#else
+    return p + snprintf(p,end - p,"%g",value);
+#endif
+}
+
+// Formats one segment exactly like readCSV does
+auto formatSegment(const CBinInfo::BinHeader &header,const char *data,uint64_t samplePos,std::string &out) -> void{
+    bool hasData = false;
+    for(int ch = 0; ch < 4; ch++){
+        hasData |= header.sizeCh[ch] || header.lostCount[ch];
+    }
+    if (!hasData) return;
+
+    const char *buffer[4] = {nullptr,nullptr,nullptr,nullptr};
+    size_t offset = 0;
+    uint64_t max_size = 0;
+    for(int ch = 0; ch < 4; ch++){
+        if (header.sizeCh[ch]){
+            buffer[ch] = data + offset;
+            offset += header.sizeCh[ch];
+        }
+        max_size = MAX(max_size,header.sampleCh[ch] + header.lostCount[ch]);
+    }
+
+    out.reserve(max_size * 48);
+    char line[160];
+    for(uint64_t i = 0; i < max_size; i++){
+        char *p = line;
+        char *end = line + sizeof(line);
+        p = putNumber(p,end,++samplePos);
+        *p++ = ',';
+        bool needPrintComma = false;
+        for(int ch = 0; ch < 4; ch++){
+            auto bytes = header.dataFormatSize[ch];
+            if (i < header.sampleCh[ch]){
+                if (needPrintComma) *p++ = ',';
+                needPrintComma = true;
+                if (buffer[ch] && (i + 1) * bytes <= header.sizeCh[ch]){
+                    auto b = buffer[ch] + i * bytes;
+                    if (bytes == 1) {
+                        p = putNumber(p,end,(int)*(const int8_t*)b);
                     }
-                }else{
-                    if (curSegment - start_seg >= 0 && (end_seg-1) > start_seg) {
-                        aprintf(stdout, "\r%s PROGRESS: %d %",_prefix.c_str(),((curSegment - start_seg - 1) * 100) / (end_seg - start_seg));
+                    if (bytes == 2) {
+                        int16_t v;
+                        memcpy(&v,b,sizeof(v));
+                        p = putNumber(p,end,v);
+                    }
+                    if (bytes == 4) {
+                        float v;
+                        memcpy(&v,b,sizeof(v));
+                        p = putNumber(p,end,v);
                     }
                 }
-                
-                if (notSkip && csv_seg){
-                    csv_seg->seekg(0, csv_seg->beg);  
-                    fs_out << csv_seg->rdbuf();
-                    fs_out.flush();
-                    fs_out.sync();
+            }else{
+                if (header.sampleCh[ch] > 0 || header.lostCount[ch] > 0){
+                    if (needPrintComma) *p++ = ',';
+                    needPrintComma = true;
+                    *p++ = '-';
                 }
-                delete csv_seg;
-                
-                if (end_seg != -2 && end_seg < curSegment){
-                    break;
+            }
+        }
+        *p++ = '\n';
+        out.append(line,p - line);
+    }
+}
+
+}
+
+auto CConverter::convertPipelined(std::string _file_name,std::string csv_file,int32_t start_seg, int32_t end_seg,std::string _prefix) -> bool{
+    // Sync and check the free space once per this many bytes instead of per segment
+    constexpr uint64_t SYNC_SIZE = 64 * 1024 * 1024;
+
+    std::ifstream fs(_file_name, std::ios::binary);
+    FILE *fs_out = fopen(csv_file.c_str(),"w");
+    if (fs.fail() || !fs_out) {
+        aprintf(stderr,"Error open files\n");
+        if (fs_out) fclose(fs_out);
+        return false;
+    }
+    std::vector<char> outBuffer(1024 * 1024);
+    setvbuf(fs_out,outBuffer.data(),_IOFBF,outBuffer.size());
+
+    fs.seekg(0, std::ios::end);
+    int64_t Length = fs.tellg();
+    start_seg = MAX(start_seg,1);
+
+    uint32_t threads = m_threads;
+    size_t maxInFlight = threads * 2 + 2;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<SSegmentJobPtr> toFormat;
+    std::map<uint64_t,SSegmentJobPtr> formatted;
+    uint64_t produced = 0;
+    uint64_t written = 0;
+    bool readerDone = false;
+    bool readFail = false;
+    bool abort = false;
+
+    auto reader = std::thread([&](){
+        int64_t position = 0;
+        int32_t curSegment = 0;
+        uint64_t samplePos = 0;
+        while(position >= 0){
+            curSegment++;
+            if (end_seg != -2 && end_seg < curSegment){
+                break;
+            }
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock,[&](){ return abort || produced - written < maxInFlight; });
+                if (abort) break;
+            }
+            auto job = std::make_shared<SSegmentJob>();
+            job->notSkip = start_seg <= curSegment;
+            fs.seekg(position, std::ios::beg);
+            fs.read((char*)&job->header, sizeof(CBinInfo::BinHeader));
+            auto segLength = job->header.sigmentLength;
+            uint32_t endSeg[] = { 0, 0 ,0};
+            if (job->notSkip){
+                job->data.resize(segLength + 12);
+                fs.read(job->data.data(), job->data.size());
+                memcpy(endSeg, job->data.data() + segLength, 12);
+            }else{
+                fs.seekg(position + sizeof(CBinInfo::BinHeader) + segLength, std::ios::beg);
+                fs.read((char*)endSeg, 12);
+            }
+            if (fs.fail()){
+                readFail = true;
+                break;
+            }
+            if (!(endSeg[0] == 0xFFFFFFFF && endSeg[1] == 0xFFFFFFFF && endSeg[2] == 0xFFFFFFFF)){
+                break;
+            }
+            if (job->notSkip){
+                job->samplePos = samplePos;
+                bool hasData = false;
+                uint64_t max_size = 0;
+                for(int ch = 0; ch < 4; ch++){
+                    hasData |= job->header.sizeCh[ch] || job->header.lostCount[ch];
+                    max_size = MAX(max_size,job->header.sampleCh[ch] + job->header.lostCount[ch]);
                 }
+                if (hasData) samplePos += max_size;
+            }
+            position = position + sizeof(CBinInfo::BinHeader) + segLength + 12; // 12 - End segment len
+            if (position >= Length) {
+                position = -2;
+            }
+            if (end_seg == -2){
+                job->progress = position >= 0 ? (position * 100) / Length : 100;
+            }else if (curSegment - start_seg >= 0 && (end_seg-1) > start_seg) {
+                job->progress = ((curSegment - start_seg - 1) * 100) / (end_seg - start_seg);
+            }
+            std::lock_guard<std::mutex> lock(mtx);
+            job->index = produced++;
+            toFormat.push_back(job);
+            cv.notify_all();
+        }
+        std::lock_guard<std::mutex> lock(mtx);
+        readerDone = true;
+        cv.notify_all();
+    });
 
-                if (fs.fail() || fs_out.fail()) {
-                    aprintf(stdout, "\n%s Error write to CSV file\n",_prefix.c_str());
-                    if (fs.fail())  aprintf(stdout, "\n%s FS is fail\n",_prefix.c_str());
-                    if (fs_out.fail())  aprintf(stdout, "\n%s FS out is fail\n",_prefix.c_str());
-                    
-                    ret = false;
-                    break;
+    std::vector<std::thread> formatters;
+    for(uint32_t i = 0; i < threads; i++){
+        formatters.emplace_back([&](){
+            while(true){
+                SSegmentJobPtr job;
+                {
+                    std::unique_lock<std::mutex> lock(mtx);
+                    cv.wait(lock,[&](){ return abort || !toFormat.empty() || readerDone; });
+                    if (abort || toFormat.empty()) break;
+                    job = toFormat.front();
+                    toFormat.pop_front();
+                }
+                if (job->notSkip){
+                    formatSegment(job->header,job->data.data(),job->samplePos,job->text);
+                    job->data = std::vector<char>();
                 }
-                
+                std::lock_guard<std::mutex> lock(mtx);
+                formatted[job->index] = job;
+                cv.notify_all();
+            }
+        });
+    }
+
+    // Writer. Segments are written in the order they were read
+    bool ret = true;
+    uint64_t notSynced = SYNC_SIZE;
+    int lastProgress = -1;
+    while(true){
+        if (notSynced >= SYNC_SIZE){
+            fflush(fs_out);
+#ifndef _WIN32
+            fsync(fileno(fs_out));
+#endif
+            notSynced = 0;
+            auto freeSize = getFreeSpaceDisk(csv_file);
+            if (freeSize <= USING_FREE_SPACE){
+                aprintf(stdout,"%s Disk is full\n",_prefix.c_str());
+                ret = false;
+                break;
             }
         }
-        aprintf(stdout, "\n%s Ended converting\n",_prefix.c_str());
-    }catch (std::exception& e)
-	{
-        aprintf(stderr,"%s Error: convertToCSV() : %s\n",_prefix.c_str(),e.what());
+        if (m_stopWriteCSV){
+            aprintf(stdout,"%s Abort writing to CSV file\n",_prefix.c_str());
+            ret = false;
+            break;
+        }
+        SSegmentJobPtr job;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait_for(lock,std::chrono::milliseconds(100),[&](){ return formatted.count(written) || (readerDone && produced == written); });
+            if (readerDone && produced == written) break;
+            auto it = formatted.find(written);
+            if (it == formatted.end()) continue;
+            job = it->second;
+            formatted.erase(it);
+        }
+        if (job->progress >= 0 && job->progress != lastProgress){
+            aprintf(stdout, "\r%s PROGRESS: %d %",_prefix.c_str(),job->progress);
+            lastProgress = job->progress;
+        }
+        if (job->text.size()){
+            fwrite(job->text.data(),1,job->text.size(),fs_out);
+            notSynced += job->text.size();
+        }
+        std::lock_guard<std::mutex> lock(mtx);
+        written++;
+        cv.notify_all();
+        if (ferror(fs_out)){
+            break;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        abort = true;
+        cv.notify_all();
+    }
+    reader.join();
+    for(auto &th : formatters){
+        th.join();
+    }
+
+    fflush(fs_out);
+#ifndef _WIN32
+    fsync(fileno(fs_out));
+#endif
+    bool writeFail = ferror(fs_out);
+    fclose(fs_out);
+    if (ret && (readFail || writeFail)) {
+        aprintf(stdout, "\n%s Error write to CSV file\n",_prefix.c_str());
+        if (readFail)  aprintf(stdout, "\n%s FS is fail\n",_prefix.c_str());
+        if (writeFail)  aprintf(stdout, "\n%s FS out is fail\n",_prefix.c_str());
         ret = false;
-	}
+    }
     return ret;
 }
-
-
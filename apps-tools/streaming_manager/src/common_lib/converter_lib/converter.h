@@ -2,6 +2,8 @@
 #define CONVERTER_LIB_CONVERTER_H
 
 #include <memory>
+#include <atomic>
+#include <mutex>
 
 #include "settings_lib/stream_settings.h"
 #include "logger_lib/file_logger.h"
@@ -32,6 +34,11 @@ public:
     bool convertToCSV(std::string _file_name, int32_t start_seg, int32_t end_seg,std::string _prefix);
     void stopWriteToCSV();
 
+    // Number of formatting threads. 0 - old sequential converter.
+    // Both produce the same CSV file
+    auto setThreads(uint32_t threads) -> void;
+    auto getThreads() -> uint32_t;
+
 private:
 
 
@@ -40,7 +47,11 @@ private:
     CConverter& operator=(const CConverter&) =delete;
     CConverter& operator=(const CConverter&&) =delete;
 
+    auto convertSequential(std::string _file_name,std::string _csv_file, int32_t start_seg, int32_t end_seg,std::string _prefix) -> bool;
+    auto convertPipelined(std::string _file_name,std::string _csv_file, int32_t start_seg, int32_t end_seg,std::string _prefix) -> bool;
+
     std::atomic_bool m_stopWriteCSV;
+    std::atomic<uint32_t> m_threads;
 
     std::mutex  m_mtx;
 };
@@ -0,0 +1,78 @@
+#include <chrono>
+
+#include "dac_buffer_pool.h"
+
+using namespace dac_streaming_lib;
+
+auto CDACBufferPool::create(size_t count, size_t size) -> CDACBufferPool::Ptr{
+    return std::make_shared<CDACBufferPool>(count,size);
+}
+
+CDACBufferPool::CDACBufferPool(size_t count, size_t size):
+    m_size(size),
+    m_memory(new uint8_t[count * size * 2]),
+    m_buffers(count),
+    m_free(count),
+    m_ready(count),
+    m_mtx(),
+    m_freeCond(),
+    m_readyCond()
+{
+    for(size_t i = 0; i < count; i++){
+        m_buffers[i].ch1 = m_memory.get() + i * size * 2;
+        m_buffers[i].ch2 = m_buffers[i].ch1 + size;
+        m_buffers[i].capacity = size;
+        m_free.push(&m_buffers[i]);
+    }
+}
+
+auto CDACBufferPool::getBufferSize() -> size_t{
+    return m_size;
+}
+
+auto CDACBufferPool::wait(std::condition_variable &cond, DataLib::CSPSCQueue<Buffer*> &queue, int timeout_ms) -> Buffer*{
+    auto item = queue.front();
+    if (!item){
+        std::unique_lock<std::mutex> lock(m_mtx);
+        cond.wait_for(lock,std::chrono::milliseconds(timeout_ms),[&]{ return queue.front() != nullptr; });
+        item = queue.front();
+    }
+    return item ? *item : nullptr;
+}
+
+auto CDACBufferPool::notify(std::condition_variable &cond) -> void{
+    // The waiter checks the queue under the mutex, taking it here prevents a lost wakeup
+    {
+        const std::lock_guard<std::mutex> lock(m_mtx);
+    }
+    cond.notify_one();
+}
+
+auto CDACBufferPool::getFree(int timeout_ms) -> Buffer*{
+    auto buffer = wait(m_freeCond,m_free,timeout_ms);
+    if (buffer){
+        m_free.pop();
+        buffer->size_ch1 = 0;
+        buffer->size_ch2 = 0;
+    }
+    return buffer;
+}
+
+auto CDACBufferPool::pushReady(Buffer *buffer) -> void{
+    m_ready.push(std::move(buffer));
+    notify(m_readyCond);
+}
+
+auto CDACBufferPool::getReady(int timeout_ms) -> Buffer*{
+    return wait(m_readyCond,m_ready,timeout_ms);
+}
+
+auto CDACBufferPool::releaseReady() -> void{
+    auto item = m_ready.front();
+    if (item){
+        auto buffer = *item;
+        m_ready.pop();
+        m_free.push(std::move(buffer));
+        notify(m_freeCond);
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef STREAMING_ROOT_DACBUFFERPOOL_H
+#define STREAMING_ROOT_DACBUFFERPOOL_H
+
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+#include "data_lib/spsc_queue.h"
+
+namespace dac_streaming_lib {
+
+/*
+ * Fixed set of preallocated buffers shared by the thread that reads the data
+ * (file or network) and the thread that feeds the generator. Buffers move
+ * from the free queue to the reader, from the reader to the ready queue and
+ * back to the free queue after the generator took the data.
+ *
+ * Each queue has exactly one producer and one consumer thread.
+ */
+class CDACBufferPool{
+
+public:
+
+    struct Buffer{
+        uint8_t* ch1 = nullptr;
+        uint8_t* ch2 = nullptr;
+        size_t   size_ch1 = 0;
+        size_t   size_ch2 = 0;
+        size_t   capacity = 0;
+    };
+
+    using Ptr = std::shared_ptr<CDACBufferPool>;
+
+    static auto create(size_t count, size_t size) -> Ptr;
+
+    CDACBufferPool(size_t count, size_t size);
+
+    // Capacity of one channel buffer in bytes
+    auto getBufferSize() -> size_t;
+
+    // Reader side. Returns nullptr if there was no free buffer during timeout_ms
+    auto getFree(int timeout_ms) -> Buffer*;
+    auto pushReady(Buffer *buffer) -> void;
+
+    // Generator side. The buffer stays in the ready queue until releaseReady()
+    auto getReady(int timeout_ms) -> Buffer*;
+    auto releaseReady() -> void;
+
+private:
+
+    CDACBufferPool(const CDACBufferPool &) = delete;
+    CDACBufferPool(CDACBufferPool &&) = delete;
+    CDACBufferPool& operator=(const CDACBufferPool&) =delete;
+    CDACBufferPool& operator=(const CDACBufferPool&&) =delete;
+
+    auto wait(std::condition_variable &cond, DataLib::CSPSCQueue<Buffer*> &queue, int timeout_ms) -> Buffer*;
+    auto notify(std::condition_variable &cond) -> void;
+
+    size_t m_size;
+    std::unique_ptr<uint8_t[]> m_memory;
+    std::vector<Buffer> m_buffers;
+    DataLib::CSPSCQueue<Buffer*> m_free;
+    DataLib::CSPSCQueue<Buffer*> m_ready;
+    std::mutex m_mtx;
+    std::condition_variable m_freeCond;
+    std::condition_variable m_readyCond;
+};
+
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include <functional>
 #include <cstdlib>
 #include <deque>
+#include <algorithm>
 
 #include "data_lib/thread_cout.h"
 #include "dac_streaming_application.h"
@@ -15,12 +16,16 @@ CDACStreamingApplication::CDACStreamingApplication(CDACStreamingManager::Ptr _st
     m_gen(_gen),
     m_streamingManager(_streamingManager),
     m_Thread(),
+    m_ReaderThread(),
+    m_pool(nullptr),
     mtx(),
+    m_ReaderThreadRun(false),
     m_ReadyToPass(0),
     m_isRun(false),
     m_isRunNonBloking(false),
     m_testMode(false),
-    m_verbMode(false)
+    m_verbMode(false),
+    m_interruptMode(false)
 {
     m_GenThreadRun.test_and_set();
 }
@@ -34,7 +39,7 @@ auto CDACStreamingApplication::run() -> void {
     m_isRunNonBloking = false;
     try {
         m_streamingManager->run();
-        m_Thread = std::thread(&CDACStreamingApplication::genWorker, this);
+        startWorkers();
         if (m_Thread.joinable()){
             m_Thread.join();
         }
@@ -51,7 +56,7 @@ auto CDACStreamingApplication::runNonBlock() -> void {
     m_isRunNonBloking = true;    
     try {
         m_streamingManager->run(); // MUST BE INIT FIRST for thread logic
-        m_Thread = std::thread(&CDACStreamingApplication::genWorker, this);
+        startWorkers();
     }
     catch (const std::exception &e)
     {
@@ -69,6 +74,10 @@ auto CDACStreamingApplication::stop(bool wait) -> bool{
         }else{
             while(isRun());
         }
+        m_ReaderThreadRun = false;
+        if (m_ReaderThread.joinable()){
+            m_ReaderThread.join();
+        }
         m_streamingManager->stop();
         m_streamingManager = nullptr;
         m_gen->stop();
@@ -79,6 +88,18 @@ auto CDACStreamingApplication::stop(bool wait) -> bool{
     return state;
 }
 
+auto CDACStreamingApplication::startWorkers() -> void{
+    if (m_interruptMode){
+        auto size = std::max(CReaderController::getPreparedSize(),(size_t)uio_lib::dac_buf_size);
+        m_pool = CDACBufferPool::create(dac_pool_size,size);
+        m_ReaderThreadRun = true;
+        m_ReaderThread = std::thread(&CDACStreamingApplication::readerWorker, this);
+        m_Thread = std::thread(&CDACStreamingApplication::genWorkerInterrupt, this);
+    }else{
+        m_Thread = std::thread(&CDACStreamingApplication::genWorker, this);
+    }
+}
+
 void CDACStreamingApplication::genWorker()
 {
     int64_t counter = 0;
@@ -122,6 +143,63 @@ try{
     m_isRun = false;
 }
 
+void CDACStreamingApplication::readerWorker()
+{
+    CDACBufferPool::Buffer *buffer = nullptr;
+try{
+    while (m_ReaderThreadRun)
+    {
+        if (!buffer){
+            buffer = m_pool->getFree(100);
+            if (!buffer) continue;
+        }
+
+        if (m_streamingManager->getBuffer(buffer)){
+            m_pool->pushReady(buffer);
+            buffer = nullptr;
+        }else{
+            // No data from the network yet or the file has ended
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}catch (std::exception& e)
+	{
+		std::cerr << "Error: readerWorker() " << e.what() << std::endl ;
+	}
+}
+
+void CDACStreamingApplication::genWorkerInterrupt()
+{
+    int64_t counter = 0;
+    m_gen->prepare();
+    m_gen->start();
+
+    CDACBufferPool::Buffer *buffer = nullptr;
+try{
+    while (m_GenThreadRun.test_and_set())
+    {
+        if (!buffer){
+            buffer = m_pool->getReady(100);
+            if (!buffer) continue;
+        }
+
+        if (m_gen->write(buffer->ch1,buffer->ch2,buffer->size_ch1,buffer->size_ch2)){
+            counter++;
+            m_pool->releaseReady();
+            buffer = nullptr;
+        }else{
+            // Both DMA buffers are busy, sleep until one of them is played out
+            m_gen->wait(100);
+        }
+    }
+
+}catch (std::exception& e)
+	{
+		std::cerr << "Error: genWorkerInterrupt() " << e.what() << std::endl ;
+	}
+    m_isRun = false;
+}
+
 void CDACStreamingApplication::signalHandler(const std::error_code &, int _signalNumber)
 {
     static_cast<void>(_signalNumber);
@@ -135,3 +213,7 @@ auto CDACStreamingApplication::setTestMode(bool mode) -> void{
 auto CDACStreamingApplication::setVerbousMode(bool mode) -> void{
     m_verbMode = mode;
 }
+
+auto CDACStreamingApplication::setInterruptMode(bool mode) -> void{
+    m_interruptMode = mode;
+}
@@ -9,9 +9,13 @@
 
 #include "uio_lib/generator.h"
 #include "dac_streaming_manager.h"
+#include "dac_buffer_pool.h"
 
 namespace dac_streaming_lib {
 
+// Buffers between the reader and the generator in the interrupt mode
+constexpr size_t dac_pool_size = 16;
+
 class CDACStreamingApplication
 {
 
@@ -27,6 +31,9 @@ public:
     auto isRun() -> bool {return m_isRun;}
     auto setTestMode(bool mode) -> void;
     auto setVerbousMode(bool mode) -> void;
+    // Feeds the generator from a fixed buffer pool and sleeps on the DMA interrupt
+    // instead of polling. Must be set before run()
+    auto setInterruptMode(bool mode) -> void;
 
 private:
     int m_PerformanceCounterPeriod = 10;
@@ -34,16 +41,23 @@ private:
      uio_lib::CGenerator::Ptr m_gen;
     CDACStreamingManager::Ptr m_streamingManager;
     std::thread m_Thread;
+    std::thread m_ReaderThread;
+    CDACBufferPool::Ptr m_pool;
     std::mutex mtx;
     std::atomic_flag m_GenThreadRun = ATOMIC_FLAG_INIT;
+    std::atomic_bool m_ReaderThreadRun;
     std::atomic_int  m_ReadyToPass;
     std::atomic_bool m_isRun;
     std::atomic_bool m_isRunNonBloking;
     static_assert(ATOMIC_INT_LOCK_FREE == 2,"this implementation does not guarantee that std::atomic<int> is always lock free.");
     bool             m_testMode;
     bool             m_verbMode;
-    
+    bool             m_interruptMode;
+
+    auto startWorkers() -> void;
     void genWorker();
+    void genWorkerInterrupt();
+    void readerWorker();
     void signalHandler(const std::error_code &_error, int _signalNumber);
 };
 
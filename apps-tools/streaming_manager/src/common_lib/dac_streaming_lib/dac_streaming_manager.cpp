@@ -25,7 +25,8 @@ CDACStreamingManager::CDACStreamingManager(DACStream_FileType _fileType, std::st
     m_repeat(_repeat),
     m_rep_count(_rep_count),
     m_memoryCacheSize(memoryCacheSize),
-    m_readerController(nullptr)
+    m_readerController(nullptr),
+    m_underruns(0)
 {
     if (m_fileType == DACStream_FileType::TDMS_TYPE){
         m_readerController = new CReaderController(CStreamSettings::TDMS,m_filePath,m_repeat,m_rep_count,m_memoryCacheSize);
@@ -34,6 +35,10 @@ CDACStreamingManager::CDACStreamingManager(DACStream_FileType _fileType, std::st
     if (m_fileType == DACStream_FileType::WAV_TYPE){
         m_readerController = new CReaderController(CStreamSettings::WAV,m_filePath,m_repeat,m_rep_count,m_memoryCacheSize);
     }
+
+    if (m_fileType == DACStream_FileType::BIN_TYPE){
+        m_readerController = new CReaderController(CStreamSettings::BIN,m_filePath,m_repeat,m_rep_count,m_memoryCacheSize);
+    }
 }
 
 CDACStreamingManager::Ptr CDACStreamingManager::Create(std::string _host,std::string _port){
@@ -50,7 +55,8 @@ CDACStreamingManager::CDACStreamingManager(std::string _host, std::string _port)
     m_repeat(CStreamSettings::DAC_REP_OFF),
     m_rep_count(0),
     m_memoryCacheSize(0),
-    m_readerController(nullptr)
+    m_readerController(nullptr),
+    m_underruns(0)
 {
 }
 
@@ -92,17 +98,51 @@ auto CDACStreamingManager::stop() -> void {
     }
 }
 
+auto CDACStreamingManager::checkReader() -> bool{
+    auto isOpen = m_readerController->isOpen();
+    if (isOpen != CReaderController::OR_OK){
+        if (isOpen == CReaderController::OR_CLOSE){
+            notifyStop(CDACStreamingManager::NR_MISSING_FILE);
+            return false;
+        }
+        notifyStop(CDACStreamingManager::NR_BROKEN);
+        return false;
+    }
+    return true;
+}
+
+auto CDACStreamingManager::notifyBufferResult(CReaderController::BufferResult res) -> void{
+    auto sendRes = CDACStreamingManager::NR_STOP;
+    switch(res){
+        case CReaderController::BR_BROKEN:
+            sendRes = CDACStreamingManager::NR_BROKEN;
+        break;
+        case CReaderController::BR_EMPTY:
+            sendRes = CDACStreamingManager::NR_EMPTY;
+        break;
+        case CReaderController::BR_ENDED:
+            sendRes = CDACStreamingManager::NR_ENDED;
+        break;
+        default:
+        break;
+    }
+
+    notifyStop(sendRes);
+}
+
+auto CDACStreamingManager::checkUnderrun() -> void{
+    auto underruns = m_readerController->getUnderrunCount();
+    if (underruns != m_underruns){
+        notifyUnderrun(underruns - m_underruns);
+        m_underruns = underruns;
+    }
+}
+
 auto CDACStreamingManager::getBuffer() -> const CDACAsioNetController::BufferPack {
     if (m_use_local_file){
         CDACAsioNetController::BufferPack pack;
         if (m_readerController){
-            auto isOpen = m_readerController->isOpen();
-            if (isOpen != CReaderController::OR_OK){
-                if (isOpen == CReaderController::OR_CLOSE){
-                    notifyStop(CDACStreamingManager::NR_MISSING_FILE);
-                    return CDACAsioNetController::BufferPack();
-                }
-                notifyStop(CDACStreamingManager::NR_BROKEN);
+            if (!checkReader()){
                 return CDACAsioNetController::BufferPack();
             }
             uint8_t *ch1_read = nullptr;
@@ -110,6 +150,7 @@ auto CDACStreamingManager::getBuffer() -> const CDACAsioNetController::BufferPac
             size_t size1_read = 0;
             size_t size2_read = 0;
             auto res = m_readerController->getBufferPrepared(&ch1_read,&size1_read,&ch2_read,&size2_read);
+            checkUnderrun();
             if (size1_read != 0 || size2_read != 0){
                 pack.ch1 = ch1_read;
                 pack.ch2 = ch2_read;
@@ -119,22 +160,7 @@ auto CDACStreamingManager::getBuffer() -> const CDACAsioNetController::BufferPac
                     pack.empty = false;
                 }
             }else{
-                auto sendRes = CDACStreamingManager::NR_STOP;
-                switch(res){
-                    case CReaderController::BR_BROKEN:
-                        sendRes = CDACStreamingManager::NR_BROKEN;
-                    break;
-                    case CReaderController::BR_EMPTY:
-                        sendRes = CDACStreamingManager::NR_EMPTY;
-                    break;
-                    case CReaderController::BR_ENDED:
-                        sendRes = CDACStreamingManager::NR_ENDED;
-                    break;
-                    default:
-                    break;
-                }
-
-                notifyStop(sendRes);
+                notifyBufferResult(res);
             }
         }
         return pack;
@@ -145,6 +171,43 @@ auto CDACStreamingManager::getBuffer() -> const CDACAsioNetController::BufferPac
     return CDACAsioNetController::BufferPack();
 }
 
+auto CDACStreamingManager::getBuffer(CDACBufferPool::Buffer *buffer) -> bool{
+    buffer->size_ch1 = 0;
+    buffer->size_ch2 = 0;
+    if (m_use_local_file){
+        if (m_readerController){
+            if (!checkReader()){
+                return false;
+            }
+            auto res = m_readerController->getBufferPreparedTo(buffer->ch1,&buffer->size_ch1,buffer->ch2,&buffer->size_ch2);
+            checkUnderrun();
+            if (buffer->size_ch1 != 0 || buffer->size_ch2 != 0){
+                return true;
+            }
+            notifyBufferResult(res);
+        }
+    } else{
+        if (m_asionet){
+            // The network packs are allocated by the receiver, they are copied into the pool and freed here
+            auto pack = m_asionet->getBuffer();
+            if (pack.empty)
+                return false;
+            if (pack.ch1){
+                buffer->size_ch1 = std::min(pack.size_ch1,buffer->capacity);
+                memcpy_neon(buffer->ch1,pack.ch1,buffer->size_ch1);
+                delete[] pack.ch1;
+            }
+            if (pack.ch2){
+                buffer->size_ch2 = std::min(pack.size_ch2,buffer->capacity);
+                memcpy_neon(buffer->ch2,pack.ch2,buffer->size_ch2);
+                delete[] pack.ch2;
+            }
+            return buffer->size_ch1 || buffer->size_ch2;
+        }
+    }
+    return false;
+}
+
 auto CDACStreamingManager::isLocalMode() -> bool{
     return m_use_local_file;
 }
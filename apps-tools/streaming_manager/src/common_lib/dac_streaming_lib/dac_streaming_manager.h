@@ -10,6 +10,7 @@
 #include <functional>
 
 #include "dac_net_controller.h"
+#include "dac_buffer_pool.h"
 #include "uio_lib/generator.h"
 #include "settings_lib/dac_settings.h"
 #include "reader_lib/reader_controller.h"
@@ -30,7 +31,8 @@ class CDACStreamingManager
 
         enum DACStream_FileType{
             TDMS_TYPE,
-            WAV_TYPE
+            WAV_TYPE,
+            BIN_TYPE
         };
            
         using Ptr = std::shared_ptr<CDACStreamingManager>;
@@ -50,8 +52,12 @@ class CDACStreamingManager
         auto stop() -> void;
         auto isLocalMode() -> bool;
         auto getBuffer() -> const CDACAsioNetController::BufferPack;
+        // Fills a pool buffer. Returns false if there is no data now
+        auto getBuffer(CDACBufferPool::Buffer *buffer) -> bool;
 
         sigslot::signal<NotifyResult> notifyStop;
+        // New underruns of the file reader since the last notification
+        sigslot::signal<uint64_t> notifyUnderrun;
         
 private:
                        bool m_use_local_file;
@@ -65,7 +71,11 @@ private:
                     int32_t m_rep_count;
                     int64_t m_memoryCacheSize;
          CReaderController *m_readerController;
+                   uint64_t m_underruns;
 
+        auto checkReader() -> bool;
+        auto notifyBufferResult(CReaderController::BufferResult res) -> void;
+        auto checkUnderrun() -> void;
         auto startServer() -> void;
         auto stopServer() -> void;
 };
@@ -2,6 +2,7 @@
 #include <chrono>
 #include "buffer.h"
 #include "neon_asm.h"
+#include "stream_kernels.h"
 #include "thread_cout.h"
 
 using namespace DataLib;
@@ -82,16 +83,9 @@ CDataBuffer::CDataBuffer(uint8_t *buffer,size_t lenght,uint8_t bits,bool simpleC
         if (buffer && lenght > 0 && bits == 8){
 
             try{
-#ifdef ARM_NEON
-               m_data = std::shared_ptr<uint8_t[]>(new uint8_t[lenght]);
-               memcpy_stride_8bit_neon(m_data.get(),buffer,lenght);
-#else
                m_data = std::shared_ptr<uint8_t[]>(new uint8_t[lenght]);
-               auto b16 = reinterpret_cast<uint16_t*>(buffer);
-               for(auto i = 0u; i < lenght /2 ;i++){
-                   m_data[i] = b16[i] >> 8;
-               }
-#endif
+               // High byte of every 16 bit sample
+               narrow_16_to_8bit((int8_t*)m_data.get(),(const int16_t*)buffer,lenght / 2,8);
                m_lenght = lenght / 2;
                m_bitBySample = bits;
                m_samplesCount = m_lenght;
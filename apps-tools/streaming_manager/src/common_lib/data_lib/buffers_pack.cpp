@@ -13,6 +13,7 @@ CDataBuffersPack::CDataBuffersPack():
      m_buffers()
     ,m_oscRate(0)
     ,m_adc_bits(0)
+    ,m_timestamp(0)
 {
 }
 
@@ -50,6 +51,14 @@ auto CDataBuffersPack::getADCBits() -> uint8_t{
     return m_adc_bits;
 }
 
+auto CDataBuffersPack::setTimestamp(uint64_t ns) -> void{
+    m_timestamp = ns;
+}
+
+auto CDataBuffersPack::getTimestamp() -> uint64_t{
+    return m_timestamp;
+}
+
 auto CDataBuffersPack::checkBuffersEqual() -> bool{
     size_t size = 0;
     uint8_t bits = 0;
@@ -33,6 +33,9 @@ public:
     auto getOSCRate() -> uint64_t;
     auto setADCBits(uint8_t bits) -> void;
     auto getADCBits() -> uint8_t;
+    // Steady clock time in ns when DMA filled the buffers, 0 if unknown
+    auto setTimestamp(uint64_t ns) -> void;
+    auto getTimestamp() -> uint64_t;
 
     auto checkBuffersEqual() -> bool;
     auto getBuffersLenght() -> size_t;
@@ -51,6 +54,7 @@ private:
     std::map<EDataBuffersPackChannel,CDataBuffer::Ptr> m_buffers;
     uint64_t m_oscRate; // Decimation
     uint8_t  m_adc_bits;
+    uint64_t m_timestamp;
 };
 
 }
@@ -0,0 +1,84 @@
+#include <cstdio>
+#include <chrono>
+#include "latency_histogram.h"
+
+using namespace DataLib;
+
+CLatencyHistogram::CLatencyHistogram(){
+    reset();
+}
+
+auto CLatencyHistogram::now() -> uint64_t{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+auto CLatencyHistogram::add(uint64_t ns) -> void{
+    uint64_t us = ns / 1000;
+    uint32_t index = 0;
+    while(us && index < BUCKETS - 1){
+        us >>= 1;
+        index++;
+    }
+    m_buckets[index].fetch_add(1,std::memory_order_relaxed);
+    m_count.fetch_add(1,std::memory_order_relaxed);
+    m_sum.fetch_add(ns,std::memory_order_relaxed);
+    auto max = m_max.load(std::memory_order_relaxed);
+    while(ns > max && !m_max.compare_exchange_weak(max,ns,std::memory_order_relaxed)){}
+}
+
+auto CLatencyHistogram::reset() -> void{
+    for(auto &b : m_buckets){
+        b = 0;
+    }
+    m_count = 0;
+    m_sum = 0;
+    m_max = 0;
+}
+
+auto CLatencyHistogram::getCount() -> uint64_t{
+    return m_count;
+}
+
+auto CLatencyHistogram::getMax() -> uint64_t{
+    return m_max;
+}
+
+auto CLatencyHistogram::getBucket(uint32_t index) -> uint64_t{
+    return index < BUCKETS ? m_buckets[index].load() : 0;
+}
+
+auto CLatencyHistogram::getPercentile(double percent) -> uint64_t{
+    uint64_t count = m_count;
+    if (count == 0){
+        return 0;
+    }
+    uint64_t limit = (uint64_t)(count * percent / 100.0);
+    uint64_t acc = 0;
+    for(uint32_t i = 0; i < BUCKETS; i++){
+        acc += m_buckets[i];
+        if (acc > limit){
+            return 1ull << i;
+        }
+    }
+    return 1ull << (BUCKETS - 1);
+}
+
+auto CLatencyHistogram::toString() -> std::string{
+    std::string str;
+    uint64_t count = m_count;
+    char line[128];
+    snprintf(line,sizeof(line),"count %llu avg %llu us max %llu us p50 < %llu us p99 < %llu us\n",
+             (unsigned long long)count,
+             (unsigned long long)(count ? m_sum / count / 1000 : 0),
+             (unsigned long long)(m_max / 1000),
+             (unsigned long long)getPercentile(50),
+             (unsigned long long)getPercentile(99));
+    str += line;
+    for(uint32_t i = 0; i < BUCKETS; i++){
+        uint64_t value = m_buckets[i];
+        if (value == 0) continue;
+        snprintf(line,sizeof(line),"  < %8llu us: %llu\n",1ull << i,(unsigned long long)value);
+        str += line;
+    }
+    return str;
+}
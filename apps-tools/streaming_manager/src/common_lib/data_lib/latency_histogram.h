@@ -0,0 +1,49 @@
+#ifndef DATA_LIB_LATENCY_HISTOGRAM_H
+#define DATA_LIB_LATENCY_HISTOGRAM_H
+
+#include <stdint.h>
+#include <atomic>
+#include <array>
+#include <string>
+
+namespace DataLib {
+
+/*
+ * Lock-free histogram with power of two buckets in microseconds.
+ * Bucket 0 holds values below 1 us, bucket N holds [2^(N-1), 2^N) us.
+ */
+class CLatencyHistogram final{
+
+public:
+
+    static constexpr uint32_t BUCKETS = 24;
+
+    CLatencyHistogram();
+
+    static auto now() -> uint64_t;
+
+    auto add(uint64_t ns) -> void;
+    auto reset() -> void;
+    auto getCount() -> uint64_t;
+    auto getMax() -> uint64_t;
+    auto getBucket(uint32_t index) -> uint64_t;
+    // Upper bound of the bucket that holds the percentile, in us
+    auto getPercentile(double percent) -> uint64_t;
+    auto toString() -> std::string;
+
+private:
+
+    CLatencyHistogram(const CLatencyHistogram &) = delete;
+    CLatencyHistogram(CLatencyHistogram &&) = delete;
+    CLatencyHistogram& operator=(const CLatencyHistogram&) =delete;
+    CLatencyHistogram& operator=(const CLatencyHistogram&&) =delete;
+
+    std::array<std::atomic<uint64_t>,BUCKETS> m_buckets;
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_sum;
+    std::atomic<uint64_t> m_max;
+};
+
+}
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef DATA_LIB_SPSC_QUEUE_H
+#define DATA_LIB_SPSC_QUEUE_H
+
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+namespace DataLib {
+
+/*
+ * Bounded lock-free queue for one producer thread and one consumer thread.
+ * The capacity is rounded up to a power of two.
+ */
+template <typename T>
+class CSPSCQueue final{
+
+public:
+
+    CSPSCQueue(size_t capacity):
+        m_items(),
+        m_mask(0),
+        m_head(0),
+        m_tail(0)
+    {
+        size_t size = 1;
+        while(size < capacity) size <<= 1;
+        m_items.resize(size);
+        m_mask = size - 1;
+    }
+
+    // Producer. Returns false if the queue is full
+    auto push(T &&item) -> bool{
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) > m_mask){
+            return false;
+        }
+        m_items[tail & m_mask] = std::move(item);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer. Returns nullptr if the queue is empty
+    auto front() -> T*{
+        auto head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)){
+            return nullptr;
+        }
+        return &m_items[head & m_mask];
+    }
+
+    // Consumer. Must follow a successful front()
+    auto pop() -> void{
+        auto head = m_head.load(std::memory_order_relaxed);
+        m_items[head & m_mask] = T();
+        m_head.store(head + 1, std::memory_order_release);
+    }
+
+    auto size() const -> size_t{
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    auto capacity() const -> size_t{
+        return m_mask + 1;
+    }
+
+private:
+
+    CSPSCQueue(const CSPSCQueue &) = delete;
+    CSPSCQueue(CSPSCQueue &&) = delete;
+    CSPSCQueue& operator=(const CSPSCQueue&) =delete;
+    CSPSCQueue& operator=(const CSPSCQueue&&) =delete;
+
+    std::vector<T> m_items;
+    size_t m_mask;
+    alignas(64) std::atomic<size_t> m_head;
+    alignas(64) std::atomic<size_t> m_tail;
+};
+
+}
+
+#endif
@@ -0,0 +1,495 @@
+#include "stream_kernels.h"
+
+#ifdef ARCH_ARM
+#include <arm_neon.h>
+#define STREAM_KERNELS_NEON
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#include <emmintrin.h>
+#define STREAM_KERNELS_SSE2
+#endif
+
+#define CALIB_SHIFT 14
+
+// The scalar code is the reference and also handles the tails of the vector loops
+
+template<typename T>
+static inline void split_2ch_scalar(T *ch1, T *ch2, const T *src, size_t from, size_t samples) noexcept{
+    for(size_t i = from; i < samples; i++){
+        ch1[i] = src[i * 2];
+        ch2[i] = src[i * 2 + 1];
+    }
+}
+
+template<typename T>
+static inline void split_4ch_scalar(T *const dst[4], const T *src, size_t from, size_t samples) noexcept{
+    for(size_t i = from; i < samples; i++){
+        dst[0][i] = src[i * 4];
+        dst[1][i] = src[i * 4 + 1];
+        dst[2][i] = src[i * 4 + 2];
+        dst[3][i] = src[i * 4 + 3];
+    }
+}
+
+template<typename T>
+static inline void pack_2ch_scalar(T *dst, const T *ch1, const T *ch2, size_t from, size_t samples) noexcept{
+    for(size_t i = from; i < samples; i++){
+        dst[i * 2] = ch1[i];
+        dst[i * 2 + 1] = ch2[i];
+    }
+}
+
+template<typename T>
+static inline void pack_4ch_scalar(T *dst, const T *const src[4], size_t from, size_t samples) noexcept{
+    for(size_t i = from; i < samples; i++){
+        dst[i * 4] = src[0][i];
+        dst[i * 4 + 1] = src[1][i];
+        dst[i * 4 + 2] = src[2][i];
+        dst[i * 4 + 3] = src[3][i];
+    }
+}
+
+static inline void narrow_scalar(int8_t *dst, const int16_t *src, size_t from, size_t n, unsigned shift) noexcept{
+    for(size_t i = from; i < n; i++){
+        int v = src[i] >> shift;
+        dst[i] = (int8_t)(v > 127 ? 127 : (v < -128 ? -128 : v));
+    }
+}
+
+static inline void calib_scalar(int16_t *dst, const int16_t *src, size_t from, size_t n, int32_t gain, int32_t bias) noexcept{
+    for(size_t i = from; i < n; i++){
+        int32_t v = (src[i] * gain + bias + (1 << (CALIB_SHIFT - 1))) >> CALIB_SHIFT;
+        dst[i] = (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+    }
+}
+
+#ifdef STREAM_KERNELS_NEON
+
+static void split_2ch_8bit_neon(int8_t *ch1, int8_t *ch2, const int8_t *src, size_t samples) noexcept{
+    size_t i = 0;
+    for(; i + 16 <= samples; i += 16){
+        int8x16x2_t v = vld2q_s8(src + i * 2);
+        vst1q_s8(ch1 + i,v.val[0]);
+        vst1q_s8(ch2 + i,v.val[1]);
+    }
+    split_2ch_scalar(ch1,ch2,src,i,samples);
+}
+
+static void split_2ch_16bit_neon(int16_t *ch1, int16_t *ch2, const int16_t *src, size_t samples) noexcept{
+    size_t i = 0;
+    for(; i + 8 <= samples; i += 8){
+        int16x8x2_t v = vld2q_s16(src + i * 2);
+        vst1q_s16(ch1 + i,v.val[0]);
+        vst1q_s16(ch2 + i,v.val[1]);
+    }
+    split_2ch_scalar(ch1,ch2,src,i,samples);
+}
+
+static void split_4ch_8bit_neon(int8_t *const dst[4], const int8_t *src, size_t samples) noexcept{
+    size_t i = 0;
+    for(; i + 16 <= samples; i += 16){
+        int8x16x4_t v = vld4q_s8(src + i * 4);
+        vst1q_s8(dst[0] + i,v.val[0]);
+        vst1q_s8(dst[1] + i,v.val[1]);
+        vst1q_s8(dst[2] + i,v.val[2]);
+        vst1q_s8(dst[3] + i,v.val[3]);
+    }
+    split_4ch_scalar(dst,src,i,samples);
+}
+
+static void split_4ch_16bit_neon(int16_t *const dst[4], const int16_t *src, size_t samples) noexcept{
+    size_t i = 0;
+    for(; i + 8 <= samples; i += 8){
+        int16x8x4_t v = vld4q_s16(src + i * 4);
+        vst1q_s16(dst[0] + i,v.val[0]);
+        vst1q_s16(dst[1] + i,v.val[1]);
+        vst1q_s16(dst[2] + i,v.val[2]);
+        vst1q_s16(dst[3] + i,v.val[3]);
+    }
+    split_4ch_scalar(dst,src,i,samples);
+}
+
+static void pack_2ch_8bit_neon(int8_t *dst, const int8_t *ch1, const int8_t *ch2, size_t samples) noexcept{
+    size_t i = 0;
+    for(; i + 16 <= samples; i += 16){
+        int8x16x2_t v;
+        v.val[0] = vld1q_s8(ch1 + i);
+        v.val[1] = vld1q_s8(ch2 + i);
+        vst2q_s8(dst + i * 2,v);
+    }
+    pack_2ch_scalar(dst,ch1,ch2,i,samples);
+}
+
+static void pack_2ch_16bit_neon(int16_t *dst, const int16_t *ch1, const int16_t *ch2, size_t samples) noexcept{
+    size_t i = 0;
+    for(; i + 8 <= samples; i += 8){
+        int16x8x2_t v;
+        v.val[0] = vld1q_s16(ch1 + i);
+        v.val[1] = vld1q_s16(ch2 + i);
+        vst2q_s16(dst + i * 2,v);
+    }
+    pack_2ch_scalar(dst,ch1,ch2,i,samples);
+}
+
+static void pack_4ch_8bit_neon(int8_t *dst, const int8_t *const src[4], size_t samples) noexcept{
+    size_t i = 0;
+    for(; i + 16 <= samples; i += 16){
+        int8x16x4_t v;
+        v.val[0] = vld1q_s8(src[0] + i);
+        v.val[1] = vld1q_s8(src[1] + i);
+        v.val[2] = vld1q_s8(src[2] + i);
+        v.val[3] = vld1q_s8(src[3] + i);
+        vst4q_s8(dst + i * 4,v);
+    }
+    pack_4ch_scalar(dst,src,i,samples);
+}
+
+static void pack_4ch_16bit_neon(int16_t *dst, const int16_t *const src[4], size_t samples) noexcept{
+    size_t i = 0;
+    for(; i + 8 <= samples; i += 8){
+        int16x8x4_t v;
+        v.val[0] = vld1q_s16(src[0] + i);
+        v.val[1] = vld1q_s16(src[1] + i);
+        v.val[2] = vld1q_s16(src[2] + i);
+        v.val[3] = vld1q_s16(src[3] + i);
+        vst4q_s16(dst + i * 4,v);
+    }
+    pack_4ch_scalar(dst,src,i,samples);
+}
+
+static void narrow_neon(int8_t *dst, const int16_t *src, size_t n, unsigned shift) noexcept{
+    // A negative count makes VSHL shift right
+    int16x8_t s = vdupq_n_s16(-(int16_t)shift);
+    size_t i = 0;
+    for(; i + 16 <= n; i += 16){
+        int8x8_t lo = vqmovn_s16(vshlq_s16(vld1q_s16(src + i),s));
+        int8x8_t hi = vqmovn_s16(vshlq_s16(vld1q_s16(src + i + 8),s));
+        vst1q_s8(dst + i,vcombine_s8(lo,hi));
+    }
+    narrow_scalar(dst,src,i,n,shift);
+}
+
+static void calib_neon(int16_t *dst, const int16_t *src, size_t n, int32_t gain, int32_t bias) noexcept{
+    int16x4_t g = vdup_n_s16((int16_t)gain);
+    int32x4_t b = vdupq_n_s32(bias);
+    size_t i = 0;
+    for(; i + 8 <= n; i += 8){
+        int16x8_t v = vld1q_s16(src + i);
+        int32x4_t lo = vmlal_s16(b,vget_low_s16(v),g);
+        int32x4_t hi = vmlal_s16(b,vget_high_s16(v),g);
+        // Rounding narrowing shift with saturation, same as the scalar code
+        vst1q_s16(dst + i,vcombine_s16(vqrshrn_n_s32(lo,CALIB_SHIFT),vqrshrn_n_s32(hi,CALIB_SHIFT)));
+    }
+    calib_scalar(dst,src,i,n,gain,bias);
+}
+
+#endif // STREAM_KERNELS_NEON
+
+#ifdef STREAM_KERNELS_SSE2
+
+// Even and odd 16 bit elements of two vectors
+static inline void split_16_sse2(__m128i a, __m128i b, __m128i &even, __m128i &odd) noexcept{
+    even = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a,16),16),_mm_srai_epi32(_mm_slli_epi32(b,16),16));
+    odd  = _mm_packs_epi32(_mm_srai_epi32(a,16),_mm_srai_epi32(b,16));
+}
+
+// Even and odd bytes of two vectors
+static inline void split_8_sse2(__m128i a, __m128i b, __m128i &even, __m128i &odd) noexcept{
+    const __m128i mask = _mm_set1_epi16(0x00FF);
+    even = _mm_packus_epi16(_mm_and_si128(a,mask),_mm_and_si128(b,mask));
+    odd  = _mm_packus_epi16(_mm_srli_epi16(a,8),_mm_srli_epi16(b,8));
+}
+
+static void split_2ch_8bit_sse2(int8_t *ch1, int8_t *ch2, const int8_t *src, size_t samples) noexcept{
+    size_t i = 0;
+    for(; i + 16 <= samples; i += 16){
+        __m128i e,o;
+        split_8_sse2(_mm_loadu_si128((const __m128i*)(src + i * 2)),_mm_loadu_si128((const __m128i*)(src + i * 2 + 16)),e,o);
+        _mm_storeu_si128((__m128i*)(ch1 + i),e);
+        _mm_storeu_si128((__m128i*)(ch2 + i),o);
+    }
+    split_2ch_scalar(ch1,ch2,src,i,samples);
+}
+
+static void split_2ch_16bit_sse2(int16_t *ch1, int16_t *ch2, const int16_t *src, size_t samples) noexcept{
+    size_t i = 0;
+    for(; i + 8 <= samples; i += 8){
+        __m128i e,o;
+        split_16_sse2(_mm_loadu_si128((const __m128i*)(src + i * 2)),_mm_loadu_si128((const __m128i*)(src + i * 2 + 8)),e,o);
+        _mm_storeu_si128((__m128i*)(ch1 + i),e);
+        _mm_storeu_si128((__m128i*)(ch2 + i),o);
+    }
+    split_2ch_scalar(ch1,ch2,src,i,samples);
+}
+
+// Four channels are split in two passes: first into ch1/ch3 and ch2/ch4 pairs, then the pairs
+static void split_4ch_8bit_sse2(int8_t *const dst[4], const int8_t *src, size_t samples) noexcept{
+    size_t i = 0;
+    for(; i + 16 <= samples; i += 16){
+        const __m128i *s = (const __m128i*)(src + i * 4);
+        __m128i e0,o0,e1,o1,c1,c2,c3,c4;
+        split_8_sse2(_mm_loadu_si128(s),_mm_loadu_si128(s + 1),e0,o0);
+        split_8_sse2(_mm_loadu_si128(s + 2),_mm_loadu_si128(s + 3),e1,o1);
+        split_8_sse2(e0,e1,c1,c3);
+        split_8_sse2(o0,o1,c2,c4);
+        _mm_storeu_si128((__m128i*)(dst[0] + i),c1);
+        _mm_storeu_si128((__m128i*)(dst[1] + i),c2);
+        _mm_storeu_si128((__m128i*)(dst[2] + i),c3);
+        _mm_storeu_si128((__m128i*)(dst[3] + i),c4);
+    }
+    split_4ch_scalar(dst,src,i,samples);
+}
+
+static void split_4ch_16bit_sse2(int16_t *const dst[4], const int16_t *src, size_t samples) noexcept{
+    size_t i = 0;
+    for(; i + 8 <= samples; i += 8){
+        const __m128i *s = (const __m128i*)(src + i * 4);
+        __m128i e0,o0,e1,o1,c1,c2,c3,c4;
+        split_16_sse2(_mm_loadu_si128(s),_mm_loadu_si128(s + 1),e0,o0);
+        split_16_sse2(_mm_loadu_si128(s + 2),_mm_loadu_si128(s + 3),e1,o1);
+        split_16_sse2(e0,e1,c1,c3);
+        split_16_sse2(o0,o1,c2,c4);
+        _mm_storeu_si128((__m128i*)(dst[0] + i),c1);
+        _mm_storeu_si128((__m128i*)(dst[1] + i),c2);
+        _mm_storeu_si128((__m128i*)(dst[2] + i),c3);
+        _mm_storeu_si128((__m128i*)(dst[3] + i),c4);
+    }
+    split_4ch_scalar(dst,src,i,samples);
+}
+
+static void pack_2ch_8bit_sse2(int8_t *dst, const int8_t *ch1, const int8_t *ch2, size_t samples) noexcept{
+    size_t i = 0;
+    for(; i + 16 <= samples; i += 16){
+        __m128i a = _mm_loadu_si128((const __m128i*)(ch1 + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(ch2 + i));
+        _mm_storeu_si128((__m128i*)(dst + i * 2),_mm_unpacklo_epi8(a,b));
+        _mm_storeu_si128((__m128i*)(dst + i * 2 + 16),_mm_unpackhi_epi8(a,b));
+    }
+    pack_2ch_scalar(dst,ch1,ch2,i,samples);
+}
+
+static void pack_2ch_16bit_sse2(int16_t *dst, const int16_t *ch1, const int16_t *ch2, size_t samples) noexcept{
+    size_t i = 0;
+    for(; i + 8 <= samples; i += 8){
+        __m128i a = _mm_loadu_si128((const __m128i*)(ch1 + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(ch2 + i));
+        _mm_storeu_si128((__m128i*)(dst + i * 2),_mm_unpacklo_epi16(a,b));
+        _mm_storeu_si128((__m128i*)(dst + i * 2 + 8),_mm_unpackhi_epi16(a,b));
+    }
+    pack_2ch_scalar(dst,ch1,ch2,i,samples);
+}
+
+static void pack_4ch_8bit_sse2(int8_t *dst, const int8_t *const src[4], size_t samples) noexcept{
+    size_t i = 0;
+    for(; i + 16 <= samples; i += 16){
+        __m128i a = _mm_loadu_si128((const __m128i*)(src[0] + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(src[1] + i));
+        __m128i c = _mm_loadu_si128((const __m128i*)(src[2] + i));
+        __m128i d = _mm_loadu_si128((const __m128i*)(src[3] + i));
+        __m128i ab_lo = _mm_unpacklo_epi8(a,b);
+        __m128i ab_hi = _mm_unpackhi_epi8(a,b);
+        __m128i cd_lo = _mm_unpacklo_epi8(c,d);
+        __m128i cd_hi = _mm_unpackhi_epi8(c,d);
+        __m128i *o = (__m128i*)(dst + i * 4);
+        _mm_storeu_si128(o,    _mm_unpacklo_epi16(ab_lo,cd_lo));
+        _mm_storeu_si128(o + 1,_mm_unpackhi_epi16(ab_lo,cd_lo));
+        _mm_storeu_si128(o + 2,_mm_unpacklo_epi16(ab_hi,cd_hi));
+        _mm_storeu_si128(o + 3,_mm_unpackhi_epi16(ab_hi,cd_hi));
+    }
+    pack_4ch_scalar(dst,src,i,samples);
+}
+
+static void pack_4ch_16bit_sse2(int16_t *dst, const int16_t *const src[4], size_t samples) noexcept{
+    size_t i = 0;
+    for(; i + 8 <= samples; i += 8){
+        __m128i a = _mm_loadu_si128((const __m128i*)(src[0] + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(src[1] + i));
+        __m128i c = _mm_loadu_si128((const __m128i*)(src[2] + i));
+        __m128i d = _mm_loadu_si128((const __m128i*)(src[3] + i));
+        __m128i ab_lo = _mm_unpacklo_epi16(a,b);
+        __m128i ab_hi = _mm_unpackhi_epi16(a,b);
+        __m128i cd_lo = _mm_unpacklo_epi16(c,d);
+        __m128i cd_hi = _mm_unpackhi_epi16(c,d);
+        __m128i *o = (__m128i*)(dst + i * 4);
+        _mm_storeu_si128(o,    _mm_unpacklo_epi32(ab_lo,cd_lo));
+        _mm_storeu_si128(o + 1,_mm_unpackhi_epi32(ab_lo,cd_lo));
+        _mm_storeu_si128(o + 2,_mm_unpacklo_epi32(ab_hi,cd_hi));
+        _mm_storeu_si128(o + 3,_mm_unpackhi_epi32(ab_hi,cd_hi));
+    }
+    pack_4ch_scalar(dst,src,i,samples);
+}
+
+static void narrow_sse2(int8_t *dst, const int16_t *src, size_t n, unsigned shift) noexcept{
+    __m128i s = _mm_cvtsi32_si128((int)shift);
+    size_t i = 0;
+    for(; i + 16 <= n; i += 16){
+        __m128i lo = _mm_sra_epi16(_mm_loadu_si128((const __m128i*)(src + i)),s);
+        __m128i hi = _mm_sra_epi16(_mm_loadu_si128((const __m128i*)(src + i + 8)),s);
+        _mm_storeu_si128((__m128i*)(dst + i),_mm_packs_epi16(lo,hi));
+    }
+    narrow_scalar(dst,src,i,n,shift);
+}
+
+static void calib_sse2(int16_t *dst, const int16_t *src, size_t n, int32_t gain, int32_t bias) noexcept{
+    __m128i g = _mm_set1_epi16((int16_t)gain);
+    __m128i b = _mm_set1_epi32(bias + (1 << (CALIB_SHIFT - 1)));
+    size_t i = 0;
+    for(; i + 8 <= n; i += 8){
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        // Full 32 bit products from the low and high halves
+        __m128i pl = _mm_mullo_epi16(v,g);
+        __m128i ph = _mm_mulhi_epi16(v,g);
+        __m128i lo = _mm_srai_epi32(_mm_add_epi32(_mm_unpacklo_epi16(pl,ph),b),CALIB_SHIFT);
+        __m128i hi = _mm_srai_epi32(_mm_add_epi32(_mm_unpackhi_epi16(pl,ph),b),CALIB_SHIFT);
+        _mm_storeu_si128((__m128i*)(dst + i),_mm_packs_epi32(lo,hi));
+    }
+    calib_scalar(dst,src,i,n,gain,bias);
+}
+
+#endif // STREAM_KERNELS_SSE2
+
+static inline EVoltConvertPath resolve_path(EVoltConvertPath path) noexcept{
+    if (path == VCP_AUTO)
+        path = convert_to_volt_best_path();
+    if (path == VCP_AVX2)
+        path = VCP_SSE2;
+    return convert_to_volt_path_supported(path) ? path : VCP_SCALAR;
+}
+
+void split_2ch_8bit(int8_t *ch1, int8_t *ch2, const int8_t *src, size_t samples, EVoltConvertPath path) noexcept{
+    switch(resolve_path(path)){
+#ifdef STREAM_KERNELS_NEON
+        case VCP_NEON: split_2ch_8bit_neon(ch1,ch2,src,samples); return;
+#endif
+#ifdef STREAM_KERNELS_SSE2
+        case VCP_SSE2: split_2ch_8bit_sse2(ch1,ch2,src,samples); return;
+#endif
+        default:
+            split_2ch_scalar(ch1,ch2,src,0,samples);
+    }
+}
+
+void split_2ch_16bit(int16_t *ch1, int16_t *ch2, const int16_t *src, size_t samples, EVoltConvertPath path) noexcept{
+    switch(resolve_path(path)){
+#ifdef STREAM_KERNELS_NEON
+        case VCP_NEON: split_2ch_16bit_neon(ch1,ch2,src,samples); return;
+#endif
+#ifdef STREAM_KERNELS_SSE2
+        case VCP_SSE2: split_2ch_16bit_sse2(ch1,ch2,src,samples); return;
+#endif
+        default:
+            split_2ch_scalar(ch1,ch2,src,0,samples);
+    }
+}
+
+void split_4ch_8bit(int8_t *const dst[4], const int8_t *src, size_t samples, EVoltConvertPath path) noexcept{
+    switch(resolve_path(path)){
+#ifdef STREAM_KERNELS_NEON
+        case VCP_NEON: split_4ch_8bit_neon(dst,src,samples); return;
+#endif
+#ifdef STREAM_KERNELS_SSE2
+        case VCP_SSE2: split_4ch_8bit_sse2(dst,src,samples); return;
+#endif
+        default:
+            split_4ch_scalar(dst,src,0,samples);
+    }
+}
+
+void split_4ch_16bit(int16_t *const dst[4], const int16_t *src, size_t samples, EVoltConvertPath path) noexcept{
+    switch(resolve_path(path)){
+#ifdef STREAM_KERNELS_NEON
+        case VCP_NEON: split_4ch_16bit_neon(dst,src,samples); return;
+#endif
+#ifdef STREAM_KERNELS_SSE2
+        case VCP_SSE2: split_4ch_16bit_sse2(dst,src,samples); return;
+#endif
+        default:
+            split_4ch_scalar(dst,src,0,samples);
+    }
+}
+
+void pack_2ch_8bit(int8_t *dst, const int8_t *ch1, const int8_t *ch2, size_t samples, EVoltConvertPath path) noexcept{
+    switch(resolve_path(path)){
+#ifdef STREAM_KERNELS_NEON
+        case VCP_NEON: pack_2ch_8bit_neon(dst,ch1,ch2,samples); return;
+#endif
+#ifdef STREAM_KERNELS_SSE2
+        case VCP_SSE2: pack_2ch_8bit_sse2(dst,ch1,ch2,samples); return;
+#endif
+        default:
+            pack_2ch_scalar(dst,ch1,ch2,0,samples);
+    }
+}
+
+void pack_2ch_16bit(int16_t *dst, const int16_t *ch1, const int16_t *ch2, size_t samples, EVoltConvertPath path) noexcept{
+    switch(resolve_path(path)){
+#ifdef STREAM_KERNELS_NEON
+        case VCP_NEON: pack_2ch_16bit_neon(dst,ch1,ch2,samples); return;
+#endif
+#ifdef STREAM_KERNELS_SSE2
+        case VCP_SSE2: pack_2ch_16bit_sse2(dst,ch1,ch2,samples); return;
+#endif
+        default:
+            pack_2ch_scalar(dst,ch1,ch2,0,samples);
+    }
+}
+
+void pack_4ch_8bit(int8_t *dst, const int8_t *const src[4], size_t samples, EVoltConvertPath path) noexcept{
+    switch(resolve_path(path)){
+#ifdef STREAM_KERNELS_NEON
+        case VCP_NEON: pack_4ch_8bit_neon(dst,src,samples); return;
+#endif
+#ifdef STREAM_KERNELS_SSE2
+        case VCP_SSE2: pack_4ch_8bit_sse2(dst,src,samples); return;
+#endif
+        default:
+            pack_4ch_scalar(dst,src,0,samples);
+    }
+}
+
+void pack_4ch_16bit(int16_t *dst, const int16_t *const src[4], size_t samples, EVoltConvertPath path) noexcept{
+    switch(resolve_path(path)){
+#ifdef STREAM_KERNELS_NEON
+        case VCP_NEON: pack_4ch_16bit_neon(dst,src,samples); return;
+#endif
+#ifdef STREAM_KERNELS_SSE2
+        case VCP_SSE2: pack_4ch_16bit_sse2(dst,src,samples); return;
+#endif
+        default:
+            pack_4ch_scalar(dst,src,0,samples);
+    }
+}
+
+void narrow_16_to_8bit(int8_t *dst, const int16_t *src, size_t n, unsigned shift, EVoltConvertPath path) noexcept{
+    if (shift > 15)
+        shift = 15;
+    switch(resolve_path(path)){
+#ifdef STREAM_KERNELS_NEON
+        case VCP_NEON: narrow_neon(dst,src,n,shift); return;
+#endif
+#ifdef STREAM_KERNELS_SSE2
+        case VCP_SSE2: narrow_sse2(dst,src,n,shift); return;
+#endif
+        default:
+            narrow_scalar(dst,src,0,n,shift);
+    }
+}
+
+void calib_16bit(int16_t *dst, const int16_t *src, size_t n, float gain, int32_t offset, EVoltConvertPath path) noexcept{
+    // Gain in Q14 and offset within int16 keep src * gain + bias inside int32
+    float q = gain * (float)(1 << CALIB_SHIFT) + 0.5f;
+    int32_t g = q < 0 ? 0 : (q > 32767.f ? 32767 : (int32_t)q);
+    int32_t o = offset > 32767 ? 32767 : (offset < -32767 ? -32767 : offset);
+    int32_t bias = o * g;
+    switch(resolve_path(path)){
+#ifdef STREAM_KERNELS_NEON
+        case VCP_NEON: calib_neon(dst,src,n,g,bias); return;
+#endif
+#ifdef STREAM_KERNELS_SSE2
+        case VCP_SSE2: calib_sse2(dst,src,n,g,bias); return;
+#endif
+        default:
+            calib_scalar(dst,src,0,n,g,bias);
+    }
+}
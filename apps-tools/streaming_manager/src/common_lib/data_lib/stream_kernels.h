@@ -0,0 +1,31 @@
+#ifndef DATA_LIB_STREAM_KERNELS_H
+#define DATA_LIB_STREAM_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "volt_convert.h"
+
+// Sample loops shared by the streaming modes. The path argument works as in
+// volt_convert.h. There are no AVX2 variants, VCP_AVX2 runs the SSE2 code
+
+// Interleaved frames to separate channels. samples is the count per channel
+void split_2ch_8bit(int8_t *ch1, int8_t *ch2, const int8_t *src, size_t samples, EVoltConvertPath path = VCP_AUTO) noexcept;
+void split_2ch_16bit(int16_t *ch1, int16_t *ch2, const int16_t *src, size_t samples, EVoltConvertPath path = VCP_AUTO) noexcept;
+void split_4ch_8bit(int8_t *const dst[4], const int8_t *src, size_t samples, EVoltConvertPath path = VCP_AUTO) noexcept;
+void split_4ch_16bit(int16_t *const dst[4], const int16_t *src, size_t samples, EVoltConvertPath path = VCP_AUTO) noexcept;
+
+// Separate channels to interleaved frames
+void pack_2ch_8bit(int8_t *dst, const int8_t *ch1, const int8_t *ch2, size_t samples, EVoltConvertPath path = VCP_AUTO) noexcept;
+void pack_2ch_16bit(int16_t *dst, const int16_t *ch1, const int16_t *ch2, size_t samples, EVoltConvertPath path = VCP_AUTO) noexcept;
+void pack_4ch_8bit(int8_t *dst, const int8_t *const src[4], size_t samples, EVoltConvertPath path = VCP_AUTO) noexcept;
+void pack_4ch_16bit(int16_t *dst, const int16_t *const src[4], size_t samples, EVoltConvertPath path = VCP_AUTO) noexcept;
+
+// dst[i] = src[i] >> shift, saturated to int8. shift 8 keeps the high byte
+void narrow_16_to_8bit(int8_t *dst, const int16_t *src, size_t n, unsigned shift, EVoltConvertPath path = VCP_AUTO) noexcept;
+
+// dst[i] = (src[i] + offset) * gain, rounded and saturated to int16.
+// gain is limited to [0, 2) with 1/16384 steps, offset to the int16 range
+void calib_16bit(int16_t *dst, const int16_t *src, size_t n, float gain, int32_t offset, EVoltConvertPath path = VCP_AUTO) noexcept;
+
+#endif
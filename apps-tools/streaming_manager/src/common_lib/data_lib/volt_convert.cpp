@@ -0,0 +1,203 @@
+#include "volt_convert.h"
+
+#ifdef ARCH_ARM
+#include <arm_neon.h>
+#define VOLT_CONVERT_NEON
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#include <emmintrin.h>
+#define VOLT_CONVERT_SSE2
+#if defined(__GNUC__)
+#include <immintrin.h>
+#define VOLT_CONVERT_AVX2
+#endif
+#endif
+
+template<typename T>
+static inline void convert_scalar(float *dst, const T *src, size_t n, float gain, float offset) noexcept{
+    for(size_t i = 0; i < n; i++){
+        dst[i] = (float)src[i] * gain + offset;
+    }
+}
+
+#ifdef VOLT_CONVERT_NEON
+
+static inline void store_neon_s16(float *dst, int16x8_t v, float32x4_t gain, float32x4_t offset) noexcept{
+    float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(v)));
+    float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(v)));
+    vst1q_f32(dst,     vaddq_f32(vmulq_f32(lo,gain),offset));
+    vst1q_f32(dst + 4, vaddq_f32(vmulq_f32(hi,gain),offset));
+}
+
+static void convert_8bit_neon(float *dst, const int8_t *src, size_t n, float gain, float offset) noexcept{
+    float32x4_t g = vdupq_n_f32(gain);
+    float32x4_t o = vdupq_n_f32(offset);
+    size_t i = 0;
+    for(; i + 16 <= n; i += 16){
+        int8x16_t v = vld1q_s8(src + i);
+        store_neon_s16(dst + i,     vmovl_s8(vget_low_s8(v)),g,o);
+        store_neon_s16(dst + i + 8, vmovl_s8(vget_high_s8(v)),g,o);
+    }
+    convert_scalar(dst + i,src + i,n - i,gain,offset);
+}
+
+static void convert_16bit_neon(float *dst, const int16_t *src, size_t n, float gain, float offset) noexcept{
+    float32x4_t g = vdupq_n_f32(gain);
+    float32x4_t o = vdupq_n_f32(offset);
+    size_t i = 0;
+    for(; i + 8 <= n; i += 8){
+        store_neon_s16(dst + i,vld1q_s16(src + i),g,o);
+    }
+    convert_scalar(dst + i,src + i,n - i,gain,offset);
+}
+
+#endif // VOLT_CONVERT_NEON
+
+#ifdef VOLT_CONVERT_SSE2
+
+static inline void store_sse2_s16(float *dst, __m128i v, __m128 gain, __m128 offset) noexcept{
+    // Sign extend by placing the sample in the upper half and shifting back
+    __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v,v),16);
+    __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v,v),16);
+    _mm_storeu_ps(dst,     _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(lo),gain),offset));
+    _mm_storeu_ps(dst + 4, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(hi),gain),offset));
+}
+
+static void convert_8bit_sse2(float *dst, const int8_t *src, size_t n, float gain, float offset) noexcept{
+    __m128 g = _mm_set1_ps(gain);
+    __m128 o = _mm_set1_ps(offset);
+    size_t i = 0;
+    for(; i + 16 <= n; i += 16){
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        store_sse2_s16(dst + i,     _mm_srai_epi16(_mm_unpacklo_epi8(v,v),8),g,o);
+        store_sse2_s16(dst + i + 8, _mm_srai_epi16(_mm_unpackhi_epi8(v,v),8),g,o);
+    }
+    convert_scalar(dst + i,src + i,n - i,gain,offset);
+}
+
+static void convert_16bit_sse2(float *dst, const int16_t *src, size_t n, float gain, float offset) noexcept{
+    __m128 g = _mm_set1_ps(gain);
+    __m128 o = _mm_set1_ps(offset);
+    size_t i = 0;
+    for(; i + 8 <= n; i += 8){
+        store_sse2_s16(dst + i,_mm_loadu_si128((const __m128i*)(src + i)),g,o);
+    }
+    convert_scalar(dst + i,src + i,n - i,gain,offset);
+}
+
+#endif // VOLT_CONVERT_SSE2
+
+#ifdef VOLT_CONVERT_AVX2
+
+// Built for AVX2 regardless of the global flags, selected at runtime
+__attribute__((target("avx2")))
+static void convert_8bit_avx2(float *dst, const int8_t *src, size_t n, float gain, float offset) noexcept{
+    __m256 g = _mm256_set1_ps(gain);
+    __m256 o = _mm256_set1_ps(offset);
+    size_t i = 0;
+    for(; i + 8 <= n; i += 8){
+        __m256i v = _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)(src + i)));
+        _mm256_storeu_ps(dst + i,_mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(v),g),o));
+    }
+    convert_scalar(dst + i,src + i,n - i,gain,offset);
+}
+
+__attribute__((target("avx2")))
+static void convert_16bit_avx2(float *dst, const int16_t *src, size_t n, float gain, float offset) noexcept{
+    __m256 g = _mm256_set1_ps(gain);
+    __m256 o = _mm256_set1_ps(offset);
+    size_t i = 0;
+    for(; i + 8 <= n; i += 8){
+        __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i)));
+        _mm256_storeu_ps(dst + i,_mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(v),g),o));
+    }
+    convert_scalar(dst + i,src + i,n - i,gain,offset);
+}
+
+#endif // VOLT_CONVERT_AVX2
+
+bool convert_to_volt_path_supported(EVoltConvertPath path) noexcept{
+    switch(path){
+        case VCP_AUTO:
+        case VCP_SCALAR:
+            return true;
+#ifdef VOLT_CONVERT_NEON
+        case VCP_NEON:
+            return true;
+#endif
+#ifdef VOLT_CONVERT_SSE2
+        case VCP_SSE2:
+            return true;
+#endif
+#ifdef VOLT_CONVERT_AVX2
+        case VCP_AVX2:{
+            static const bool avx2 = __builtin_cpu_supports("avx2");
+            return avx2;
+        }
+#endif
+        default:
+            return false;
+    }
+}
+
+EVoltConvertPath convert_to_volt_best_path() noexcept{
+    static const EVoltConvertPath best = []{
+        const EVoltConvertPath order[] = {VCP_AVX2, VCP_SSE2, VCP_NEON};
+        for(auto p : order){
+            if (convert_to_volt_path_supported(p))
+                return p;
+        }
+        return VCP_SCALAR;
+    }();
+    return best;
+}
+
+const char* convert_to_volt_path_name(EVoltConvertPath path) noexcept{
+    switch(path){
+        case VCP_AUTO:   return "auto";
+        case VCP_SCALAR: return "scalar";
+        case VCP_NEON:   return "neon";
+        case VCP_SSE2:   return "sse2";
+        case VCP_AVX2:   return "avx2";
+    }
+    return "unknown";
+}
+
+static inline EVoltConvertPath resolve_path(EVoltConvertPath path) noexcept{
+    if (path == VCP_AUTO)
+        return convert_to_volt_best_path();
+    return convert_to_volt_path_supported(path) ? path : VCP_SCALAR;
+}
+
+void convert_to_volt_8bit(float *dst, const int8_t *src, size_t n, float gain, float offset, EVoltConvertPath path) noexcept{
+    switch(resolve_path(path)){
+#ifdef VOLT_CONVERT_NEON
+        case VCP_NEON: convert_8bit_neon(dst,src,n,gain,offset); return;
+#endif
+#ifdef VOLT_CONVERT_SSE2
+        case VCP_SSE2: convert_8bit_sse2(dst,src,n,gain,offset); return;
+#endif
+#ifdef VOLT_CONVERT_AVX2
+        case VCP_AVX2: convert_8bit_avx2(dst,src,n,gain,offset); return;
+#endif
+        default:
+            convert_scalar(dst,src,n,gain,offset);
+    }
+}
+
+void convert_to_volt_16bit(float *dst, const int16_t *src, size_t n, float gain, float offset, EVoltConvertPath path) noexcept{
+    switch(resolve_path(path)){
+#ifdef VOLT_CONVERT_NEON
+        case VCP_NEON: convert_16bit_neon(dst,src,n,gain,offset); return;
+#endif
+#ifdef VOLT_CONVERT_SSE2
+        case VCP_SSE2: convert_16bit_sse2(dst,src,n,gain,offset); return;
+#endif
+#ifdef VOLT_CONVERT_AVX2
+        case VCP_AVX2: convert_16bit_avx2(dst,src,n,gain,offset); return;
+#endif
+        default:
+            convert_scalar(dst,src,n,gain,offset);
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef DATA_LIB_VOLT_CONVERT_H
+#define DATA_LIB_VOLT_CONVERT_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Converts raw ADC samples to volts: dst[i] = src[i] * gain + offset
+
+enum EVoltConvertPath{
+    VCP_AUTO   = 0,
+    VCP_SCALAR = 1,
+    VCP_NEON   = 2,
+    VCP_SSE2   = 3,
+    VCP_AVX2   = 4
+};
+
+// The fastest path available on the running CPU
+EVoltConvertPath convert_to_volt_best_path() noexcept;
+bool convert_to_volt_path_supported(EVoltConvertPath path) noexcept;
+const char* convert_to_volt_path_name(EVoltConvertPath path) noexcept;
+
+// Unsupported paths fall back to the scalar code
+void convert_to_volt_8bit(float *dst, const int8_t *src, size_t n, float gain, float offset, EVoltConvertPath path = VCP_AUTO) noexcept;
+void convert_to_volt_16bit(float *dst, const int16_t *src, size_t n, float gain, float offset, EVoltConvertPath path = VCP_AUTO) noexcept;
+
+#endif
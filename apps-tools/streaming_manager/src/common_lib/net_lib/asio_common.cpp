@@ -10,6 +10,133 @@ using namespace net_lib;
 constexpr uint8_t net_lib::ID_PACK[]        = {0xFF,0xFF,0xFF,0xFF,0xA0,0xA0,0xA0,0xA0,0xFF,0xFF,0xFF,0xFF,0xA0,0xA0,0xA0,0xA0};
 constexpr uint8_t net_lib::ID_PACK_END[]    = {0xFF,0xFF,0xFF,0xFF,0x50,0x50,0x50,0x50,0xFF,0xFF,0xFF,0xFF,0x50,0x50,0x50,0x50};
 constexpr uint8_t net_lib::ID_BUFFER[]      = {0xFF,0xFF,0xFF,0xFF,0x0A,0x0A,0x0A,0x0A,0xFF,0xFF,0xFF,0xFF,0x0A,0x0A,0x0A,0x0A};
+constexpr uint8_t net_lib::ID_FRAME_V2[]    = {0xFF,0xA5,0x52,0x32};
+
+/*
+ * v2 frame layout (host byte order, no padding):
+ *   SFrameHeaderV2                     17 bytes
+ *   BEGIN : SBeginPackV2                9 bytes
+ *   BUFFER: SBufferPackV2               3 bytes
+ *           varint packOrder, lostFPGA, lostINTERNAL
+ *           samples up to header.length
+ *   END   : nothing
+ * The sequence is counted per connection over all frames, so the receiver can
+ * see lost datagrams even when whole packs are missing.
+ */
+enum EFrameTypeV2 : uint8_t {
+    FT_BEGIN  = 1,
+    FT_BUFFER = 2,
+    FT_END    = 3
+};
+
+#pragma pack(push, 1)
+struct SFrameHeaderV2{
+    uint8_t  magic[4];
+    uint32_t length;
+    uint32_t sequence;
+    uint32_t packId;
+    uint8_t  type;
+};
+
+struct SBeginPackV2{
+    uint32_t oscRate;
+    uint8_t  adcBits;
+    uint32_t buffersSize;
+};
+
+struct SBufferPackV2{
+    uint8_t  channel;
+    uint8_t  adcMode;
+    uint8_t  bitBySample;
+};
+#pragma pack(pop)
+
+#define V2_VARINT_MAX 10
+
+static auto putVarint(uint8_t *_buffer,uint64_t _value) -> size_t{
+    size_t pos = 0;
+    while(_value >= 0x80){
+        _buffer[pos++] = (uint8_t)(_value | 0x80);
+        _value >>= 7;
+    }
+    _buffer[pos++] = (uint8_t)_value;
+    return pos;
+}
+
+static auto getVarint(const uint8_t *_buffer,size_t _length,uint64_t *_value) -> size_t{
+    uint64_t value = 0;
+    for(size_t pos = 0; pos < _length && pos < V2_VARINT_MAX; pos++){
+        value |= (uint64_t)(_buffer[pos] & 0x7F) << (7 * pos);
+        if (!(_buffer[pos] & 0x80)){
+            *_value = value;
+            return pos + 1;
+        }
+    }
+    return 0;
+}
+
+static auto isFrameV2(const uint8_t* _buffer,size_t _length) -> bool{
+    return _length >= sizeof(SFrameHeaderV2) && memcmp(_buffer,net_lib::ID_FRAME_V2,sizeof(net_lib::ID_FRAME_V2)) == 0;
+}
+
+static auto readHeaderV2(const uint8_t* _buffer,size_t _length,uint8_t _type,SFrameHeaderV2 *_header) -> bool{
+    if (!isFrameV2(_buffer,_length)){
+        return false;
+    }
+    memcpy(_header,_buffer,sizeof(SFrameHeaderV2));
+    return _header->type == _type && _header->length <= _length;
+}
+
+static auto initHeaderV2(AsioBufferNolder &bh,uint8_t _type,uint64_t _id,uint32_t *_sequence) -> SFrameHeaderV2{
+    bh.headerLen = 0;
+    bh.dataPtr = nullptr;
+    bh.dataLen = 0;
+    bh.buffPackOwner = nullptr;
+
+    SFrameHeaderV2 header;
+    memcpy(header.magic,net_lib::ID_FRAME_V2,sizeof(header.magic));
+    header.length = 0;
+    header.sequence = (*_sequence)++;
+    header.packId = (uint32_t)_id;
+    header.type = _type;
+    return header;
+}
+
+auto net_lib::detectFrame(const uint8_t* _buffer,size_t _length,uint32_t *_frameSize) -> bool{
+    *_frameSize = 0;
+    if (_length >= sizeof(ID_FRAME_V2) && memcmp(_buffer,ID_FRAME_V2,sizeof(ID_FRAME_V2)) == 0){
+        if (_length >= sizeof(ID_FRAME_V2) + sizeof(uint32_t)){
+            uint32_t size = 0;
+            memcpy(&size,_buffer + sizeof(ID_FRAME_V2),sizeof(uint32_t));
+            if (size < sizeof(SFrameHeaderV2))
+                return false;
+            *_frameSize = size;
+        }
+        return true;
+    }
+
+    if (_length >= 16 && (memcmp(_buffer,ID_PACK,16) == 0 || memcmp(_buffer,ID_PACK_END,16) == 0 || memcmp(_buffer,ID_BUFFER,16) == 0)){
+        if (_length >= 16 + sizeof(uint64_t)){
+            uint64_t size = 0;
+            memcpy(&size,_buffer + 16,sizeof(uint64_t));
+            if (size < 16 + sizeof(uint64_t))
+                return false;
+            *_frameSize = (uint32_t)size;
+        }
+        return true;
+    }
+    return false;
+}
+
+auto net_lib::extractSequence(const uint8_t* _buffer,size_t _length,uint32_t *_sequence) -> bool{
+    if (!isFrameV2(_buffer,_length)){
+        return false;
+    }
+    SFrameHeaderV2 header;
+    memcpy(&header,_buffer,sizeof(SFrameHeaderV2));
+    *_sequence = header.sequence;
+    return true;
+}
 
 auto net_lib::createBuffer(const char *buffer,size_t size) -> net_buffer{
     try{
@@ -61,7 +188,42 @@ auto createBeginPack(uint64_t _id,DataLib::CDataBuffersPack::Ptr pack) -> AsioBu
     }
 }
 
+auto createBeginPackV2(uint64_t _id,DataLib::CDataBuffersPack::Ptr pack,uint32_t *_sequence) -> AsioBufferNolder{
+    AsioBufferNolder bh;
+    auto header = initHeaderV2(bh,FT_BEGIN,_id,_sequence);
+    SBeginPackV2 begin;
+    begin.oscRate = pack->getOSCRate();
+    begin.adcBits = pack->getADCBits();
+    begin.buffersSize = pack->getLenghtAllBuffers();
+    header.length = sizeof(SFrameHeaderV2) + sizeof(SBeginPackV2);
+    memcpy(bh.header,&header,sizeof(SFrameHeaderV2));
+    memcpy(bh.header + sizeof(SFrameHeaderV2),&begin,sizeof(SBeginPackV2));
+    bh.headerLen = header.length;
+    return bh;
+}
+
+auto extractBeginPackV2(uint8_t* _buffer,size_t _length,uint64_t *_id,size_t *_allBuffersSize) -> DataLib::CDataBuffersPack::Ptr{
+    SFrameHeaderV2 header;
+    SBeginPackV2 begin;
+    if (!readHeaderV2(_buffer,_length,FT_BEGIN,&header) || header.length < sizeof(SFrameHeaderV2) + sizeof(SBeginPackV2)){
+        return nullptr;
+    }
+    memcpy(&begin,_buffer + sizeof(SFrameHeaderV2),sizeof(SBeginPackV2));
+
+    auto pack = DataLib::CDataBuffersPack::Create();
+    pack->setADCBits(begin.adcBits);
+    pack->setOSCRate(begin.oscRate);
+
+    *_id = header.packId;
+    *_allBuffersSize = begin.buffersSize;
+    return pack;
+}
+
 auto net_lib::extractBeginPack(uint8_t* _buffer,size_t _length,uint64_t *_id,size_t *_allBuffersSize) -> DataLib::CDataBuffersPack::Ptr{
+    if (isFrameV2(_buffer,_length)){
+        return extractBeginPackV2(_buffer,_length,_id,_allBuffersSize);
+    }
+
     if (_length < 20){ // ID + buff_size attribute
         return  nullptr;
     }
@@ -116,7 +278,25 @@ auto createEndPack(uint64_t _id) -> AsioBufferNolder{
 }
 
 
+auto createEndPackV2(uint64_t _id,uint32_t *_sequence) -> AsioBufferNolder{
+    AsioBufferNolder bh;
+    auto header = initHeaderV2(bh,FT_END,_id,_sequence);
+    header.length = sizeof(SFrameHeaderV2);
+    memcpy(bh.header,&header,sizeof(SFrameHeaderV2));
+    bh.headerLen = header.length;
+    return bh;
+}
+
 auto net_lib::extractEndPack(uint8_t* _buffer,size_t _length,uint64_t *_id) -> bool{
+    if (isFrameV2(_buffer,_length)){
+        SFrameHeaderV2 header;
+        if (!readHeaderV2(_buffer,_length,FT_END,&header)){
+            return false;
+        }
+        *_id = header.packId;
+        return true;
+    }
+
     if (_length < 20){ // ID + buff_size attribute
         return  false;
     }
@@ -238,44 +418,132 @@ auto createEmptyBufferPack(uint64_t _id,DataLib::EDataBuffersPackChannel channel
     return list;
 }
 
-auto net_lib::extractBufferPack(uint8_t* _buffer,size_t _length,uint64_t *_id,uint64_t *_packOrder,DataLib::EDataBuffersPackChannel *_channel) -> DataLib::CDataBuffer::Ptr{
+auto createBufferPackV2(uint64_t _id,DataLib::EDataBuffersPackChannel channel,DataLib::CDataBuffer::Ptr buffer,size_t split,uint32_t *_sequence) -> net_list_bh{
+    net_list_bh list;
+
+    SBufferPackV2 info;
+    info.channel = (uint8_t)channel;
+    info.adcMode = (uint8_t)buffer->getADCMode();
+    info.bitBySample = (uint8_t)buffer->getBitBySample();
+    uint64_t lostFPGA = buffer->getLostSamples(DataLib::FPGA);
+    uint64_t lostINTERNAL = buffer->getLostSamples(DataLib::RP_INTERNAL_BUFFER);
+
+    auto lenght = buffer->getBufferLenght();
+    uint64_t packOrder = 0;
+    size_t bufferOffset = 0;
+    do{
+        AsioBufferNolder bh;
+        auto header = initHeaderV2(bh,FT_BUFFER,_id,_sequence);
+        auto calcCopyLen = bufferOffset + split > lenght ? lenght - bufferOffset : split;
+
+        size_t prefix_size = sizeof(SFrameHeaderV2);
+        memcpy(bh.header + prefix_size,&info,sizeof(SBufferPackV2));
+        prefix_size += sizeof(SBufferPackV2);
+        prefix_size += putVarint(bh.header + prefix_size,packOrder++);
+        prefix_size += putVarint(bh.header + prefix_size,lostFPGA);
+        prefix_size += putVarint(bh.header + prefix_size,lostINTERNAL);
+
+        header.length = prefix_size + calcCopyLen;
+        memcpy(bh.header,&header,sizeof(SFrameHeaderV2));
+
+        bh.headerLen = prefix_size;
+        if (calcCopyLen){
+            bh.dataPtr = buffer->getBuffer().get() + bufferOffset;
+            bh.dataLen = calcCopyLen;
+            bh.buffPackOwner = buffer;
+        }
+        list.push_back(bh);
+        bufferOffset += split;
+    }while(bufferOffset < lenght);
+    return list;
+}
+
+auto extractBufferPackInfoV2(const uint8_t* _buffer,size_t _length,SBufferPackInfo *_info) -> bool{
+    SFrameHeaderV2 header;
+    SBufferPackV2 info;
+    if (!readHeaderV2(_buffer,_length,FT_BUFFER,&header) || header.length < sizeof(SFrameHeaderV2) + sizeof(SBufferPackV2)){
+        return false;
+    }
+    size_t prefix_size = sizeof(SFrameHeaderV2);
+    memcpy(&info,_buffer + prefix_size,sizeof(SBufferPackV2));
+    prefix_size += sizeof(SBufferPackV2);
+
+    uint64_t values[3];
+    for(auto &v : values){
+        auto size = getVarint(_buffer + prefix_size,header.length - prefix_size,&v);
+        if (!size){
+            return false;
+        }
+        prefix_size += size;
+    }
+
+    _info->id = header.packId;
+    _info->packOrder = values[0];
+    _info->channel = (DataLib::EDataBuffersPackChannel)info.channel;
+    _info->adcMode = (DataLib::CDataBuffer::ADC_MODE)info.adcMode;
+    _info->bitBySample = info.bitBySample;
+    _info->lostFPGA = values[1];
+    _info->lostINTERNAL = values[2];
+    _info->data = _buffer + prefix_size;
+    _info->dataSize = header.length - prefix_size;
+    return true;
+}
+
+auto net_lib::extractBufferPackInfo(const uint8_t* _buffer,size_t _length,SBufferPackInfo *_info) -> bool{
+    if (isFrameV2(_buffer,_length)){
+        return extractBufferPackInfoV2(_buffer,_length,_info);
+    }
+
     if (_length < 20){ // ID + buff_size attribute
-        return  nullptr;
+        return  false;
     }
 
     for(size_t i = 0 ;i < _length && i < 16; i++){
         if (net_lib::ID_BUFFER[i] != _buffer[i]){
-            return nullptr;
+            return false;
         }
     }
 
-    uint64_t* buff64    = reinterpret_cast<uint64_t*>(_buffer);
+    const uint64_t* buff64 = reinterpret_cast<const uint64_t*>(_buffer);
     uint64_t  buff_size = buff64[2];
-    if (buff_size > _length){
-        return nullptr;
+    uint64_t prefix_size = sizeof(int8_t) * 16 + sizeof(uint64_t) * 9;
+    if (buff_size > _length || buff_size < prefix_size){
+        return false;
+    }
+    uint64_t dataSize = buff64[8];
+    if (dataSize > buff_size - prefix_size){
+        return false;
     }
-    uint64_t packId        = buff64[3];
-    uint64_t packOrder     = buff64[4];
-    uint64_t ch_type       = buff64[5];
-    uint64_t adc_mode      = buff64[6];
-    uint64_t bitBySample64 = buff64[7];
-    uint64_t dataSize      = buff64[8];
-    uint64_t lostFPGA      = buff64[9];
-    uint64_t lostINTERNAL  = buff64[10];
 
-    uint64_t prefix_size = sizeof(int8_t) * 16 + sizeof(uint64_t) * 9;
+    _info->id = buff64[3];
+    _info->packOrder = buff64[4];
+    _info->channel = (DataLib::EDataBuffersPackChannel)buff64[5];
+    _info->adcMode = (DataLib::CDataBuffer::ADC_MODE)buff64[6];
+    _info->bitBySample = buff64[7];
+    _info->lostFPGA = buff64[9];
+    _info->lostINTERNAL = buff64[10];
+    _info->data = _buffer + prefix_size;
+    _info->dataSize = dataSize;
+    return true;
+}
+
+auto net_lib::extractBufferPack(uint8_t* _buffer,size_t _length,uint64_t *_id,uint64_t *_packOrder,DataLib::EDataBuffersPackChannel *_channel) -> DataLib::CDataBuffer::Ptr{
+    SBufferPackInfo info;
+    if (!extractBufferPackInfo(_buffer,_length,&info)){
+        return nullptr;
+    }
 
-    auto pack = dataSize == 0 ?
-                DataLib::CDataBuffer::CreateEmpty(bitBySample64) :
-                DataLib::CDataBuffer::Create(_buffer + prefix_size,dataSize,bitBySample64);
+    auto pack = info.dataSize == 0 ?
+                DataLib::CDataBuffer::CreateEmpty(info.bitBySample) :
+                DataLib::CDataBuffer::Create(const_cast<uint8_t*>(info.data),info.dataSize,info.bitBySample);
 
-    pack->setADCMode((DataLib::CDataBuffer::ADC_MODE)adc_mode);
-    pack->setLostSamples(DataLib::FPGA,lostFPGA);
-    pack->setLostSamples(DataLib::RP_INTERNAL_BUFFER,lostINTERNAL);
+    pack->setADCMode(info.adcMode);
+    pack->setLostSamples(DataLib::FPGA,info.lostFPGA);
+    pack->setLostSamples(DataLib::RP_INTERNAL_BUFFER,info.lostINTERNAL);
 
-    *_id = packId;
-    *_packOrder = packOrder;
-    *_channel = (DataLib::EDataBuffersPackChannel)ch_type;
+    *_id = info.id;
+    *_packOrder = info.packOrder;
+    *_channel = info.channel;
 
     return pack;
 }
@@ -307,3 +575,20 @@ auto net_lib::buildPack(uint64_t _id,DataLib::CDataBuffersPack::Ptr pack,size_t
     return list;
 }
 
+auto net_lib::buildPack(uint64_t _id,DataLib::CDataBuffersPack::Ptr pack,size_t split_size,EHeaderVersion version,uint32_t *_sequence) -> net_list_bh{
+    if (version == HV_V1 || _sequence == nullptr){
+        return buildPack(_id,pack,split_size);
+    }
+
+    net_list_bh list;
+    list.push_back(createBeginPackV2(_id,pack,_sequence));
+
+    for(auto i = (int)DataLib::EDataBuffersPackChannel::CH1; i <= (int)DataLib::EDataBuffersPackChannel::CH4 ;i++){
+        auto buff = pack->getBuffer((DataLib::EDataBuffersPackChannel)i);
+        if (buff){
+            list.splice(list.end(),createBufferPackV2(_id,(DataLib::EDataBuffersPackChannel)i,buff,split_size,_sequence));
+        }
+    }
+    list.push_back(createEndPackV2(_id,_sequence));
+    return list;
+}
@@ -17,6 +17,14 @@ typedef std::list<std::pair<net_buffer,size_t>> net_list;
 extern const uint8_t ID_PACK[];
 extern const uint8_t ID_PACK_END[];
 extern const uint8_t ID_BUFFER[];
+extern const uint8_t ID_FRAME_V2[];
+
+// v1 frames start with a 16 byte ID and nine uint64 fields,
+// v2 frames use one 4 byte magic and a packed header (see asio_common.cpp)
+enum EHeaderVersion {
+    HV_V1 = 1,
+    HV_V2 = 2
+};
 
 enum EProtocol {
     P_TCP = 0,
@@ -44,11 +52,32 @@ auto createBuffer(const char *buffer,size_t size) -> net_buffer;
 auto createBuffer(uint64_t size) -> net_buffer;
 
 auto buildPack(uint64_t _id,DataLib::CDataBuffersPack::Ptr pack,size_t split_size) -> net_list_bh;
+auto buildPack(uint64_t _id,DataLib::CDataBuffersPack::Ptr pack,size_t split_size,EHeaderVersion version,uint32_t *_sequence) -> net_list_bh;
+
+// Returns true if a v1 or v2 frame begins at _buffer. _frameSize is 0 while the size field is not received yet.
+auto detectFrame(const uint8_t* _buffer,size_t _length,uint32_t *_frameSize) -> bool;
+// Returns true for v2 frames. Pack ids of v2 frames are 32 bit and wrap around.
+auto extractSequence(const uint8_t* _buffer,size_t _length,uint32_t *_sequence) -> bool;
 
 auto extractBeginPack(uint8_t* _buffer,size_t _length,uint64_t *_id,size_t *_allBuffersSize) -> DataLib::CDataBuffersPack::Ptr;
 auto extractEndPack(uint8_t* _buffer,size_t _length,uint64_t *_id) -> bool;
 auto extractBufferPack(uint8_t* _buffer,size_t _length,uint64_t *_id,uint64_t *_packOrder,DataLib::EDataBuffersPackChannel *_channel) -> DataLib::CDataBuffer::Ptr;
 
+struct SBufferPackInfo{
+    uint64_t id;
+    uint64_t packOrder;
+    DataLib::EDataBuffersPackChannel channel;
+    DataLib::CDataBuffer::ADC_MODE adcMode;
+    uint8_t  bitBySample;
+    uint64_t lostFPGA;
+    uint64_t lostINTERNAL;
+    const uint8_t* data;
+    size_t   dataSize;
+};
+
+// Same as extractBufferPack, but does not copy the samples. _info->data points into _buffer
+auto extractBufferPackInfo(const uint8_t* _buffer,size_t _length,SBufferPackInfo *_info) -> bool;
+
 }
 
 #endif
@@ -88,3 +88,17 @@ auto CAsioNet::sendSyncData(AsioBufferNolder &_buffer) -> bool{
     }
     return false;
 }
+
+auto CAsioNet::sendSyncData(net_list_bh &_buffers) -> bool{
+    if (m_server){
+        return m_server->sendSyncBuffers(_buffers);
+    }
+    return false;
+}
+
+auto CAsioNet::getSendSyscalls() -> uint64_t{
+    if (m_server){
+        return m_server->getSendSyscalls();
+    }
+    return 0;
+}
@@ -41,6 +41,8 @@ public:
 
     auto sendData(bool async,net_buffer _buffer,size_t _size) -> bool;
     auto sendSyncData(AsioBufferNolder &_buffer) -> bool;
+    auto sendSyncData(net_list_bh &_buffers) -> bool;
+    auto getSendSyscalls() -> uint64_t;
     auto getProtocol() -> net_lib::EProtocol;
     auto isConnected() -> bool;
 
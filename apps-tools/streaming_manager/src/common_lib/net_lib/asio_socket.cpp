@@ -1,4 +1,10 @@
 #include <fstream>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <poll.h>
+#include <limits.h>
+#endif
 #include "asio_socket.h"
 #include "data_lib/thread_cout.h"
 
@@ -23,7 +29,8 @@ CAsioSocket::CAsioSocket(net_lib::EProtocol _protocol, std::string host, std::st
         m_pos_last_in_fifo(0),
         m_last_pack_id(0),
         m_mtx(),
-        m_asio(new CAsioService())
+        m_asio(new CAsioService()),
+        m_sendSyscalls(0)
 {
     m_SocketReadBuffer = new uint8_t[SOCKET_BUFFER_SIZE];
     m_tcp_fifo_buffer  = new uint8_t[FIFO_BUFFER_SIZE];
@@ -151,38 +158,10 @@ auto CAsioSocket::handlerReceiveFromServer(const asio::error_code &ErrorCode, si
 //                cout << "Buff size " << m_pos_last_in_fifo << "\n";
             do{
                 for (uint32_t i = 0; i < m_pos_last_in_fifo - size_id; ++i) {
-                    bool find_flag_pack = false;
-                    bool find_flag_pack_end = false;
-                    bool find_flag_buff_pack = false;
-
-                    for (int j = 0; j < size_id; ++j) {
-                        if (m_tcp_fifo_buffer[i + j] == ID_PACK[j]) {
-                            find_flag_pack = true;
-                        } else {
-                            find_flag_pack = false;
-                        }
-
-                        if (m_tcp_fifo_buffer[i + j] == ID_PACK_END[j]) {
-                            find_flag_pack_end = true;
-                        } else {
-                            find_flag_pack_end = false;
-                        }
-
-                        if (m_tcp_fifo_buffer[i + j] == ID_BUFFER[j]) {
-                            find_flag_buff_pack = true;
-                        } else {
-                            find_flag_buff_pack = false;
-                        }
-                        if (!find_flag_pack && !find_flag_pack_end && !find_flag_buff_pack){
-                            break;
-                        }
-                    }
-
-    //                   std::cout << i << " pos " <<  m_pos_last_in_fifo << "\n";
-
-                    if (find_flag_pack || find_flag_pack_end || find_flag_buff_pack) {
-                        uint32_t pack_size = ((uint64_t *) (m_tcp_fifo_buffer + i))[2];
-                        if ((pack_size + i) <= m_pos_last_in_fifo) {
+                    // Matches v1 (16 byte ID) and v2 (4 byte magic) frames
+                    uint32_t pack_size = 0;
+                    if (detectFrame(m_tcp_fifo_buffer + i,m_pos_last_in_fifo - i,&pack_size)) {
+                        if (pack_size && (pack_size + i) <= m_pos_last_in_fifo) {
                             recivedNotify(ErrorCode,
                                           m_tcp_fifo_buffer + i,
                                           (uint32_t) pack_size);
@@ -351,6 +330,7 @@ auto CAsioSocket::sendSyncBuffer(AsioBufferNolder &_buffer) -> bool{
                 buffers.push_back(asio::buffer(_buffer.dataPtr,_buffer.dataLen));
             }
             m_udp_socket->send_to(buffers, m_udp_endpoint, 0, _error);
+            m_sendSyscalls++;
             this->handlerSend(_error,_buffer.headerLen + _buffer.dataLen);
             return  true;
         }
@@ -363,6 +343,7 @@ auto CAsioSocket::sendSyncBuffer(AsioBufferNolder &_buffer) -> bool{
                 buffers.push_back(asio::buffer(_buffer.dataPtr,_buffer.dataLen));
             }
             m_tcp_socket->send(buffers, 0, _error);
+            m_sendSyscalls++;
             this->handlerSend(_error,_buffer.headerLen + _buffer.dataLen);
             return  true;
         }
@@ -370,6 +351,124 @@ auto CAsioSocket::sendSyncBuffer(AsioBufferNolder &_buffer) -> bool{
     return false;
 }
 
+auto CAsioSocket::getSendSyscalls() -> uint64_t{
+    return m_sendSyscalls;
+}
+
+auto CAsioSocket::sendSyncBuffers(net_list_bh &_buffers) -> bool{
+#ifdef _WIN32
+    bool ret = true;
+    for(auto &buff : _buffers){
+        ret = sendSyncBuffer(buff) && ret;
+    }
+    return ret;
+#else
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if (m_protocol == net_lib::EProtocol::P_UDP && m_udp_socket){
+        return sendmmsgUDP(_buffers);
+    }
+    if (m_protocol == net_lib::EProtocol::P_TCP && m_tcp_socket){
+        return writevTCP(_buffers);
+    }
+    return false;
+#endif
+}
+
+#ifndef _WIN32
+
+// Asio may switch the descriptor to non-blocking mode for its async operations
+auto CAsioSocket::waitWritable(int fd) -> bool{
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLOUT;
+    pfd.revents = 0;
+    return poll(&pfd, 1, 1000) > 0;
+}
+
+auto CAsioSocket::writevTCP(net_list_bh &_buffers) -> bool{
+    std::vector<iovec> iov;
+    iov.reserve(_buffers.size() * 2);
+    size_t total = 0;
+    for(auto &buff : _buffers){
+        iov.push_back({buff.header,buff.headerLen});
+        if (buff.dataPtr && buff.dataLen){
+            iov.push_back({buff.dataPtr,buff.dataLen});
+        }
+        total += buff.headerLen + buff.dataLen;
+    }
+
+    int fd = m_tcp_socket->native_handle();
+    size_t sent = 0;
+    size_t pos = 0;
+    asio::error_code _error;
+    while(pos < iov.size()){
+        int cnt = (int)std::min<size_t>(iov.size() - pos, IOV_MAX);
+        ssize_t n = ::writev(fd, iov.data() + pos, cnt);
+        m_sendSyscalls++;
+        if (n < 0){
+            if ((errno == EAGAIN || errno == EWOULDBLOCK) && waitWritable(fd)) continue;
+            if (errno == EINTR) continue;
+            _error = asio::error_code(errno, asio::error::get_system_category());
+            break;
+        }
+        sent += n;
+        // Skip fully written vectors and shift the partially written one
+        while(pos < iov.size() && (size_t)n >= iov[pos].iov_len){
+            n -= iov[pos].iov_len;
+            pos++;
+        }
+        if (pos < iov.size() && n > 0){
+            iov[pos].iov_base = static_cast<uint8_t*>(iov[pos].iov_base) + n;
+            iov[pos].iov_len -= n;
+        }
+    }
+    this->handlerSend(_error,sent);
+    return !_error && sent == total;
+}
+
+auto CAsioSocket::sendmmsgUDP(net_list_bh &_buffers) -> bool{
+    std::vector<iovec> iov(_buffers.size() * 2);
+    std::vector<mmsghdr> msgs(_buffers.size());
+    size_t idx = 0;
+    size_t total = 0;
+    for(auto &buff : _buffers){
+        auto &msg = msgs[idx];
+        memset(&msg,0,sizeof(mmsghdr));
+        iov[idx * 2] = {buff.header,buff.headerLen};
+        iov[idx * 2 + 1] = {buff.dataPtr,buff.dataPtr ? buff.dataLen : 0};
+        msg.msg_hdr.msg_iov = &iov[idx * 2];
+        msg.msg_hdr.msg_iovlen = buff.dataPtr ? 2 : 1;
+        msg.msg_hdr.msg_name = m_udp_endpoint.data();
+        msg.msg_hdr.msg_namelen = m_udp_endpoint.size();
+        total += buff.headerLen + (buff.dataPtr ? buff.dataLen : 0);
+        idx++;
+    }
+
+    int fd = m_udp_socket->native_handle();
+    size_t pos = 0;
+    size_t sent = 0;
+    asio::error_code _error;
+    while(pos < msgs.size()){
+        unsigned int cnt = (unsigned int)std::min<size_t>(msgs.size() - pos, IOV_MAX);
+        int n = ::sendmmsg(fd, msgs.data() + pos, cnt, 0);
+        m_sendSyscalls++;
+        if (n < 0){
+            if ((errno == EAGAIN || errno == EWOULDBLOCK) && waitWritable(fd)) continue;
+            if (errno == EINTR) continue;
+            _error = asio::error_code(errno, asio::error::get_system_category());
+            break;
+        }
+        for(int i = 0; i < n; i++){
+            sent += msgs[pos + i].msg_len;
+        }
+        pos += n;
+    }
+    this->handlerSend(_error,sent);
+    return !_error && sent == total;
+}
+
+#endif
+
 
 auto CAsioSocket::sendBuffer(bool async, net_lib::net_buffer _buffer, size_t _size) -> bool{
     std::lock_guard<std::mutex> lock(m_mtx);
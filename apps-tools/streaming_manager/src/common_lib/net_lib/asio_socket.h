@@ -10,6 +10,7 @@
 #include <cstdint>
 #include <memory>
 #include <deque>
+#include <atomic>
 
 #include "asio_common.h"
 #include "data_lib/neon_asm.h"
@@ -41,6 +42,9 @@ public:
     auto sendBuffer(net_buffer _buffer, size_t _size) -> void;
     auto sendBuffer(bool async,net_buffer _buffer, size_t _size) -> bool;
     auto sendSyncBuffer(AsioBufferNolder &_buffer) -> bool;
+    // Sends the whole list with one writev (TCP) or sendmmsg (UDP) where the OS allows it
+    auto sendSyncBuffers(net_list_bh &_buffers) -> bool;
+    auto getSendSyscalls() -> uint64_t;
 
     sigslot::signal<string&>    connectServerNotify;
     sigslot::signal<string&>    disconnectServerNotify;
@@ -68,6 +72,9 @@ private:
     auto handlerSend(const asio::error_code &_error, size_t _bytesTransferred) -> void;
     auto handlerSend2(const asio::error_code &_error, size_t _bytesTransferred,uint64_t bufferId) -> void;
     auto handlerReceiveFromServer(const asio::error_code &ErrorCode, size_t bytes_transferred) -> void;
+    auto waitWritable(int fd) -> bool;
+    auto writevTCP(net_list_bh &_buffers) -> bool;
+    auto sendmmsgUDP(net_list_bh &_buffers) -> bool;
 
     net_lib::EMode m_mode;
     net_lib::EProtocol m_protocol;
@@ -89,6 +96,7 @@ private:
     CAsioService *m_asio;
     uint64_t m_sendbufersId = 0;
     std::map<uint64_t,net_buffer> m_sendbuffers;
+    std::atomic<uint64_t> m_sendSyscalls;
 
 };
 
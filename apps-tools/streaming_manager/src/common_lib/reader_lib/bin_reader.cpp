@@ -0,0 +1,413 @@
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include "bin_reader.h"
+#include "writer_lib/w_binary.h"
+#include "data_lib/thread_cout.h"
+
+namespace {
+
+constexpr char     g_indexMagic[4] = {'R','P','B','I'};
+constexpr uint32_t g_indexVersion = 1;
+constexpr uint32_t g_endOfSegmentSize = 12;
+
+struct SIndexHeader{
+    char     magic[4];
+    uint32_t version;
+    uint32_t entrySize;
+    uint32_t lastSegmentOk;
+    uint64_t fileSize;
+    int64_t  fileTime;
+    uint64_t count;
+};
+
+auto getGranularity() -> uint64_t{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+#else
+    return sysconf(_SC_PAGE_SIZE);
+#endif
+}
+
+}
+
+auto CBinReader::create() -> CBinReader::Ptr{
+    return std::make_shared<CBinReader>();
+}
+
+auto CBinReader::getIndexFileName(const std::string &_filePath) -> std::string{
+    return _filePath + ".idx";
+}
+
+CBinReader::CBinReader():
+    m_filePath(""),
+    m_segments(),
+    m_fileSize(0),
+    m_fileTime(0),
+    m_lastSegmentOk(false),
+    m_fromCache(false),
+    m_uniformSamples(0),
+    m_map(nullptr),
+    m_window(nullptr),
+    m_windowOffset(0),
+    m_windowSize(0),
+    m_windowSegment(-1),
+#ifdef _WIN32
+    m_file(INVALID_HANDLE_VALUE),
+    m_mapping(nullptr)
+#else
+    m_fd(-1)
+#endif
+{
+}
+
+CBinReader::~CBinReader(){
+    close();
+}
+
+auto CBinReader::open(const std::string &_filePath,bool _useIndexCache) -> bool{
+    close();
+    struct stat st;
+    if (stat(_filePath.c_str(),&st) != 0){
+        aprintf(stderr,"[CBinReader] File %s not found\n",_filePath.c_str());
+        return false;
+    }
+    m_filePath = _filePath;
+    m_fileSize = st.st_size;
+    m_fileTime = st.st_mtime;
+
+    if (!mapFile()){
+        aprintf(stderr,"[CBinReader] Can't open file %s\n",_filePath.c_str());
+        close();
+        return false;
+    }
+
+    m_fromCache = _useIndexCache && loadIndex();
+    if (!m_fromCache){
+        if (!buildIndex()){
+            close();
+            return false;
+        }
+        if (_useIndexCache){
+            saveIndex();
+        }
+    }
+
+    m_uniformSamples = m_segments.size() ? m_segments[0].samples : 0;
+    for(size_t i = 1; i + 1 < m_segments.size() && m_uniformSamples; i++){
+        if (m_segments[i].samples != m_uniformSamples){
+            m_uniformSamples = 0;
+        }
+    }
+    return true;
+}
+
+auto CBinReader::close() -> void{
+    unmapFile();
+    m_segments.clear();
+    m_filePath = "";
+    m_fileSize = 0;
+    m_fileTime = 0;
+    m_lastSegmentOk = false;
+    m_fromCache = false;
+    m_uniformSamples = 0;
+}
+
+auto CBinReader::isOpen() -> bool{
+    return m_filePath != "";
+}
+
+auto CBinReader::isIndexFromCache() -> bool{
+    return m_fromCache;
+}
+
+auto CBinReader::isLastSegmentOk() -> bool{
+    return m_lastSegmentOk;
+}
+
+auto CBinReader::buildIndex() -> bool{
+    std::ifstream fs(m_filePath, std::ios::binary);
+    if (fs.fail()){
+        return false;
+    }
+    m_segments.clear();
+    m_lastSegmentOk = false;
+    uint64_t position = 0;
+    uint64_t firstSample = 0;
+    while(position + sizeof(CBinInfo::BinHeader) + g_endOfSegmentSize <= m_fileSize){
+        CBinInfo::BinHeader header;
+        uint32_t endSeg[] = { 0, 0 ,0};
+        fs.seekg(position, std::ios::beg);
+        fs.read((char*)&header, sizeof(CBinInfo::BinHeader));
+        fs.seekg(position + sizeof(CBinInfo::BinHeader) + header.sigmentLength, std::ios::beg);
+        fs.read((char*)endSeg, g_endOfSegmentSize);
+        if (fs.fail() || !(endSeg[0] == 0xFFFFFFFF && endSeg[1] == 0xFFFFFFFF && endSeg[2] == 0xFFFFFFFF)){
+            return true;
+        }
+        SSegment seg;
+        memset(&seg,0,sizeof(SSegment));
+        seg.offset = position;
+        seg.firstSample = firstSample;
+        bool hasData = false;
+        for(int ch = 0; ch < 4; ch++){
+            seg.sizeCh[ch] = header.sizeCh[ch];
+            seg.sampleCh[ch] = header.sampleCh[ch];
+            seg.lostCount[ch] = header.lostCount[ch];
+            seg.dataFormatSize[ch] = header.dataFormatSize[ch];
+            hasData |= header.sizeCh[ch] || header.lostCount[ch];
+            seg.samples = std::max<uint64_t>(seg.samples,header.sampleCh[ch] + header.lostCount[ch]);
+        }
+        // Same as CSV converter: a segment without data and losses has no samples
+        if (!hasData) seg.samples = 0;
+        firstSample += seg.samples;
+        m_segments.push_back(seg);
+        position += sizeof(CBinInfo::BinHeader) + header.sigmentLength + g_endOfSegmentSize;
+    }
+    m_lastSegmentOk = position == m_fileSize;
+    return true;
+}
+
+auto CBinReader::loadIndex() -> bool{
+    std::ifstream fs(getIndexFileName(m_filePath), std::ios::binary);
+    if (fs.fail()){
+        return false;
+    }
+    SIndexHeader header;
+    fs.read((char*)&header,sizeof(SIndexHeader));
+    if (fs.fail()
+        || memcmp(header.magic,g_indexMagic,4) != 0
+        || header.version != g_indexVersion
+        || header.entrySize != sizeof(SSegment)
+        || header.fileSize != m_fileSize
+        || header.fileTime != m_fileTime){
+        return false;
+    }
+    m_segments.resize(header.count);
+    fs.read((char*)m_segments.data(),header.count * sizeof(SSegment));
+    if (fs.fail()){
+        m_segments.clear();
+        return false;
+    }
+    m_lastSegmentOk = header.lastSegmentOk;
+    return true;
+}
+
+auto CBinReader::saveIndex() -> void{
+    SIndexHeader header;
+    memcpy(header.magic,g_indexMagic,4);
+    header.version = g_indexVersion;
+    header.entrySize = sizeof(SSegment);
+    header.lastSegmentOk = m_lastSegmentOk;
+    header.fileSize = m_fileSize;
+    header.fileTime = m_fileTime;
+    header.count = m_segments.size();
+
+    // Write to a temporary file first, so a reader never sees a half-written index
+    auto indexFile = getIndexFileName(m_filePath);
+    auto tmpFile = indexFile + ".tmp";
+    {
+        std::ofstream fs(tmpFile, std::ios::binary | std::ios::trunc);
+        if (fs.fail()){
+            return;
+        }
+        fs.write((const char*)&header,sizeof(SIndexHeader));
+        fs.write((const char*)m_segments.data(),m_segments.size() * sizeof(SSegment));
+        if (fs.fail()){
+            fs.close();
+            std::remove(tmpFile.c_str());
+            return;
+        }
+    }
+    std::remove(indexFile.c_str());
+    if (std::rename(tmpFile.c_str(),indexFile.c_str()) != 0){
+        std::remove(tmpFile.c_str());
+    }
+}
+
+auto CBinReader::mapFile() -> bool{
+#ifdef _WIN32
+    m_file = CreateFileA(m_filePath.c_str(),GENERIC_READ,FILE_SHARE_READ | FILE_SHARE_WRITE,NULL,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,NULL);
+    if (m_file == INVALID_HANDLE_VALUE){
+        return false;
+    }
+    if (m_fileSize == 0){
+        return true;
+    }
+    m_mapping = CreateFileMappingA(m_file,NULL,PAGE_READONLY,0,0,NULL);
+    if (!m_mapping){
+        return false;
+    }
+    m_map = (const uint8_t*)MapViewOfFile(m_mapping,FILE_MAP_READ,0,0,0);
+#else
+    m_fd = ::open(m_filePath.c_str(),O_RDONLY);
+    if (m_fd < 0){
+        return false;
+    }
+    if (m_fileSize == 0 || m_fileSize > SIZE_MAX){
+        return true;
+    }
+    auto map = mmap(nullptr,m_fileSize,PROT_READ,MAP_SHARED,m_fd,0);
+    m_map = map == MAP_FAILED ? nullptr : (const uint8_t*)map;
+#endif
+    // No address space for the whole file. Segments will be mapped one by one
+    return true;
+}
+
+auto CBinReader::unmapFile() -> void{
+#ifdef _WIN32
+    if (m_window) UnmapViewOfFile(m_window);
+    if (m_map) UnmapViewOfFile(m_map);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+    m_mapping = nullptr;
+    m_file = INVALID_HANDLE_VALUE;
+#else
+    if (m_window) munmap((void*)m_window,m_windowSize);
+    if (m_map) munmap((void*)m_map,m_fileSize);
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+#endif
+    m_map = nullptr;
+    m_window = nullptr;
+    m_windowOffset = 0;
+    m_windowSize = 0;
+    m_windowSegment = -1;
+}
+
+auto CBinReader::mapSegment(uint64_t _segment) -> const uint8_t*{
+    auto &seg = m_segments[_segment];
+    if (m_map){
+        return m_map + seg.offset;
+    }
+    if (m_windowSegment != (int64_t)_segment){
+        uint64_t length = sizeof(CBinInfo::BinHeader);
+        for(int ch = 0; ch < 4; ch++){
+            length += seg.sizeCh[ch];
+        }
+        auto offset = seg.offset - seg.offset % getGranularity();
+        auto size = seg.offset - offset + length;
+#ifdef _WIN32
+        if (m_window) UnmapViewOfFile(m_window);
+        m_window = (const uint8_t*)MapViewOfFile(m_mapping,FILE_MAP_READ,(DWORD)(offset >> 32),(DWORD)(offset & 0xFFFFFFFF),size);
+#else
+        if (m_window) munmap((void*)m_window,m_windowSize);
+        auto map = mmap(nullptr,size,PROT_READ,MAP_SHARED,m_fd,offset);
+        m_window = map == MAP_FAILED ? nullptr : (const uint8_t*)map;
+#endif
+        if (!m_window){
+            m_windowSegment = -1;
+            return nullptr;
+        }
+        m_windowOffset = offset;
+        m_windowSize = size;
+        m_windowSegment = _segment;
+    }
+    return m_window + (seg.offset - m_windowOffset);
+}
+
+auto CBinReader::getSegmentsCount() -> uint64_t{
+    return m_segments.size();
+}
+
+auto CBinReader::getSegment(uint64_t _index) -> const CBinReader::SSegment*{
+    if (_index >= m_segments.size()){
+        return nullptr;
+    }
+    return &m_segments[_index];
+}
+
+auto CBinReader::getSamplesCount() -> uint64_t{
+    if (m_segments.empty()){
+        return 0;
+    }
+    return m_segments.back().firstSample + m_segments.back().samples;
+}
+
+auto CBinReader::findSegment(uint64_t _sample) -> int64_t{
+    if (_sample >= getSamplesCount()){
+        return -1;
+    }
+    // All segments except the last one are usually of the same size
+    if (m_uniformSamples){
+        return std::min<uint64_t>(_sample / m_uniformSamples, m_segments.size() - 1);
+    }
+    auto it = std::upper_bound(m_segments.begin(),m_segments.end(),_sample,[](uint64_t sample,const SSegment &seg){
+        return sample < seg.firstSample;
+    });
+    return (it - m_segments.begin()) - 1;
+}
+
+auto CBinReader::getChannelData(uint64_t _segment,uint8_t _channel,const uint8_t **_data,size_t *_size) -> bool{
+    if (_segment >= m_segments.size() || _channel >= 4){
+        return false;
+    }
+    auto &seg = m_segments[_segment];
+    *_data = nullptr;
+    *_size = 0;
+    if (seg.sizeCh[_channel] == 0){
+        return true;
+    }
+    auto base = mapSegment(_segment);
+    if (!base){
+        return false;
+    }
+    base += sizeof(CBinInfo::BinHeader);
+    for(int ch = 0; ch < _channel; ch++){
+        base += seg.sizeCh[ch];
+    }
+    *_data = base;
+    *_size = seg.sizeCh[_channel];
+    return true;
+}
+
+auto CBinReader::readSamples(uint8_t _channel,uint64_t _first,uint64_t _count,void *_dst) -> uint64_t{
+    if (_channel >= 4){
+        return 0;
+    }
+    uint8_t bytes = 0;
+    for(auto &seg : m_segments){
+        if (seg.dataFormatSize[_channel]){
+            bytes = seg.dataFormatSize[_channel];
+            break;
+        }
+    }
+    auto index = findSegment(_first);
+    if (bytes == 0 || index < 0){
+        return 0;
+    }
+    auto dst = (uint8_t*)_dst;
+    uint64_t copied = 0;
+    for(uint64_t i = index; i < m_segments.size() && copied < _count; i++){
+        auto &seg = m_segments[i];
+        uint64_t row = _first + copied - seg.firstSample;
+        uint64_t rows = std::min<uint64_t>(seg.samples - row,_count - copied);
+        uint64_t dataRows = 0;
+        if (seg.dataFormatSize[_channel] == bytes){
+            const uint8_t *data = nullptr;
+            size_t size = 0;
+            if (!getChannelData(i,_channel,&data,&size)){
+                break;
+            }
+            uint64_t avail = std::min<uint64_t>(seg.sampleCh[_channel],size / bytes);
+            if (avail > row){
+                dataRows = std::min<uint64_t>(avail - row,rows);
+                memcpy(dst + copied * bytes,data + row * bytes,dataRows * bytes);
+            }
+        }
+        memset(dst + (copied + dataRows) * bytes,0,(rows - dataRows) * bytes);
+        copied += rows;
+    }
+    return copied;
+}
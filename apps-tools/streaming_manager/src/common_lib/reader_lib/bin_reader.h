@@ -0,0 +1,95 @@
+#ifndef READER_LIB_BIN_READER_H
+#define READER_LIB_BIN_READER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+/*
+ * Random access reader for BIN files written by CStreamingFile.
+ * Segment headers are parsed once into an index that is saved next to the
+ * data file (file_name.idx) and reused while the data file size and
+ * modification time do not change. The data itself is memory mapped.
+ *
+ * If the whole file cannot be mapped (32-bit address space), one segment
+ * at a time is mapped. Pointers returned by getChannelData() are then valid
+ * only until the next call.
+ */
+class CBinReader
+{
+public:
+
+    struct SSegment{
+        uint64_t offset;        // Offset of the segment header in the file
+        uint64_t firstSample;   // Index of the first sample over the whole file
+        uint64_t samples;       // Samples in segment, lost samples included
+        uint32_t sizeCh[4];
+        uint32_t sampleCh[4];
+        uint64_t lostCount[4];
+        uint8_t  dataFormatSize[4];
+    };
+
+    using Ptr = std::shared_ptr<CBinReader>;
+
+    static auto create() -> Ptr;
+    static auto getIndexFileName(const std::string &_filePath) -> std::string;
+
+    CBinReader();
+    ~CBinReader();
+
+    auto open(const std::string &_filePath,bool _useIndexCache = true) -> bool;
+    auto close() -> void;
+    auto isOpen() -> bool;
+    // True if the index was loaded from the sidecar file
+    auto isIndexFromCache() -> bool;
+    // False if the file ends with a broken segment. It is not in the index
+    auto isLastSegmentOk() -> bool;
+
+    auto getSegmentsCount() -> uint64_t;
+    auto getSegment(uint64_t _index) -> const SSegment*;
+    auto getSamplesCount() -> uint64_t;
+    // Returns -1 if the sample is out of range
+    auto findSegment(uint64_t _sample) -> int64_t;
+
+    auto getChannelData(uint64_t _segment,uint8_t _channel,const uint8_t **_data,size_t *_size) -> bool;
+    // Copies samples of one channel into _dst. Lost samples are filled with zero.
+    // Returns the number of copied samples
+    auto readSamples(uint8_t _channel,uint64_t _first,uint64_t _count,void *_dst) -> uint64_t;
+
+private:
+
+    CBinReader(const CBinReader &) = delete;
+    CBinReader(CBinReader &&) = delete;
+    CBinReader& operator=(const CBinReader&) =delete;
+    CBinReader& operator=(const CBinReader&&) =delete;
+
+    auto buildIndex() -> bool;
+    auto loadIndex() -> bool;
+    auto saveIndex() -> void;
+    auto mapFile() -> bool;
+    auto unmapFile() -> void;
+    auto mapSegment(uint64_t _segment) -> const uint8_t*;
+
+    std::string m_filePath;
+    std::vector<SSegment> m_segments;
+    uint64_t m_fileSize;
+    int64_t  m_fileTime;
+    bool     m_lastSegmentOk;
+    bool     m_fromCache;
+    uint64_t m_uniformSamples;
+
+    const uint8_t *m_map;
+    const uint8_t *m_window;
+    uint64_t m_windowOffset;
+    uint64_t m_windowSize;
+    int64_t  m_windowSegment;
+#ifdef _WIN32
+    void    *m_file;
+    void    *m_mapping;
+#else
+    int      m_fd;
+#endif
+};
+
+#endif
@@ -0,0 +1,67 @@
+#include <cstring>
+#include <new>
+#include "bin_reader_api.h"
+#include "bin_reader.h"
+
+struct bin_reader{
+    CBinReader reader;
+};
+
+bin_reader_t* bin_reader_open(const char *file_name, int use_index_cache){
+    if (!file_name) return nullptr;
+    auto handle = new (std::nothrow) bin_reader_t();
+    if (!handle) return nullptr;
+    if (!handle->reader.open(file_name,use_index_cache != 0)){
+        delete handle;
+        return nullptr;
+    }
+    return handle;
+}
+
+void bin_reader_close(bin_reader_t *reader){
+    delete reader;
+}
+
+uint64_t bin_reader_segments_count(bin_reader_t *reader){
+    return reader ? reader->reader.getSegmentsCount() : 0;
+}
+
+uint64_t bin_reader_samples_count(bin_reader_t *reader){
+    return reader ? reader->reader.getSamplesCount() : 0;
+}
+
+int bin_reader_last_segment_ok(bin_reader_t *reader){
+    return reader ? reader->reader.isLastSegmentOk() : 0;
+}
+
+int bin_reader_index_from_cache(bin_reader_t *reader){
+    return reader ? reader->reader.isIndexFromCache() : 0;
+}
+
+int bin_reader_segment_info(bin_reader_t *reader, uint64_t segment, bin_segment_info_t *info){
+    if (!reader || !info) return -1;
+    auto seg = reader->reader.getSegment(segment);
+    if (!seg) return -1;
+    info->offset = seg->offset;
+    info->first_sample = seg->firstSample;
+    info->samples = seg->samples;
+    memcpy(info->size_ch,seg->sizeCh,sizeof(info->size_ch));
+    memcpy(info->samples_ch,seg->sampleCh,sizeof(info->samples_ch));
+    memcpy(info->lost_ch,seg->lostCount,sizeof(info->lost_ch));
+    memcpy(info->format_size,seg->dataFormatSize,sizeof(info->format_size));
+    return 0;
+}
+
+int64_t bin_reader_find_segment(bin_reader_t *reader, uint64_t sample){
+    return reader ? reader->reader.findSegment(sample) : -1;
+}
+
+int bin_reader_channel_data(bin_reader_t *reader, uint64_t segment, uint8_t channel, const uint8_t **data, size_t *size){
+    if (!reader || !data || !size) return -1;
+    return reader->reader.getChannelData(segment,channel,data,size) ? 0 : -1;
+}
+
+uint64_t bin_reader_read_samples(bin_reader_t *reader, uint8_t channel, uint64_t first, uint64_t count, void *dst){
+    if (!reader || !dst) return 0;
+    return reader->reader.readSamples(channel,first,count,dst);
+}
@@ -0,0 +1,48 @@
+#ifndef READER_LIB_BIN_READER_API_H
+#define READER_LIB_BIN_READER_API_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * C interface of CBinReader. Channels are numbered from 0 (CH1) to 3 (CH4).
+ * Functions returning int return 0 on success and -1 on error.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct bin_reader bin_reader_t;
+
+typedef struct {
+    uint64_t offset;
+    uint64_t first_sample;
+    uint64_t samples;
+    uint32_t size_ch[4];
+    uint32_t samples_ch[4];
+    uint64_t lost_ch[4];
+    uint8_t  format_size[4];
+} bin_segment_info_t;
+
+// use_index_cache: load and save the segment index in file_name.idx
+bin_reader_t* bin_reader_open(const char *file_name, int use_index_cache);
+void          bin_reader_close(bin_reader_t *reader);
+
+uint64_t bin_reader_segments_count(bin_reader_t *reader);
+uint64_t bin_reader_samples_count(bin_reader_t *reader);
+int      bin_reader_last_segment_ok(bin_reader_t *reader);
+int      bin_reader_index_from_cache(bin_reader_t *reader);
+
+int      bin_reader_segment_info(bin_reader_t *reader, uint64_t segment, bin_segment_info_t *info);
+int64_t  bin_reader_find_segment(bin_reader_t *reader, uint64_t sample);
+// Pointer into the mapped file. Valid until the next call for this reader
+int      bin_reader_channel_data(bin_reader_t *reader, uint64_t segment, uint8_t channel, const uint8_t **data, size_t *size);
+// Returns the number of samples copied to dst. Lost samples are filled with zero
+uint64_t bin_reader_read_samples(bin_reader_t *reader, uint8_t channel, uint64_t first, uint64_t count, void *dst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
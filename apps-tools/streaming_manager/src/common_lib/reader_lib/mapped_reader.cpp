@@ -0,0 +1,249 @@
+#define _FILE_OFFSET_BITS 64
+
+#include <algorithm>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include "mapped_reader.h"
+#include "data_lib/neon_asm.h"
+#include "data_lib/thread_cout.h"
+
+auto CMappedReader::create(const std::string &_filePath,const std::vector<SRegion> &_regions,uint32_t _passes) -> CMappedReader::Ptr{
+    return std::make_shared<CMappedReader>(_filePath,_regions,_passes);
+}
+
+CMappedReader::CMappedReader(const std::string &_filePath,const std::vector<SRegion> &_regions,uint32_t _passes):
+    m_filePath(_filePath),
+    m_regions(_regions),
+    m_passes(_passes),
+    m_begin(0),
+    m_end(0),
+    m_fd(-1),
+    m_windows(mapped_windows_ahead),
+    m_thread(),
+    m_stop(false),
+    m_readAheadDone(false),
+    m_mtx(),
+    m_readCond(),
+    m_readAheadCond(),
+    m_pass(0),
+    m_region(0),
+    m_regionPos(0),
+    m_underruns(0)
+{}
+
+CMappedReader::~CMappedReader(){
+    close();
+}
+
+auto CMappedReader::open() -> bool{
+#ifdef _WIN32
+    return false;
+#else
+    close();
+    if (m_regions.empty()){
+        return false;
+    }
+    for(size_t i = 1; i < m_regions.size(); i++){
+        if (m_regions[i].offset < m_regions[i - 1].offset + m_regions[i - 1].size){
+            return false;
+        }
+    }
+    m_begin = m_regions.front().offset;
+    m_end = m_regions.back().offset + m_regions.back().size;
+
+    m_fd = ::open(m_filePath.c_str(),O_RDONLY);
+    if (m_fd < 0){
+        return false;
+    }
+    struct stat st;
+    if (fstat(m_fd,&st) != 0 || (uint64_t)st.st_size < m_end){
+        close();
+        return false;
+    }
+    m_pass = 0;
+    m_region = 0;
+    m_regionPos = 0;
+    startReadAhead();
+    return true;
+#endif
+}
+
+auto CMappedReader::close() -> void{
+    stopReadAhead();
+#ifndef _WIN32
+    if (m_fd >= 0) ::close(m_fd);
+#endif
+    m_fd = -1;
+}
+
+auto CMappedReader::startReadAhead() -> void{
+    m_stop = false;
+    m_readAheadDone = false;
+    m_thread = std::thread(&CMappedReader::readAheadThread, this);
+}
+
+auto CMappedReader::stopReadAhead() -> void{
+    m_stop = true;
+    {
+        const std::lock_guard<std::mutex> lock(m_mtx);
+    }
+    m_readAheadCond.notify_all();
+    if (m_thread.joinable()){
+        m_thread.join();
+    }
+    while(auto window = m_windows.front()){
+        unmapWindow(*window);
+        m_windows.pop();
+    }
+}
+
+auto CMappedReader::readAheadThread() -> void{
+    uint32_t pass = 0;
+    while(!m_stop){
+        for(uint64_t pos = m_begin; pos < m_end && !m_stop; pos += mapped_window_size){
+            {
+                std::unique_lock<std::mutex> lock(m_mtx);
+                m_readAheadCond.wait(lock,[&]{ return m_stop || m_windows.size() < mapped_windows_ahead; });
+            }
+            if (m_stop) break;
+
+            SWindow window;
+            if (!mapWindow(pos,std::min(pos + mapped_window_size,m_end),pass,&window)){
+                aprintf(stderr,"[CMappedReader] Can't map %s at %llu\n",m_filePath.c_str(),(unsigned long long)pos);
+                m_stop = true;
+                break;
+            }
+            m_windows.push(std::move(window));
+            {
+                const std::lock_guard<std::mutex> lock(m_mtx);
+            }
+            m_readCond.notify_one();
+        }
+        pass++;
+        if (m_passes && pass >= m_passes) break;
+    }
+    m_readAheadDone = true;
+    {
+        const std::lock_guard<std::mutex> lock(m_mtx);
+    }
+    m_readCond.notify_one();
+}
+
+auto CMappedReader::mapWindow(uint64_t _begin,uint64_t _end,uint32_t _pass,SWindow *_window) -> bool{
+#ifdef _WIN32
+    return false;
+#else
+    const uint64_t page = getpagesize();
+    auto offset = _begin - _begin % page;
+    auto size = (size_t)(_end - offset);
+    auto map = mmap(nullptr,size,PROT_READ,MAP_SHARED,m_fd,offset);
+    if (map == MAP_FAILED){
+        return false;
+    }
+    madvise(map,size,MADV_SEQUENTIAL);
+    madvise(map,size,MADV_WILLNEED);
+    // Fault the pages in here, so the reader does not wait for the storage
+    volatile uint8_t sink = 0;
+    for(size_t i = 0; i < size; i += page){
+        sink = sink + ((const uint8_t*)map)[i];
+    }
+    _window->map = (const uint8_t*)map;
+    _window->mapOffset = offset;
+    _window->mapSize = size;
+    _window->begin = _begin;
+    _window->end = _end;
+    _window->pass = _pass;
+    return true;
+#endif
+}
+
+auto CMappedReader::unmapWindow(SWindow &_window) -> void{
+#ifndef _WIN32
+    if (_window.map) munmap((void*)_window.map,_window.mapSize);
+#endif
+    _window.map = nullptr;
+}
+
+auto CMappedReader::getWindow(uint64_t _position) -> SWindow*{
+    while(true){
+        auto window = m_windows.front();
+        if (window){
+            if (window->pass < m_pass || (window->pass == m_pass && window->end <= _position)){
+                unmapWindow(*window);
+                m_windows.pop();
+                {
+                    const std::lock_guard<std::mutex> lock(m_mtx);
+                }
+                m_readAheadCond.notify_one();
+                continue;
+            }
+            return window->pass == m_pass ? window : nullptr;
+        }
+        if (m_readAheadDone){
+            return nullptr;
+        }
+        // Waiting at the very start is not an underrun, nothing is played yet
+        if (m_pass || m_region || m_regionPos){
+            m_underruns++;
+        }
+        std::unique_lock<std::mutex> lock(m_mtx);
+        m_readCond.wait(lock,[&]{ return m_windows.front() != nullptr || m_readAheadDone; });
+    }
+}
+
+auto CMappedReader::getRegion(EChannel *_channel,uint64_t *_left) -> bool{
+    if (m_region >= m_regions.size()){
+        return false;
+    }
+    *_channel = m_regions[m_region].channel;
+    *_left = m_regions[m_region].size - m_regionPos;
+    return true;
+}
+
+auto CMappedReader::read(uint8_t *_dst,size_t _size) -> size_t{
+    if (m_region >= m_regions.size()){
+        return 0;
+    }
+    auto &region = m_regions[m_region];
+    _size = (size_t)std::min<uint64_t>(_size,region.size - m_regionPos);
+    size_t done = 0;
+    while(done < _size){
+        auto pos = region.offset + m_regionPos;
+        auto window = getWindow(pos);
+        if (!window){
+            break;
+        }
+        auto size = (size_t)std::min<uint64_t>(_size - done,window->end - pos);
+        memcpy_neon(_dst + done,window->map + (pos - window->mapOffset),size);
+        done += size;
+        m_regionPos += size;
+    }
+    if (m_regionPos == region.size){
+        m_region++;
+        m_regionPos = 0;
+    }
+    return done;
+}
+
+auto CMappedReader::nextPass() -> bool{
+    m_pass++;
+    m_region = 0;
+    m_regionPos = 0;
+    if (m_passes && m_pass >= m_passes){
+        // All passes are read, start again as with a reopened file
+        stopReadAhead();
+        m_pass = 0;
+        startReadAhead();
+    }
+    return m_fd >= 0;
+}
+
+auto CMappedReader::getUnderrunCount() -> uint64_t{
+    return m_underruns;
+}
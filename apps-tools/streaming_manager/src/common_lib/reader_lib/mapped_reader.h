@@ -0,0 +1,114 @@
+#ifndef READER_LIB_MAPPED_READER_H
+#define READER_LIB_MAPPED_READER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+
+#include "data_lib/spsc_queue.h"
+
+constexpr uint64_t mapped_window_size = 4 * 1024 * 1024;
+constexpr size_t   mapped_windows_ahead = 4;
+
+/*
+ * Sequential reader of file regions through mmap. A read-ahead thread maps
+ * the file in windows of mapped_window_size, touches the pages and passes
+ * the windows to the reader, up to mapped_windows_ahead windows ahead.
+ * Windows that were read are unmapped, so files larger than the address
+ * space can be replayed.
+ *
+ * Regions are read in the given order and must not overlap. For several
+ * passes the read-ahead thread wraps to the first region, so the next pass
+ * is already mapped when the reader reaches the end of the current one.
+ *
+ * An underrun is counted every time the reader has to wait for the
+ * read-ahead thread.
+ */
+class CMappedReader
+{
+public:
+
+    enum EChannel{
+        CH1         = 0,
+        CH2         = 1,
+        // 16 bit frames of CH1 and CH2
+        INTERLEAVED = 2
+    };
+
+    struct SRegion{
+        uint64_t offset;
+        uint64_t size;
+        EChannel channel;
+    };
+
+    using Ptr = std::shared_ptr<CMappedReader>;
+
+    // passes = 0 repeats the regions endlessly
+    static auto create(const std::string &_filePath,const std::vector<SRegion> &_regions,uint32_t _passes) -> Ptr;
+
+    CMappedReader(const std::string &_filePath,const std::vector<SRegion> &_regions,uint32_t _passes);
+    ~CMappedReader();
+
+    auto open() -> bool;
+    auto close() -> void;
+
+    // Region at the read position. Returns false at the end of the pass
+    auto getRegion(EChannel *_channel,uint64_t *_left) -> bool;
+    // Copies up to _size bytes of the current region. Returns the copied size, 0 at the end of the pass
+    auto read(uint8_t *_dst,size_t _size) -> size_t;
+    // Starts the next pass. After the last pass the file is read again from the beginning
+    auto nextPass() -> bool;
+
+    auto getUnderrunCount() -> uint64_t;
+
+private:
+
+    CMappedReader(const CMappedReader &) = delete;
+    CMappedReader(CMappedReader &&) = delete;
+    CMappedReader& operator=(const CMappedReader&) =delete;
+    CMappedReader& operator=(const CMappedReader&&) =delete;
+
+    struct SWindow{
+        const uint8_t *map = nullptr;
+        uint64_t mapOffset = 0;
+        size_t   mapSize = 0;
+        uint64_t begin = 0;
+        uint64_t end = 0;
+        uint32_t pass = 0;
+    };
+
+    auto startReadAhead() -> void;
+    auto stopReadAhead() -> void;
+    auto readAheadThread() -> void;
+    auto mapWindow(uint64_t _begin,uint64_t _end,uint32_t _pass,SWindow *_window) -> bool;
+    auto unmapWindow(SWindow &_window) -> void;
+    // Window with the position of the current pass. Waits for the read-ahead thread if needed
+    auto getWindow(uint64_t _position) -> SWindow*;
+
+    std::string m_filePath;
+    std::vector<SRegion> m_regions;
+    uint32_t m_passes;
+    uint64_t m_begin;
+    uint64_t m_end;
+    int      m_fd;
+
+    DataLib::CSPSCQueue<SWindow> m_windows;
+    std::thread m_thread;
+    std::atomic<bool> m_stop;
+    std::atomic<bool> m_readAheadDone;
+    std::mutex m_mtx;
+    std::condition_variable m_readCond;
+    std::condition_variable m_readAheadCond;
+
+    uint32_t m_pass;
+    size_t   m_region;
+    uint64_t m_regionPos;
+    std::atomic<uint64_t> m_underruns;
+};
+
+#endif
@@ -1,6 +1,9 @@
 #include "reader_controller.h"
+#include "data_lib/stream_kernels.h"
 
 constexpr size_t g_max_buff = 32 * 1024;
+// Read size for WAV files read through mmap
+constexpr size_t g_mapped_chunk = 256 * 1024;
 
 CReaderController::CReaderController(CStreamSettings::DataFormat _fileType, std::string _filePath,CStreamSettings::DACRepeat _repeat,int32_t _rep_count,uint64_t memoryCacheSize):
     m_fileType(_fileType),
@@ -9,6 +12,7 @@ CReaderController::CReaderController(CStreamSettings::DataFormat _fileType, std:
     m_rep_count(_rep_count),
     m_wavReader(nullptr),
     m_tdmsFile(nullptr),
+    m_binReader(nullptr),
     m_tdmsSegments(),
     m_currentSegment(0),
     m_currentMetadata(0),
@@ -20,7 +24,10 @@ CReaderController::CReaderController(CStreamSettings::DataFormat _fileType, std:
     m_checkEmptyFile(false),
     m_memoryCacheSize(memoryCacheSize),
     m_channel1Size(0),
-    m_channel2Size(0)
+    m_channel2Size(0),
+    m_mappedReader(nullptr),
+    m_mappedRegions(),
+    m_mappedTemp()
 {
     m_useMemoryCache = false;
 
@@ -35,9 +42,18 @@ CReaderController::CReaderController(CStreamSettings::DataFormat _fileType, std:
     if (m_fileType == CStreamSettings::DataFormat::TDMS){
         openTDMS();
     }
+
+    if (m_fileType == CStreamSettings::DataFormat::BIN){
+        openBin();
+    }
     m_result = checkFile();
     resetReadFromBuffer();
-    m_useMemoryCache = memoryCacheSize >= m_channel1Size || memoryCacheSize >= m_channel2Size;
+    m_useMemoryCache = memoryCacheSize >= m_channel1Size + m_channel2Size;
+    // Files that do not fit into the cache are read through mmap with read-ahead.
+    // The stream readers stay as fallback
+    if (!m_useMemoryCache && m_result == OpenResult::OR_OK){
+        openMapped();
+    }
 }
 
 void CReaderController::TemperaryBuffer::deleteBuffer(){
@@ -50,10 +66,12 @@ void CReaderController::TemperaryBuffer::deleteBuffer(){
 }
 
 CReaderController::~CReaderController(){
+    m_mappedReader = nullptr;
     m_tempBuffer[0].deleteBuffer();
     m_tempBuffer[1].deleteBuffer();
     if (m_wavReader) delete m_wavReader;
     if (m_tdmsFile) delete m_tdmsFile;
+    if (m_binReader) bin_reader_close(m_binReader);
 }
 
 auto CReaderController::openWav() -> bool{
@@ -101,6 +119,52 @@ auto CReaderController::openTDMS() -> bool{
     return false;
 }
 
+auto CReaderController::openBin() -> bool{
+    if (m_fileType == CStreamSettings::DataFormat::BIN){
+        if (m_binReader) bin_reader_close(m_binReader);
+        m_binReader = bin_reader_open(m_filePath.c_str(),1);
+        if (!m_binReader){
+            std::cerr << "[CReaderController]: Error open bin file("<< m_filePath << ") " << std::endl;
+            return false;
+        }
+        m_currentSegment = 0;
+        m_result = OpenResult::OR_OK;
+        return true;
+    }
+    return false;
+}
+
+auto CReaderController::openMapped() -> bool{
+    std::vector<CMappedReader::SRegion> regions;
+    if (m_fileType == CStreamSettings::DataFormat::WAV && m_wavReader){
+        auto header = m_wavReader->getHeader();
+        auto channel = header.NumOfChan == 2 ? CMappedReader::INTERLEAVED : CMappedReader::CH1;
+        regions.push_back({sizeof(header),m_wavReader->getDataSize(),channel});
+    }
+    if (m_fileType == CStreamSettings::DataFormat::TDMS){
+        regions = m_mappedRegions;
+    }
+    if (regions.empty()){
+        return false;
+    }
+    uint32_t passes = 1;
+    if (m_repeat == CStreamSettings::DACRepeat::DAC_REP_INF){
+        passes = 0;
+    }
+    if (m_repeat == CStreamSettings::DACRepeat::DAC_REP_ON){
+        passes = m_rep_count;
+    }
+    auto reader = CMappedReader::create(m_filePath,regions,passes);
+    if (!reader->open()){
+        return false;
+    }
+    m_mappedReader = reader;
+    return true;
+}
+
+auto CReaderController::getUnderrunCount() -> uint64_t{
+    return m_mappedReader ? m_mappedReader->getUnderrunCount() : 0;
+}
 
 auto CReaderController::resetReadFromBuffer() -> bool{
     if (m_useMemoryCache){
@@ -119,6 +183,10 @@ auto CReaderController::resetReadFromBuffer() -> bool{
         m_tempBuffer[1].deleteBuffer();
         m_checkEmptyFile = true;
 
+        if (m_mappedReader){
+            return m_mappedReader->nextPass();
+        }
+
         if (m_fileType == CStreamSettings::DataFormat::WAV){
             return openWav();
         }
@@ -130,6 +198,12 @@ auto CReaderController::resetReadFromBuffer() -> bool{
             moveNextMetadata();
             return true;
         }
+
+        if (m_fileType == CStreamSettings::DataFormat::BIN){
+            // The index is kept, only the read position is reset
+            m_currentSegment = 0;
+            return m_binReader != nullptr;
+        }
     }
     return false;
 }
@@ -150,27 +224,45 @@ auto CReaderController::writeFromTemp(uint8_t **buff,size_t max_size,size_t *wri
 }
 
 
+auto CReaderController::getPreparedSize() -> size_t{
+    return g_max_buff;
+}
+
 auto CReaderController::getBufferPrepared(uint8_t **ch1,size_t *size_ch1, uint8_t **ch2,size_t *size_ch2) -> BufferResult{
-    auto fillZero = [](uint8_t **ch,size_t *size){
-        if (*ch){
-            if (0 != *size){
-                memset((&(**ch) + *size),0,g_max_buff - *size);
-                *size = g_max_buff;
-            }else{
-                delete [] *ch;
-                *ch = nullptr;
-                *size = 0;
-            }
-        }
-    };
-    *size_ch1 = 0;
-    *size_ch2 = 0;
     if (m_channel1Present){
         *ch1 = new uint8_t[g_max_buff];
     }
     if (m_channel2Present){
         *ch2 = new uint8_t[g_max_buff];
     }
+    auto res = readPrepared(ch1,size_ch1,ch2,size_ch2);
+    if (*ch1 && *size_ch1 == 0){
+        delete [] *ch1;
+        *ch1 = nullptr;
+    }
+    if (*ch2 && *size_ch2 == 0){
+        delete [] *ch2;
+        *ch2 = nullptr;
+    }
+    return res;
+}
+
+auto CReaderController::getBufferPreparedTo(uint8_t *ch1,size_t *size_ch1, uint8_t *ch2,size_t *size_ch2) -> BufferResult{
+    uint8_t *buff1 = m_channel1Present ? ch1 : nullptr;
+    uint8_t *buff2 = m_channel2Present ? ch2 : nullptr;
+    return readPrepared(&buff1,size_ch1,&buff2,size_ch2);
+}
+
+// Fills the given buffers up to g_max_buff. A buffer that stays empty keeps size 0
+auto CReaderController::readPrepared(uint8_t **ch1,size_t *size_ch1, uint8_t **ch2,size_t *size_ch2) -> BufferResult{
+    auto fillZero = [](uint8_t **ch,size_t *size){
+        if (*ch && 0 != *size){
+            memset((&(**ch) + *size),0,g_max_buff - *size);
+            *size = g_max_buff;
+        }
+    };
+    *size_ch1 = 0;
+    *size_ch2 = 0;
     while(1) {
         if (*ch1){
             if (m_tempBuffer[0].size > 0 && !m_tempBuffer[0].isEnded()){
@@ -274,12 +366,18 @@ auto CReaderController::getBufferPrepared(uint8_t **ch1,size_t *size_ch1, uint8_
 }
 
 auto CReaderController::getBuffer(uint8_t **ch1,size_t *size_ch1, uint8_t **ch2,size_t *size_ch2) -> bool{
+    if (m_mappedReader){
+        return getBufferMapped(ch1,size_ch1,ch2,size_ch2);
+    }
     if (m_fileType == CStreamSettings::DataFormat::WAV){
         return getBufferWav(ch1,size_ch1,ch2,size_ch2);
     }
     if (m_fileType == CStreamSettings::DataFormat::TDMS){
         return getBufferTdms(ch1,size_ch1,ch2,size_ch2);
     }
+    if (m_fileType == CStreamSettings::DataFormat::BIN){
+        return getBufferBin(ch1,size_ch1,ch2,size_ch2);
+    }
     return false;
 }
 
@@ -306,6 +404,57 @@ auto CReaderController::getBufferWav(uint8_t **ch1,size_t *size_ch1, uint8_t **c
     return false;
 }
 
+// TDMS regions are returned whole, the same as getBufferTdms() returns one channel of a segment
+auto CReaderController::getBufferMapped(uint8_t **ch1,size_t *size_ch1, uint8_t **ch2,size_t *size_ch2) -> bool{
+    try{
+        CMappedReader::EChannel channel;
+        uint64_t left = 0;
+        if (!m_mappedReader->getRegion(&channel,&left)){
+            return false;
+        }
+        if (channel == CMappedReader::INTERLEAVED){
+            auto size = (size_t)std::min<uint64_t>(left,g_mapped_chunk);
+            m_mappedTemp.resize(size);
+            size = m_mappedReader->read(m_mappedTemp.data(),size);
+            auto samples = size / 4;
+            if (samples == 0){
+                return false;
+            }
+            *ch1 = new uint8_t[samples * 2];
+            *ch2 = new uint8_t[samples * 2];
+            split_2ch_16bit((int16_t*)*ch1,(int16_t*)*ch2,(const int16_t*)m_mappedTemp.data(),samples);
+            *size_ch1 = samples * 2;
+            *size_ch2 = samples * 2;
+            return true;
+        }
+
+        auto size = m_fileType == CStreamSettings::DataFormat::WAV ? std::min<uint64_t>(left,g_mapped_chunk) : left;
+        auto buffer = new uint8_t[size];
+        size = m_mappedReader->read(buffer,size);
+        if (size == 0){
+            delete[] buffer;
+            return false;
+        }
+        if (channel == CMappedReader::CH1){
+            *ch1 = buffer;
+            *size_ch1 = size;
+        }else{
+            *ch2 = buffer;
+            *size_ch2 = size;
+        }
+        return true;
+    }catch (const std::bad_alloc& e) {
+        if (*ch1) delete[] *ch1;
+        *ch1 = nullptr;
+        if (*ch2) delete[] *ch2;
+        *ch2 = nullptr;
+        *size_ch1 = 0;
+        *size_ch2 = 0;
+        std::cout << "[CReaderController]: Error Allocation failed: " << e.what() << '\n';
+    }
+    return false;
+}
+
 auto CReaderController::getBufferFull(uint8_t **ch1,size_t *size_ch1, uint8_t **ch2,size_t *size_ch2) -> void{
     try{
         if (m_channel1Present){
@@ -425,6 +574,45 @@ auto CReaderController::getBufferTdms(uint8_t **ch1,size_t *size_ch1, uint8_t **
     return false;
 }
 
+auto CReaderController::getBufferBin(uint8_t **ch1,size_t *size_ch1, uint8_t **ch2,size_t *size_ch2) -> bool{
+    if (!m_binReader || (m_channel1Present == false && m_channel2Present == false)){
+        return false;
+    }
+    try{
+        auto count = bin_reader_segments_count(m_binReader);
+        while(m_currentSegment < count){
+            auto segment = m_currentSegment++;
+            const uint8_t *data1 = nullptr;
+            const uint8_t *data2 = nullptr;
+            size_t size1 = 0;
+            size_t size2 = 0;
+            if (m_channel1Present && bin_reader_channel_data(m_binReader,segment,0,&data1,&size1) == 0 && size1){
+                *ch1 = new uint8_t[size1];
+                memcpy_neon(*ch1, data1, size1);
+            }
+            // Data pointer is valid until the next call
+            if (m_channel2Present && bin_reader_channel_data(m_binReader,segment,1,&data2,&size2) == 0 && size2){
+                *ch2 = new uint8_t[size2];
+                memcpy_neon(*ch2, data2, size2);
+            }
+            *size_ch1 = *ch1 ? size1 : 0;
+            *size_ch2 = *ch2 ? size2 : 0;
+            if (*size_ch1 || *size_ch2){
+                return true;
+            }
+        }
+    }catch (const std::bad_alloc& e) {
+        if (*ch1) delete[] *ch1;
+        *ch1 = nullptr;
+        if (*ch2) delete[] *ch2;
+        *ch2 = nullptr;
+        *size_ch1 = 0;
+        *size_ch2 = 0;
+        std::cout << "[CReaderController]: Error Allocation failed: " << e.what() << '\n';
+    }
+    return false;
+}
+
 auto CReaderController::moveNextMetadata() -> bool{
     do{
         if (m_currentVecMetadataPtr.empty()){
@@ -463,6 +651,9 @@ auto CReaderController::checkFile() -> OpenResult{
     if (m_fileType == CStreamSettings::DataFormat::WAV){
         return checkWavFile();
     }
+    if (m_fileType == CStreamSettings::DataFormat::BIN){
+        return checkBinFile();
+    }
     return OpenResult::OR_CLOSE;
 }
 
@@ -515,15 +706,20 @@ auto CReaderController::checkTDMSFile() -> OpenResult{
     size_t channel2DataSize = 0;
     bool channel1WrongType = false;
     bool channel2WrongType = false;
+    bool interleaved = false;
+    m_mappedRegions.clear();
 
 
     if (m_tdmsFile){
         for(auto &seg : m_tdmsSegments){
-            auto meta = m_tdmsFile->GetMetadata(seg);
+            auto meta = m_tdmsFile->GetMetadataLayout(seg);
             for(auto &m: meta){
                 if (m->PathStr == "/'Group'/'ch1'"){
                     channel1 = true;
                     channel1DataSize += m->RawData.Size;
+                    if (m->RawData.Size > 0)
+                        m_mappedRegions.push_back({(uint64_t)m->RawData.Offset,(uint64_t)m->RawData.Size,CMappedReader::CH1});
+                    interleaved |= m->RawData.IsInterleaved;
                     auto type = m->RawData.DataType.GetDataType();
                     switch (type) {
                         case TDMS::TDMSType::Integer16:
@@ -537,6 +733,9 @@ auto CReaderController::checkTDMSFile() -> OpenResult{
                 if (m->PathStr == "/'Group'/'ch2'"){
                     channel2 = true;
                     channel2DataSize += m->RawData.Size;
+                    if (m->RawData.Size > 0)
+                        m_mappedRegions.push_back({(uint64_t)m->RawData.Offset,(uint64_t)m->RawData.Size,CMappedReader::CH2});
+                    interleaved |= m->RawData.IsInterleaved;
                     auto type = m->RawData.DataType.GetDataType();
                     switch (type) {
                         case TDMS::TDMSType::Integer16:
@@ -548,6 +747,9 @@ auto CReaderController::checkTDMSFile() -> OpenResult{
                 }
             }
         }
+        if (interleaved){
+            m_mappedRegions.clear();
+        }
         if (channel1WrongType || channel2WrongType) return OpenResult::OR_WRONG_DATA_TYPE;
         if (channel1 || channel2){
             if (channel1DataSize != 0 && channel2DataSize != 0  && channel1DataSize != channel2DataSize){
@@ -564,3 +766,39 @@ auto CReaderController::checkTDMSFile() -> OpenResult{
     }
     return OpenResult::OR_CLOSE;
 }
+
+auto CReaderController::checkBinFile() -> OpenResult{
+    if (m_binReader){
+        bool channelWrongType = false;
+        size_t channelDataSize[2] = {0,0};
+        auto count = bin_reader_segments_count(m_binReader);
+        for(uint64_t i = 0; i < count; i++){
+            bin_segment_info_t info;
+            if (bin_reader_segment_info(m_binReader,i,&info) != 0){
+                return OpenResult::OR_CLOSE;
+            }
+            for(int ch = 0; ch < 2; ch++){
+                if (info.size_ch[ch]){
+                    channelDataSize[ch] += info.size_ch[ch];
+                    if (info.format_size[ch] != 2){
+                        channelWrongType = true;
+                    }
+                }
+            }
+        }
+        if (channelWrongType) return OpenResult::OR_WRONG_DATA_TYPE;
+        if (channelDataSize[0] || channelDataSize[1]){
+            if (channelDataSize[0] != 0 && channelDataSize[1] != 0  && channelDataSize[0] != channelDataSize[1]){
+                return OpenResult::OR_DATA_NOT_EQUAL;
+            }
+            m_channel1Present = channelDataSize[0] != 0;
+            m_channel2Present = channelDataSize[1] != 0;
+            m_channel1Size = channelDataSize[0];
+            m_channel2Size = channelDataSize[1];
+            return OpenResult::OR_OK;
+        }else{
+            return OpenResult::OR_MISSING_CHANNELS;
+        }
+    }
+    return OpenResult::OR_CLOSE;
+}
@@ -12,6 +12,8 @@
 #include "settings_lib/stream_settings.h"
 #include "wav_lib/wav_reader.h"
 #include "tdms_lib/file.h"
+#include "bin_reader_api.h"
+#include "mapped_reader.h"
 
 
 /**
@@ -48,6 +50,11 @@ class CReaderController
         auto isOpen() -> CReaderController::OpenResult;
         auto checkFile() -> OpenResult;
         auto getBufferPrepared(uint8_t **ch1,size_t *size_ch1, uint8_t **ch2,size_t *size_ch2) -> BufferResult;
+        // Same as getBufferPrepared, but fills buffers owned by the caller. Each buffer must hold getPreparedSize() bytes
+        auto getBufferPreparedTo(uint8_t *ch1,size_t *size_ch1, uint8_t *ch2,size_t *size_ch2) -> BufferResult;
+        static auto getPreparedSize() -> size_t;
+        // Times the file reader could not keep up. Counted only for files read through mmap
+        auto getUnderrunCount() -> uint64_t;
 
     private:
 
@@ -69,14 +76,20 @@ class CReaderController
 
         auto checkTDMSFile() -> OpenResult;
         auto checkWavFile() -> OpenResult;
+        auto checkBinFile() -> OpenResult;
         auto getBufferFull(uint8_t **ch1,size_t *size_ch1, uint8_t **ch2,size_t *size_ch2) -> void;
         auto getBuffer(uint8_t **ch1,size_t *size_ch1, uint8_t **ch2,size_t *size_ch2) -> bool;
         auto getBufferWav(uint8_t **ch1,size_t *size_ch1, uint8_t **ch2,size_t *size_ch2) -> bool;
         auto getBufferTdms(uint8_t **ch1,size_t *size_ch1, uint8_t **ch2,size_t *size_ch2) -> bool;
+        auto getBufferBin(uint8_t **ch1,size_t *size_ch1, uint8_t **ch2,size_t *size_ch2) -> bool;
         auto openWav() -> bool;
         auto openTDMS() -> bool;
+        auto openBin() -> bool;
+        auto openMapped() -> bool;
+        auto getBufferMapped(uint8_t **ch1,size_t *size_ch1, uint8_t **ch2,size_t *size_ch2) -> bool;
         auto moveNextMetadata() -> bool;
         auto resetReadFromBuffer() -> bool;
+        auto readPrepared(uint8_t **ch1,size_t *size_ch1, uint8_t **ch2,size_t *size_ch2) -> BufferResult;
         auto writeFromTemp(uint8_t **buff,size_t max_size,size_t *write_pos,CReaderController::TemperaryBuffer *temp_buf) -> void;
 
         CStreamSettings::DataFormat         m_fileType;
@@ -85,6 +98,7 @@ class CReaderController
         int32_t                             m_rep_count;
         CWaveReader                        *m_wavReader;
         TDMS::File                         *m_tdmsFile;
+        bin_reader_t                       *m_binReader;
         vector<shared_ptr<TDMS::Segment>>   m_tdmsSegments;
         uint32_t                            m_currentSegment;
         uint32_t                            m_currentMetadata;
@@ -96,9 +110,12 @@ class CReaderController
         TemperaryBuffer                     m_tempBuffer[2];
         bool                                m_checkEmptyFile;
         uint64_t                            m_memoryCacheSize;
-        size_t                              m_channel1Size;
-        size_t                              m_channel2Size;
+        uint64_t                            m_channel1Size;
+        uint64_t                            m_channel2Size;
         bool                                m_useMemoryCache;
+        CMappedReader::Ptr                  m_mappedReader;
+        vector<CMappedReader::SRegion>      m_mappedRegions;
+        vector<uint8_t>                     m_mappedTemp;
 };
 
 #endif
@@ -53,6 +53,9 @@ CStreamSettings::CStreamSettings(){
     m_attenuator = 0;
     m_calib = false;
     m_ac_dc = 0xF;
+    m_zero_copy = false;
+    m_direct_write = false;
+    m_file_memory_limit = 0;
 
     m_dac_gain = 0;
     m_dac_file_type = WAV;
@@ -62,6 +65,7 @@ CStreamSettings::CStreamSettings(){
     m_dac_memoryUsage = 1024 * 1024;
     m_dac_repeatCount = 0;
     m_dac_speed_Hz = 0;
+    m_dac_interrupt = false;
 
     m_loopback_timeout = 10;
     m_loopback_speed_Hz = -1;
@@ -119,6 +123,9 @@ auto CStreamSettings::resetDefault() -> void{
     setDecimation(1);
     setCalibration(false);
     setAC_DC(0xF);
+    setZeroCopy(false);
+    setDirectWrite(false);
+    setFileMemoryLimit(0);
 
     setDACGain(0);
     setDACFileType(WAV);
@@ -128,6 +135,7 @@ auto CStreamSettings::resetDefault() -> void{
     setDACMemoryUsage(1024 * 1024);
     setDACRepeatCount(0);
     setDACHz(0);
+    setDACInterrupt(false);
 
     setLoopbackTimeout(10);
     setLoopbackSpeed(-1);
@@ -163,6 +171,9 @@ auto CStreamSettings::copy(const CStreamSettings &src) -> void{
     m_attenuator = src.m_attenuator;
     m_calib = src.m_calib;
     m_ac_dc = src.m_ac_dc;
+    m_zero_copy = src.m_zero_copy;
+    m_direct_write = src.m_direct_write;
+    m_file_memory_limit = src.m_file_memory_limit;
 
     m_dac_gain  = src.m_dac_gain;
     m_dac_file_type  = src.m_dac_file_type;
@@ -172,6 +183,7 @@ auto CStreamSettings::copy(const CStreamSettings &src) -> void{
     m_dac_memoryUsage  = src.m_dac_memoryUsage;
     m_dac_repeatCount  = src.m_dac_repeatCount;
     m_dac_speed_Hz  = src.m_dac_speed_Hz;
+    m_dac_interrupt  = src.m_dac_interrupt;
 
     m_loopback_timeout  = src.m_loopback_timeout;
     m_loopback_speed_Hz  = src.m_loopback_speed_Hz;
@@ -209,6 +221,9 @@ bool CStreamSettings::writeToFile(string _filename){
         adc_config["attenuator"] = getAttenuator();
         adc_config["calibration"] = getCalibration();
         adc_config["coupling"] = getAC_DC();
+        adc_config["zero_copy"] = getZeroCopy();
+        adc_config["direct_write"] = getDirectWrite();
+        adc_config["file_memory_limit"] = getFileMemoryLimit();
 
         dac_config["dac_file"] = getDACFile();
         dac_config["dac_file_type"] = getDACFileType();
@@ -219,6 +234,7 @@ bool CStreamSettings::writeToFile(string _filename){
         dac_config["dac_port"] = getDACPort();
         dac_config["dac_memoryUsage"] = getDACMemoryUsage();
         dac_config["dac_speed"] = getDACHz();
+        dac_config["dac_interrupt"] = getDACInterrupt();
 
         loopback_config["timeout"] = getLoopbackTimeout();
         loopback_config["dac_speed"] = getLoopbackSpeed();
@@ -270,6 +286,9 @@ auto CStreamSettings::getJson()-> std::string{
         adc_config["attenuator"] = getAttenuator();
         adc_config["calibration"] = getCalibration();
         adc_config["coupling"] = getAC_DC();
+        adc_config["zero_copy"] = getZeroCopy();
+        adc_config["direct_write"] = getDirectWrite();
+        adc_config["file_memory_limit"] = getFileMemoryLimit();
 
         dac_config["dac_file"] = getDACFile();
         dac_config["dac_file_type"] = getDACFileType();
@@ -280,6 +299,7 @@ auto CStreamSettings::getJson()-> std::string{
         dac_config["dac_port"] = getDACPort();
         dac_config["dac_memoryUsage"] = getDACMemoryUsage();
         dac_config["dac_speed"] = getDACHz();
+        dac_config["dac_interrupt"] = getDACInterrupt();
 
         loopback_config["timeout"] = getLoopbackTimeout();
         loopback_config["dac_speed"] = getLoopbackSpeed();
@@ -420,6 +440,10 @@ auto CStreamSettings::String()-> std::string{
         }
         str = str + "Mode:\t\t\t" + savetype  + "\n";
 
+        str = str + "Zero copy:\t\t" + (getZeroCopy() ? "Enable" : "Disable")  +" (In network mode)\n";
+        str = str + "Direct write:\t\t" + (getDirectWrite() ? "Enable" : "Disable")  +" (In file mode)\n";
+        str = str + "File memory limit:\t" + (getFileMemoryLimit() == 0 ? "Auto" : std::to_string(getFileMemoryLimit()) + " Mb")  +" (In file mode)\n";
+
         str = str + "Samples:\t\t" + (getSamples() == -1 ? "Unlimited" : std::to_string(getSamples()))  +" (In file mode)\n";
 
         std::string  format = "ERROR";
@@ -492,6 +516,7 @@ auto CStreamSettings::String()-> std::string{
         str = str + "DAC repeat count:\t" + std::to_string(getDACRepeatCount())  +" (In DAC file mode)\n";
         str = str + "DAC memory cache:\t" + std::to_string(getDACMemoryUsage())  +" (In DAC file mode)\n";
         str = str + "DAC speed (Hz):\t\t" + std::to_string(getDACHz())  +"\n";
+        str = str + "DAC interrupt:\t\t" + (getDACInterrupt() ? "Enable" : "Disable")  +"\n";
 
 
         std::string  dac_gain = "";
@@ -786,6 +811,12 @@ auto CStreamSettings::readFromFile(string _filename) -> bool {
         setCalibration(adc_config["calibration"].asBool());
     if (adc_config.isMember("coupling"))
         setAC_DC(static_cast<uint8_t>(adc_config["coupling"].asInt()));
+    if (adc_config.isMember("zero_copy"))
+        setZeroCopy(adc_config["zero_copy"].asBool());
+    if (adc_config.isMember("direct_write"))
+        setDirectWrite(adc_config["direct_write"].asBool());
+    if (adc_config.isMember("file_memory_limit"))
+        setFileMemoryLimit(adc_config["file_memory_limit"].asUInt());
 
 
     if (dac_config.isMember("dac_file_type"))
@@ -806,6 +837,8 @@ auto CStreamSettings::readFromFile(string _filename) -> bool {
         setDACMemoryUsage(dac_config["dac_memoryUsage"].asInt64());
     if (dac_config.isMember("dac_speed"))
         setDACHz(dac_config["dac_speed"].asInt());
+    if (dac_config.isMember("dac_interrupt"))
+        setDACInterrupt(dac_config["dac_interrupt"].asBool());
 
     if (loopback_config.isMember("timeout"))
         setLoopbackTimeout(loopback_config["timeout"].asInt());
@@ -981,6 +1014,21 @@ auto CStreamSettings::setValue(std::string key,int64_t value) -> bool{
         return true;
     }
 
+    if (key == "zero_copy") {
+        setZeroCopy(static_cast<bool>(value));
+        return true;
+    }
+
+    if (key == "direct_write") {
+        setDirectWrite(static_cast<bool>(value));
+        return true;
+    }
+
+    if (key == "file_memory_limit") {
+        setFileMemoryLimit(static_cast<uint32_t>(value));
+        return true;
+    }
+
     if (key == "dac_file_type") {
         setDACFileType(static_cast<DataFormat>(value));
         return true;
@@ -1011,6 +1059,11 @@ auto CStreamSettings::setValue(std::string key,int64_t value) -> bool{
         return true;
     }
 
+    if (key == "dac_interrupt") {
+        setDACInterrupt(static_cast<bool>(value));
+        return true;
+    }
+
     if (key == "dac_speed") {
         setDACHz(static_cast<uint32_t>(value));
         return true;
@@ -1070,6 +1123,33 @@ auto CStreamSettings::getCalibration() const -> bool{
     return m_calib;
 }
 
+// Optional setting. It is not tracked in m_var_changed, so configs and clients without it stay valid.
+auto CStreamSettings::setZeroCopy(bool _value) -> void{
+    m_zero_copy = _value;
+}
+
+auto CStreamSettings::getZeroCopy() const -> bool{
+    return m_zero_copy;
+}
+
+// Optional setting. O_DIRECT writes with several blocks in flight, file mode only.
+auto CStreamSettings::setDirectWrite(bool _value) -> void{
+    m_direct_write = _value;
+}
+
+auto CStreamSettings::getDirectWrite() const -> bool{
+    return m_direct_write;
+}
+
+// Optional setting. Hard limit in Mb for blocks waiting to be written to file, 0 - half of physical memory.
+auto CStreamSettings::setFileMemoryLimit(uint32_t _value) -> void{
+    m_file_memory_limit = _value;
+}
+
+auto CStreamSettings::getFileMemoryLimit() const -> uint32_t{
+    return m_file_memory_limit;
+}
+
 auto CStreamSettings::setAC_DC(uint8_t _value) -> void{
     m_ac_dc = _value;
     m_var_changed["m_ac_dc"] = true;
@@ -1174,6 +1254,15 @@ auto CStreamSettings::setDACMemoryUsage(int64_t _value) -> void{
     m_var_changed["m_dac_memoryUsage"] = true;
 }
 
+// Optional setting. The generator thread sleeps on the DMA interrupt and uses a fixed buffer pool
+auto CStreamSettings::setDACInterrupt(bool _value) -> void{
+    m_dac_interrupt = _value;
+}
+
+auto CStreamSettings::getDACInterrupt() const -> bool{
+    return m_dac_interrupt;
+}
+
 auto CStreamSettings::setDACRepeatCount(uint32_t _value) -> void{
     m_dac_repeatCount = _value;
     m_var_changed["m_dac_repeatCount"] = true;
@@ -126,6 +126,15 @@ public:
     auto setCalibration(bool _calibration) -> void;
     auto getCalibration() const -> bool;
 
+    auto setZeroCopy(bool _value) -> void;
+    auto getZeroCopy() const -> bool;
+
+    auto setDirectWrite(bool _value) -> void;
+    auto getDirectWrite() const -> bool;
+
+    auto setFileMemoryLimit(uint32_t _value) -> void;
+    auto getFileMemoryLimit() const -> uint32_t;
+
     auto setAC_DC(uint8_t _value) -> void;
     auto setAC_DC(Channel _channel,AC_DC _value) -> void;
     auto getAC_DC() const -> uint8_t;
@@ -153,6 +162,8 @@ public:
     auto setDACPort(std::string _port) -> void;
     auto getDACMemoryUsage() const -> int64_t;
     auto setDACMemoryUsage(int64_t _value) -> void;
+    auto setDACInterrupt(bool _value) -> void;
+    auto getDACInterrupt() const -> bool;
 
     auto getLoopbackTimeout() const -> uint32_t;
     auto setLoopbackTimeout(uint32_t value) -> void;
@@ -183,6 +194,9 @@ private:
     uint8_t         m_attenuator;
     bool            m_calib;
     uint8_t         m_ac_dc;
+    bool            m_zero_copy;
+    bool            m_direct_write;
+    uint32_t        m_file_memory_limit;
 
     uint8_t         m_dac_gain;
     DataFormat      m_dac_file_type;
@@ -192,6 +206,7 @@ private:
     int64_t         m_dac_memoryUsage;
     uint32_t        m_dac_repeatCount;
     uint32_t        m_dac_speed_Hz;
+    bool            m_dac_interrupt;
 
     uint32_t         m_loopback_timeout;
     int32_t          m_loopback_speed_Hz;
@@ -1,4 +1,5 @@
 #include <stdint.h>
+#include <chrono>
 #include <iostream>
 #include <fstream>
 #include <time.h>
@@ -16,10 +17,14 @@ auto CStreamingBufferCached::create(uint32_t maxRamSize) -> CStreamingBufferCach
 
 CStreamingBufferCached::CStreamingBufferCached(uint32_t maxRamSize) :
     m_buffers(),
+    m_ringSize(0),
+    m_consumers(0),
+    m_maxOccupancy(0),
+    m_overruns(0),
+    m_pendingLost(),
     m_maxRamSize(0),
-//    m_currentRamSize(0),
     m_needDestroy(false),
-    m_dropedPack(nullptr)
+    m_waiters(0)
 {
     setMaxRamSize(maxRamSize);
 }
@@ -27,20 +32,27 @@ CStreamingBufferCached::CStreamingBufferCached(uint32_t maxRamSize) :
 CStreamingBufferCached::~CStreamingBufferCached()
 {
     std::lock_guard<std::mutex> lock(m_mtx);
-    notifyToDestory();    
+    notifyToDestory();
     m_buffers.clear();
 }
 
 auto CStreamingBufferCached::addChannel(DataLib::EDataBuffersPackChannel ch,size_t size,uint8_t bitBySample) -> void{
     m_channelsSize[ch] = {size,bitBySample};
 }
-    
+
 
 auto CStreamingBufferCached::generateBuffers() -> void{
+    std::lock_guard<std::mutex> lock(m_mtx);
     auto allSize = 0;
-    m_ringStart = 0;
-    m_ringEnd = 0;
+    m_buffers.clear();
     m_ringSize = 0;
+    m_writePos.m_pos = 0;
+    for(auto &c : m_readPos){
+        c.m_pos = 0;
+    }
+    m_maxOccupancy = 0;
+    m_overruns = 0;
+    m_pendingLost.fill(0);
     for(auto s:m_channelsSize){
         allSize += s.second.first;
     }
@@ -61,6 +73,23 @@ auto CStreamingBufferCached::generateBuffers() -> void{
     }
 }
 
+auto CStreamingBufferCached::addConsumer(ConsumerId *id) -> bool{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    auto count = m_consumers.load();
+    if (count >= MAX_CONSUMERS){
+        aprintf(stderr,"[CStreamingBufferCached] Consumers limit reached (%d)\n",MAX_CONSUMERS);
+        return false;
+    }
+    m_readPos[count].m_pos.store(m_writePos.m_pos.load(std::memory_order_acquire),std::memory_order_relaxed);
+    m_consumers.store(count + 1,std::memory_order_release);
+    *id = count;
+    return true;
+}
+
+auto CStreamingBufferCached::getConsumersCount() -> uint32_t{
+    return m_consumers;
+}
+
 auto CStreamingBufferCached::getMaxRamSize() -> uint64_t{
     return m_maxRamSize;
 }
@@ -74,6 +103,10 @@ auto CStreamingBufferCached::setMaxRamSize(uint64_t size) -> void{
 
 auto CStreamingBufferCached::notifyToDestory() -> bool{
     m_needDestroy = true;
+    {
+        std::lock_guard<std::mutex> lock(m_waitMtx);
+    }
+    m_waitCV.notify_all();
     return true;
 }
 
@@ -81,30 +114,73 @@ auto CStreamingBufferCached::isWaitToDestory() -> bool{
     return m_needDestroy;
 }
 
+inline auto CStreamingBufferCached::getMinReadPos() -> uint64_t{
+    auto count = m_consumers.load(std::memory_order_acquire);
+    // Without readers nothing has to be kept
+    if (count == 0){
+        return m_writePos.m_pos.load(std::memory_order_acquire);
+    }
+    auto minPos = m_readPos[0].m_pos.load(std::memory_order_acquire);
+    for(uint32_t i = 1; i < count; i++){
+        auto pos = m_readPos[i].m_pos.load(std::memory_order_acquire);
+        if (pos < minPos){
+            minPos = pos;
+        }
+    }
+    return minPos;
+}
+
+auto CStreamingBufferCached::getOccupancy() -> uint32_t{
+    auto minRead = getMinReadPos();
+    auto write = m_writePos.m_pos.load(std::memory_order_acquire);
+    return write > minRead ? (uint32_t)(write - minRead) : 0;
+}
+
 inline auto CStreamingBufferCached::getFreeSize() -> uint32_t{
-    return m_ringSize - (m_ringEnd < m_ringStart ? ((m_ringEnd + m_ringSize) - m_ringStart) : (m_ringEnd - m_ringSize));
+    return m_ringSize - getOccupancy();
 }
 
 auto CStreamingBufferCached::fullPercent() -> float{
-    auto usedBuff = (m_ringEnd < m_ringStart ? ((m_ringEnd + m_ringSize) - m_ringStart) : (m_ringEnd - m_ringSize));
-    return (float)usedBuff / (float)m_ringSize;
+    if (m_ringSize == 0){
+        return 0;
+    }
+    return (float)getOccupancy() / (float)m_ringSize;
+}
+
+auto CStreamingBufferCached::getRingSize() -> uint32_t{
+    return m_ringSize;
+}
+
+auto CStreamingBufferCached::getMaxOccupancy() -> uint32_t{
+    return m_maxOccupancy;
+}
+
+auto CStreamingBufferCached::getOverruns() -> uint64_t{
+    return m_overruns;
 }
 
 auto CStreamingBufferCached::getFreeBuffer(uint64_t fpga_lost) -> DataLib::CDataBuffersPack::Ptr{
-    std::lock_guard<std::mutex> lock(m_mtx);
     if (m_ringSize == 0){
         return nullptr;
     }
-    if (((m_ringEnd + 1) % m_ringSize) != m_ringStart){
-        auto pack = m_buffers[m_ringEnd];
+    auto write = m_writePos.m_pos.load(std::memory_order_relaxed);
+    auto pack = m_buffers[write % m_ringSize];
+    if (write - getMinReadPos() < m_ringSize){
+        for(int i = (int)DataLib::CH1; i <= (int)DataLib::CH4; i++){
+            auto buff = pack->getBuffer((DataLib::EDataBuffersPackChannel)i);
+            if (buff){
+                buff->setLostSamples(DataLib::RP_INTERNAL_BUFFER,m_pendingLost[i]);
+                m_pendingLost[i] = 0;
+            }
+        }
         return pack;
     }else{
+        m_overruns.fetch_add(1,std::memory_order_relaxed);
         for(int i = (int)DataLib::CH1; i <= (int)DataLib::CH4; i++){
-            auto pack = m_buffers[m_ringEnd];
             auto buff = pack->getBuffer((DataLib::EDataBuffersPackChannel)i);
             if (buff){
                 // increase lost data by one buffer + fpga lost
-                buff->setLostSamples(DataLib::RP_INTERNAL_BUFFER,buff->getLostSamples(DataLib::RP_INTERNAL_BUFFER) + buff->getSamplesCount() + fpga_lost);
+                m_pendingLost[i] += buff->getSamplesCount() + fpga_lost;
             }
         }
     }
@@ -112,20 +188,59 @@ auto CStreamingBufferCached::getFreeBuffer(uint64_t fpga_lost) -> DataLib::CData
 }
 
 auto CStreamingBufferCached::unlockBufferWrite() -> void{
-    std::lock_guard<std::mutex> lock(m_mtx);
-    m_ringEnd = (m_ringEnd + 1) % m_ringSize;
+    auto write = m_writePos.m_pos.load(std::memory_order_relaxed) + 1;
+    m_writePos.m_pos.store(write,std::memory_order_release);
+    auto occupancy = (uint32_t)(write - getMinReadPos());
+    if (occupancy > m_maxOccupancy.load(std::memory_order_relaxed)){
+        m_maxOccupancy.store(occupancy,std::memory_order_relaxed);
+    }
+    // The store above and the load below are seq_cst against waitBuffer, so
+    // either the waiter sees the new pack or we see the waiter.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_waiters.load(std::memory_order_relaxed)){
+        {
+            std::lock_guard<std::mutex> lock(m_waitMtx);
+        }
+        m_waitCV.notify_all();
+    }
 }
 
-auto CStreamingBufferCached::unlockBufferRead() -> void{
-    std::lock_guard<std::mutex> lock(m_mtx);
-    m_ringStart = (m_ringStart + 1) % m_ringSize;
+auto CStreamingBufferCached::unlockBufferRead(ConsumerId id) -> void{
+    if (id >= m_consumers.load(std::memory_order_acquire)){
+        return;
+    }
+    auto &cursor = m_readPos[id].m_pos;
+    auto read = cursor.load(std::memory_order_relaxed);
+    if (read != m_writePos.m_pos.load(std::memory_order_acquire)){
+        cursor.store(read + 1,std::memory_order_release);
+    }
 }
 
-auto CStreamingBufferCached::readBuffer() -> DataLib::CDataBuffersPack::Ptr{
-    std::lock_guard<std::mutex> lock(m_mtx);    
-    if (m_ringStart != m_ringEnd){
-        auto pack = m_buffers[m_ringStart];
-        return pack;
+auto CStreamingBufferCached::readBuffer(ConsumerId id) -> DataLib::CDataBuffersPack::Ptr{
+    if (m_ringSize == 0 || id >= m_consumers.load(std::memory_order_acquire)){
+        return nullptr;
+    }
+    auto read = m_readPos[id].m_pos.load(std::memory_order_relaxed);
+    if (read != m_writePos.m_pos.load(std::memory_order_acquire)){
+        return m_buffers[read % m_ringSize];
     }
     return nullptr;
-}
\ No newline at end of file
+}
+
+auto CStreamingBufferCached::waitBuffer(ConsumerId id,uint32_t timeoutMs) -> bool{
+    if (id >= m_consumers.load(std::memory_order_acquire)){
+        return false;
+    }
+    auto hasData = [this,id]() -> bool{
+        return m_needDestroy || m_readPos[id].m_pos.load(std::memory_order_acquire) != m_writePos.m_pos.load(std::memory_order_acquire);
+    };
+    if (hasData()){
+        return !m_needDestroy;
+    }
+    std::unique_lock<std::mutex> lock(m_waitMtx);
+    m_waiters.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    m_waitCV.wait_for(lock,std::chrono::milliseconds(timeoutMs),hasData);
+    m_waiters.fetch_sub(1);
+    return !m_needDestroy && hasData();
+}
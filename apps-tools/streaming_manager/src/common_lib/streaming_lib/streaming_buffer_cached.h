@@ -1,10 +1,13 @@
 #ifndef STREAMING_LIB_STREAMING_BUFFER_CACHED_H
 #define STREAMING_LIB_STREAMING_BUFFER_CACHED_H
 
+#include <atomic>
 #include <mutex>
+#include <condition_variable>
 #include <list>
 #include <deque>
 #include <map>
+#include <array>
 
 
 #include "data_lib/signal.hpp"
@@ -12,25 +15,40 @@
 
 namespace streaming_lib {
 
+/*
+ * Ring of preallocated packs. One producer (FPGA thread) and up to
+ * MAX_CONSUMERS readers, each with its own cursor. The producer never
+ * takes a lock: if the slowest reader did not free a slot, the pack is
+ * dropped and counted as overrun.
+ */
 class CStreamingBufferCached
 {
 public:
 
     using Ptr = std::shared_ptr<CStreamingBufferCached>;
-    
+    using ConsumerId = uint32_t;
+
+    static constexpr uint32_t MAX_CONSUMERS = 4;
+
     static auto create(uint32_t maxRamSize = 1024 * 1024 * 50) -> Ptr;
-    
+
     CStreamingBufferCached(uint32_t maxRamSize);
     ~CStreamingBufferCached();
-    
+
     auto addChannel(DataLib::EDataBuffersPackChannel ch,size_t size,uint8_t bitBySample) -> void;
-        
+
     auto generateBuffers() -> void;
 
+    // Must be called by every reader before streaming starts. Returns false if all MAX_CONSUMERS are taken.
+    auto addConsumer(ConsumerId *id) -> bool;
+    auto getConsumersCount() -> uint32_t;
+
     auto getFreeBuffer(uint64_t fpga_lost) -> DataLib::CDataBuffersPack::Ptr;
     auto unlockBufferWrite() -> void;
-    auto unlockBufferRead() -> void;
-    auto readBuffer() -> DataLib::CDataBuffersPack::Ptr;
+    auto unlockBufferRead(ConsumerId id) -> void;
+    auto readBuffer(ConsumerId id) -> DataLib::CDataBuffersPack::Ptr;
+    // Blocks until the consumer has a pack to read, the timeout expires or the buffer is destroyed
+    auto waitBuffer(ConsumerId id,uint32_t timeoutMs = 100) -> bool;
 
     auto getMaxRamSize() -> uint64_t;
     auto setMaxRamSize(uint64_t size) -> void;
@@ -38,6 +56,11 @@ public:
     auto notifyToDestory() -> bool;
     auto isWaitToDestory() -> bool;
 
+    auto getRingSize() -> uint32_t;
+    auto getOccupancy() -> uint32_t;
+    auto getMaxOccupancy() -> uint32_t;
+    auto getOverruns() -> uint64_t;
+
     sigslot::signal<uint64_t> maxRamNotify;
     sigslot::signal<> packDropNotify;
     sigslot::signal<> bufferFullNotify;
@@ -50,18 +73,34 @@ private:
     CStreamingBufferCached& operator=(const CStreamingBufferCached&) =delete;
     CStreamingBufferCached& operator=(const CStreamingBufferCached&&) =delete;
 
+    struct alignas(64) SCursor{
+        std::atomic<uint64_t> m_pos{0};
+    };
+
     auto getFreeSize() -> uint32_t;
+    auto getMinReadPos() -> uint64_t;
 
     std::vector<DataLib::CDataBuffersPack::Ptr> m_buffers;
-    uint32_t m_ringStart;
-    uint32_t m_ringEnd;
     uint32_t m_ringSize;
 
+    // Monotonic positions, slot index is pos % m_ringSize
+    SCursor m_writePos;
+    std::array<SCursor,MAX_CONSUMERS> m_readPos;
+    std::atomic<uint32_t> m_consumers;
+
+    std::atomic<uint32_t> m_maxOccupancy;
+    std::atomic<uint64_t> m_overruns;
+    std::array<uint64_t,4> m_pendingLost;
+
     std::map<DataLib::EDataBuffersPackChannel,std::pair<size_t,uint8_t>> m_channelsSize;
     uint64_t m_maxRamSize;
-    bool     m_needDestroy;
-    DataLib::CDataBuffersPack::Ptr m_dropedPack;
+    std::atomic_bool m_needDestroy;
     std::mutex m_mtx;
+
+    // The producer takes m_waitMtx only if somebody is waiting
+    std::atomic<uint32_t> m_waiters;
+    std::mutex m_waitMtx;
+    std::condition_variable m_waitCV;
 };
 
 }
@@ -8,6 +8,7 @@
 
 #include "streaming_file.h"
 #include "data_lib/neon_asm.h"
+#include "data_lib/volt_convert.h"
 #include "data_lib/thread_cout.h"
 
 #ifdef _WIN32
@@ -78,6 +79,7 @@ CStreamingFile::CStreamingFile(CStreamSettings::DataFormat _fileType,std::string
     m_file_out(""),
     m_samples(_samples),
     m_passSizeSamples(),
+    m_groupPassSizeSamples(),
     m_testMode(testMode),
     m_volt_mode(_v_mode),
     m_disableNotify(false),
@@ -110,6 +112,18 @@ auto CStreamingFile::disableNotify() -> void{
     m_disableNotify = true;
 }
 
+auto CStreamingFile::setDirectWrite(bool enable) -> void{
+    if (m_file_manager) {
+        m_file_manager->setDirectWrite(enable);
+    }
+}
+
+auto CStreamingFile::setMemoryLimit(uint64_t bytes) -> void{
+    if (m_file_manager) {
+        m_file_manager->setMemoryLimit(bytes);
+    }
+}
+
 auto CStreamingFile::isFileThreadWork() -> bool {
     if (m_file_manager) {
         return m_file_manager->isWork();
@@ -130,6 +144,7 @@ auto CStreamingFile::run(std::string _prefix) -> void {
     m_passSizeSamples[DataLib::CH2] = 0;
     m_passSizeSamples[DataLib::CH3] = 0;
     m_passSizeSamples[DataLib::CH4] = 0;
+    m_groupPassSizeSamples.clear();
 
     m_file_out = getNewFileName(m_fileType, m_filePath, _prefix);
     m_fileLogger = CFileLogger::create(m_file_out + ".log",m_testMode);
@@ -205,19 +220,15 @@ auto CStreamingFile::convertBuffers(DataLib::CDataBuffersPack::Ptr pack, DataLib
         auto dest = net_lib::createBuffer(destSize);
         if (dest){
             auto dest_f = (float*)dest.get();
+            // Gain is adcMode scaled by a power of two, so the result matches cnt / 2^(bits-1) * adcMode exactly
+            float gain = (float)adcMode / (float)(1 << (bitBySamp - 1));
 
-            for(uint32_t i = 0 ; i < samples; i++){
-                if (bitBySamp == 8) {
-                    int8_t* src_buff_bytes = (int8_t*)src_buff->getBuffer().get();
-                    float cnt = src_buff_bytes[i];
-                    dest_f[i] = cnt / ( 1 << (bitBySamp - 1)) * (float)adcMode;
-                }
+            if (bitBySamp == 8) {
+                convert_to_volt_8bit(dest_f,(const int8_t*)src_buff->getBuffer().get(),samples,gain,0);
+            }
 
-                if (bitBySamp == 16) {
-                    auto src_buff_bytes = (int16_t*)src_buff->getBuffer().get();
-                    float cnt = src_buff_bytes[i];
-                    dest_f[i] = cnt / ( 1 << (bitBySamp - 1)) * (float)adcMode;
-                }
+            if (bitBySamp == 16) {
+                convert_to_volt_16bit(dest_f,(const int16_t*)src_buff->getBuffer().get(),samples,gain,0);
             }
             memset(dest.get() + (samples * sizeof(float)), 0 , sizeof(float) * lostSamples);
         }
@@ -250,42 +261,65 @@ auto CStreamingFile::getCSVFileName() -> std::string{
 }
 
 
+auto CStreamingFile::convertPack(DataLib::CDataBuffersPack::Ptr pack,bool lockADCTo1V,std::map<DataLib::EDataBuffersPackChannel,SBuffPass> &map) -> bool {
+    bool noMemoryException = false;
+    for(auto i = (int)DataLib::CH1; i <= (int)DataLib::CH4; i++){
+        DataLib::EDataBuffersPackChannel ch = (DataLib::EDataBuffersPackChannel)i;
+        map[ch] = convertBuffers(pack,ch,lockADCTo1V);
+        if (map[ch].buffer == nullptr && map[ch].bufferLen){
+            noMemoryException = true;
+        }
+    }
+    return !noMemoryException;
+}
+
+auto CStreamingFile::limitSamples(std::map<DataLib::EDataBuffersPackChannel,SBuffPass> &map,std::map<DataLib::EDataBuffersPackChannel,uint64_t> &passSizeSamples) -> void {
+    if (m_samples == 0) return;
+    for(auto i = (int)DataLib::CH1; i <= (int)DataLib::CH4; i++){
+        DataLib::EDataBuffersPackChannel ch = (DataLib::EDataBuffersPackChannel)i;
+        if (map[ch].samplesCount + passSizeSamples[ch] > m_samples){
+            map[ch].samplesCount = m_samples - passSizeSamples[ch];
+            map[ch].bufferLen = map[ch].samplesCount * (map[ch].bitsBySample / 8);
+            passSizeSamples[ch] += map[ch].samplesCount;
+        }else{
+            passSizeSamples[ch] += map[ch].samplesCount;
+        }
+    }
+}
+
+auto CStreamingFile::isLimitReached(DataLib::CDataBuffersPack::Ptr pack,std::map<DataLib::EDataBuffersPackChannel,uint64_t> &passSizeSamples) -> bool {
+    for(auto i = (int)DataLib::CH1; i <= (int)DataLib::CH4; i++){
+        DataLib::EDataBuffersPackChannel ch = (DataLib::EDataBuffersPackChannel)i;
+        if (pack->isChannelPresent(ch)){
+            if (passSizeSamples[ch] < m_samples){
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+auto CStreamingFile::addMetrics(DataLib::CDataBuffersPack::Ptr pack) -> void {
+    for(auto i = (int)DataLib::CH1; i <= (int)DataLib::CH4; i++){
+        DataLib::EDataBuffersPackChannel ch = (DataLib::EDataBuffersPackChannel)i;
+        auto buff = pack->getBuffer(ch);
+        if (buff){
+            m_fileLogger->addMetric(CFileLogger::EMetric::RECIVE_DATE, buff->getBufferLenght());
+            m_fileLogger->addMetric(ch,buff->getBufferLenght(),buff->getLostSamples(DataLib::FPGA),buff->getLostSamples(DataLib::RP_INTERNAL_BUFFER),buff->getSamplesCount());
+        }
+    }
+    m_fileLogger->addMetric(CFileLogger::EMetric::OSC_RATE,pack->getOSCRate());
+    m_fileLogger->addMetric(pack);
+}
+
 auto CStreamingFile::passBuffers(DataLib::CDataBuffersPack::Ptr pack) -> int {
     if (!pack) return 0;
     if (m_fileType == CStreamSettings::TDMS) {
         // _adc_mode = 0 for 1:1 and 1 for 1:20 mode
-
-        auto bufferCh1 = convertBuffers(pack,DataLib::CH1,false);
-        auto bufferCh2 = convertBuffers(pack,DataLib::CH2,false);
-        auto bufferCh3 = convertBuffers(pack,DataLib::CH3,false);
-        auto bufferCh4 = convertBuffers(pack,DataLib::CH4,false);
-
         auto map = std::map<DataLib::EDataBuffersPackChannel,SBuffPass>();
-        map[DataLib::CH1] = bufferCh1;
-        map[DataLib::CH2] = bufferCh2;
-        map[DataLib::CH3] = bufferCh3;
-        map[DataLib::CH4] = bufferCh4;
-        bool noMemoryException = false;
-        for(auto i = (int)DataLib::CH1; i <= (int)DataLib::CH4; i++){
-            DataLib::EDataBuffersPackChannel ch = (DataLib::EDataBuffersPackChannel)i;
-            if (map[ch].buffer == nullptr && map[ch].bufferLen){
-                noMemoryException = true;
-            }
-        }
-        if (!noMemoryException){
-            if (m_samples != 0){
-                for(auto i = (int)DataLib::CH1; i <= (int)DataLib::CH4; i++){
-                    DataLib::EDataBuffersPackChannel ch = (DataLib::EDataBuffersPackChannel)i;
-                    if (map[ch].samplesCount + m_passSizeSamples[ch] > m_samples){
-                        map[ch].samplesCount = m_samples - m_passSizeSamples[ch];
-                        map[ch].bufferLen = map[ch].samplesCount * (map[ch].bitsBySample / 8);
-                        m_passSizeSamples[ch] += map[ch].samplesCount;
-                    }else{
-                        m_passSizeSamples[ch] += map[ch].samplesCount;
-                    }
-                }
-            }
-            auto stream_data = buildTDMSStream(map);
+        if (convertPack(pack,false,map)){
+            limitSamples(map,m_passSizeSamples);
+            auto stream_data = buildTDMSStream(map,m_file_manager->getBufferPool());
             if (m_file_manager->isWork()){
                 if (!m_file_manager->addBufferToWrite(stream_data)){
                     m_fileLogger->addMetric(CFileLogger::EMetric::FILESYSTEM_RATE,1);
@@ -300,39 +334,10 @@ auto CStreamingFile::passBuffers(DataLib::CDataBuffersPack::Ptr pack) -> int {
     if (m_fileType == CStreamSettings::WAV){
 
         // WAV type support float full range -1...1. adc_mode always equal 1
-        auto bufferCh1 = convertBuffers(pack,DataLib::CH1,true);
-        auto bufferCh2 = convertBuffers(pack,DataLib::CH2,true);
-        auto bufferCh3 = convertBuffers(pack,DataLib::CH3,true);
-        auto bufferCh4 = convertBuffers(pack,DataLib::CH4,true);
-
         auto map = std::map<DataLib::EDataBuffersPackChannel,SBuffPass>();
-        map[DataLib::CH1] = bufferCh1;
-        map[DataLib::CH2] = bufferCh2;
-        map[DataLib::CH3] = bufferCh3;
-        map[DataLib::CH4] = bufferCh4;
-
-        bool noMemoryException = false;
-        for(auto i = (int)DataLib::CH1; i <= (int)DataLib::CH4; i++){
-            DataLib::EDataBuffersPackChannel ch = (DataLib::EDataBuffersPackChannel)i;
-            if (map[ch].buffer == nullptr && map[ch].bufferLen){
-                noMemoryException = true;
-            }
-        }
-
-        if (!noMemoryException){
-            if (m_samples != 0){
-                for(auto i = (int)DataLib::CH1; i <= (int)DataLib::CH4; i++){
-                    DataLib::EDataBuffersPackChannel ch = (DataLib::EDataBuffersPackChannel)i;
-                    if (map[ch].samplesCount + m_passSizeSamples[ch] > m_samples){
-                        map[ch].samplesCount = m_samples - m_passSizeSamples[ch];
-                        map[ch].bufferLen = map[ch].samplesCount * (map[ch].bitsBySample / 8);
-                        m_passSizeSamples[ch] += map[ch].samplesCount;
-                    }else{
-                        m_passSizeSamples[ch] += map[ch].samplesCount;
-                    }
-                }
-            }
-            auto stream_data = m_waveWriter->BuildWAVStream(map);
+        if (convertPack(pack,true,map)){
+            limitSamples(map,m_passSizeSamples);
+            auto stream_data = m_waveWriter->BuildWAVStream(map,m_file_manager->getBufferPool());
             if (m_file_manager->isWork()){
                 if (!m_file_manager->addBufferToWrite(stream_data))
                 {
@@ -367,7 +372,7 @@ auto CStreamingFile::passBuffers(DataLib::CDataBuffersPack::Ptr pack) -> int {
             }
         }
 
-        auto stream_data = buildBINStream(pack,map);
+        auto stream_data = buildBINStream(pack,map,m_file_manager->getBufferPool());
         if ( m_file_manager->isWork()){
             if (!m_file_manager->addBufferToWrite(stream_data))
             {
@@ -376,26 +381,52 @@ auto CStreamingFile::passBuffers(DataLib::CDataBuffersPack::Ptr pack) -> int {
         }
     }
 
-    for(auto i = (int)DataLib::CH1; i <= (int)DataLib::CH4; i++){
-        DataLib::EDataBuffersPackChannel ch = (DataLib::EDataBuffersPackChannel)i;
-        auto buff = pack->getBuffer(ch);
-        if (buff){
-            m_fileLogger->addMetric(CFileLogger::EMetric::RECIVE_DATE, buff->getBufferLenght());
-            m_fileLogger->addMetric(ch,buff->getBufferLenght(),buff->getLostSamples(DataLib::FPGA),buff->getLostSamples(DataLib::RP_INTERNAL_BUFFER),buff->getSamplesCount());
+    addMetrics(pack);
+
+    if (m_samples){
+        if(isLimitReached(pack,m_passSizeSamples)){
+            stop(CStreamingFile::REACH_LIMIT,true);
         }
     }
-    m_fileLogger->addMetric(CFileLogger::EMetric::OSC_RATE,pack->getOSCRate());
-    m_fileLogger->addMetric(pack);
+    return 1;
+}
+
+auto CStreamingFile::passGroups(const std::map<std::string,DataLib::CDataBuffersPack::Ptr> &packs) -> int {
+    if (packs.empty()) return 0;
+    if (m_fileType != CStreamSettings::TDMS) return 0;
+
+    auto groups = std::map<std::string,std::map<DataLib::EDataBuffersPackChannel,SBuffPass>>();
+    bool noMemoryException = false;
+    for(auto &kv : packs){
+        auto &map = groups[kv.first];
+        if (!convertPack(kv.second,false,map)){
+            noMemoryException = true;
+            break;
+        }
+        limitSamples(map,m_groupPassSizeSamples[kv.first]);
+    }
+
+    if (!noMemoryException){
+        auto stream_data = buildTDMSStream(groups,m_file_manager->getBufferPool());
+        if (m_file_manager->isWork()){
+            if (!m_file_manager->addBufferToWrite(stream_data)){
+                m_fileLogger->addMetric(CFileLogger::EMetric::FILESYSTEM_RATE,1);
+            }
+        }
+    }else{
+        m_fileLogger->addMetric(CFileLogger::EMetric::OUT_OF_MEMORY,1);
+    }
+
+    for(auto &kv : packs){
+        addMetrics(kv.second);
+    }
 
     if (m_samples){
         bool reachLimits = true;
-        for(auto i = (int)DataLib::CH1; i <= (int)DataLib::CH4; i++){
-            DataLib::EDataBuffersPackChannel ch = (DataLib::EDataBuffersPackChannel)i;
-            if (pack->isChannelPresent(ch)){
-                if (m_passSizeSamples[ch] < m_samples){
-                    reachLimits = false;
-                    break;
-                }
+        for(auto &kv : packs){
+            if (!isLimitReached(kv.second,m_groupPassSizeSamples[kv.first])){
+                reachLimits = false;
+                break;
             }
         }
         if(reachLimits){
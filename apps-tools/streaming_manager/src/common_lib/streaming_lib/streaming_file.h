@@ -45,10 +45,17 @@ public:
     auto stopImmediately() -> void;
     auto addNetWorkLost(uint64_t count) -> void;
     auto disableNotify() -> void;
+    // Must be called before run()
+    auto setDirectWrite(bool enable) -> void;
+    // Must be called before run(). Memory for blocks waiting to be written, 0 - half of physical memory
+    auto setMemoryLimit(uint64_t bytes) -> void;
 
     auto isFileThreadWork() -> bool;
     auto isOutOfSpace() -> bool;
     auto passBuffers(DataLib::CDataBuffersPack::Ptr pack) -> int;
+    // Writes packs of several boards into one TDMS segment, one group per map key.
+    // The samples limit is counted for every group separately. Only for TDMS files
+    auto passGroups(const std::map<std::string,DataLib::CDataBuffersPack::Ptr> &packs) -> int;
 
     sigslot::signal<EStopReason> stopNotify;
 
@@ -77,6 +84,7 @@ private:
     uint64_t          m_samples;
     std::mutex        m_stopMtx;
     std::map<DataLib::EDataBuffersPackChannel,uint64_t> m_passSizeSamples;
+    std::map<std::string,std::map<DataLib::EDataBuffersPackChannel,uint64_t>> m_groupPassSizeSamples;
 
     bool m_testMode;
     bool m_volt_mode;
@@ -86,6 +94,11 @@ private:
 
     auto stop(EStopReason reason, bool _flush) -> void;
     auto convertBuffers(DataLib::CDataBuffersPack::Ptr pack, DataLib::EDataBuffersPackChannel channel,bool lockADCTo1V) -> SBuffPass;
+    // Returns false if there is no memory for one of the channels
+    auto convertPack(DataLib::CDataBuffersPack::Ptr pack,bool lockADCTo1V,std::map<DataLib::EDataBuffersPackChannel,SBuffPass> &map) -> bool;
+    auto limitSamples(std::map<DataLib::EDataBuffersPackChannel,SBuffPass> &map,std::map<DataLib::EDataBuffersPackChannel,uint64_t> &passSizeSamples) -> void;
+    auto isLimitReached(DataLib::CDataBuffersPack::Ptr pack,std::map<DataLib::EDataBuffersPackChannel,uint64_t> &passSizeSamples) -> bool;
+    auto addMetrics(DataLib::CDataBuffersPack::Ptr pack) -> void;
 };
 
 }
@@ -8,6 +8,7 @@
 
 #include "streaming_fpga.h"
 #include "data_lib/neon_asm.h"
+#include "data_lib/latency_histogram.h"
 
 #define UNUSED(x) [&x]{}()
 
@@ -25,6 +26,7 @@ CStreamingFPGA::CStreamingFPGA(uio_lib::COscilloscope::Ptr _osc, uint8_t _adc_bi
     m_testMode(false),
     m_verbMode(false),
     m_printDebugBuffer(false),
+    m_zeroCopyMode(false),
     m_adcSettings()
 {
     m_passRate = 0;
@@ -130,7 +132,7 @@ void CStreamingFPGA::oscWorker(){
             state = m_Osc_ch->wait();
             // auto timeNowW = std::chrono::system_clock::now();
             if (state){
-                pack = this->passCh();
+                pack = this->passCh(DataLib::CLatencyHistogram::now());
                 m_passRate++;
             }
             // auto timeNowP = std::chrono::system_clock::now();
@@ -140,6 +142,10 @@ void CStreamingFPGA::oscWorker(){
                  usleep(3000);
 #endif
                 oscNotify(pack);
+                if (m_zeroCopyMode && pack){
+                    // All consumers are done with the DMA memory
+                    m_Osc_ch->clearBuffer();
+                }
                 if (pack){
                     dataSize += pack->getLenghtAllBuffers();
                     lostSize += pack->getLostAllBuffers();
@@ -185,7 +191,7 @@ void CStreamingFPGA::oscWorker(){
 }
 
 
- auto CStreamingFPGA::passCh() -> DataLib::CDataBuffersPack::Ptr {
+ auto CStreamingFPGA::passCh(uint64_t _dmaTime) -> DataLib::CDataBuffersPack::Ptr {
     uint8_t *buffer_ch1 = nullptr;
     uint8_t *buffer_ch2 = nullptr;
     uint8_t *buffer_ch3 = nullptr;
@@ -219,6 +225,11 @@ void CStreamingFPGA::oscWorker(){
         exit(1);
     }
 
+    if (m_zeroCopyMode) {
+        uint8_t *buffers[4] = {buffer_ch1, buffer_ch2, buffer_ch3, buffer_ch4};
+        return passChZeroCopy(buffers, size, overFlow, _dmaTime);
+    }
+
     if (!getBuffF || !unlockBuffF) {
         return nullptr;
     }
@@ -228,6 +239,8 @@ void CStreamingFPGA::oscWorker(){
     if (pack){
         pack->setOSCRate(m_Osc_ch->getOSCRate());
         pack->setADCBits(m_adc_bits);
+        // Stamped before unlockBuffF(), after it the consumers own the pack
+        pack->setTimestamp(_dmaTime);
 
         if (m_adcSettings.find(DataLib::EDataBuffersPackChannel::CH1) != m_adcSettings.end()){
             auto settings = m_adcSettings.at(DataLib::EDataBuffersPackChannel::CH1);
@@ -276,6 +289,43 @@ void CStreamingFPGA::oscWorker(){
     return pack;
 }
 
+auto CStreamingFPGA::passChZeroCopy(uint8_t *_buffers[4], size_t _size, uint32_t _overFlow, uint64_t _dmaTime) -> DataLib::CDataBuffersPack::Ptr {
+    // The DMA uses two fixed half-buffers, so packs are created once per half-buffer
+    auto &pack = m_zeroCopyPacks[_buffers[0]];
+    if (!pack){
+        pack = DataLib::CDataBuffersPack::Create();
+        for(auto &s : m_adcSettings){
+            auto ptr = _buffers[s.first];
+            if (ptr){
+                auto buff = DataLib::CDataBuffer::Create(std::shared_ptr<uint8_t[]>(ptr,[](uint8_t*){}),_size,s.second.m_bits);
+                buff->setADCMode(s.second.m_mode);
+                pack->addBuffer(s.first,buff);
+            }
+        }
+    }
+
+    pack->setOSCRate(m_Osc_ch->getOSCRate());
+    pack->setADCBits(m_adc_bits);
+    pack->setTimestamp(_dmaTime);
+    for(auto &s : m_adcSettings){
+        auto buff = pack->getBuffer(s.first);
+        if (buff){
+            buff->setLostSamples(DataLib::FPGA,_overFlow);
+            buff->setLostSamples(DataLib::RP_INTERNAL_BUFFER,0);
+        }
+    }
+    return pack;
+}
+
+auto CStreamingFPGA::setZeroCopyMode(bool mode) -> void{
+    m_zeroCopyMode = mode;
+    m_zeroCopyPacks.clear();
+}
+
+auto CStreamingFPGA::isZeroCopyMode() -> bool{
+    return m_zeroCopyMode;
+}
+
 auto CStreamingFPGA::setTestMode(bool mode) -> void{
     m_testMode = mode;
 }
@@ -37,6 +37,10 @@ public:
     auto setTestMode(bool mode) -> void;
     auto setVerbousMode(bool mode) -> void;
     auto setPrintDebugBuffer(bool mode) -> void;
+    // In zero copy mode packs point straight into the DMA half-buffer. The pack is
+    // valid only inside oscNotify, the half-buffer is returned to the DMA after it.
+    auto setZeroCopyMode(bool mode) -> void;
+    auto isZeroCopyMode() -> bool;
 
     sigslot::signal<DataLib::CDataBuffersPack::Ptr> oscNotify;
     sigslot::signal<bool> isRunNotify;
@@ -71,15 +75,19 @@ private:
     bool             m_testMode;
     bool             m_verbMode;
     bool             m_printDebugBuffer;
+    bool             m_zeroCopyMode;
 
     std::map<DataLib::EDataBuffersPackChannel,SADCsettings> m_adcSettings;
 
     auto oscWorker() -> void;
-    auto passCh() -> DataLib::CDataBuffersPack::Ptr;
+    // _dmaTime is the DMA completion time, the pack carries it as its timestamp
+    auto passCh(uint64_t _dmaTime) -> DataLib::CDataBuffersPack::Ptr;
+    auto passChZeroCopy(uint8_t *_buffers[4], size_t _size, uint32_t _overFlow, uint64_t _dmaTime) -> DataLib::CDataBuffersPack::Ptr;
     auto prepareTestBuffers() -> void;
     auto setIsRun(bool state) -> void;
 
     uint8_t *m_testBuffer;
+    std::map<uint8_t*,DataLib::CDataBuffersPack::Ptr> m_zeroCopyPacks;
 };
 
 }
@@ -22,11 +22,17 @@ CStreamingNet::CStreamingNet(std::string &_host, std::string &_port, net_lib::EP
         m_protocol(_protocol),
         m_asionet(nullptr),
         m_index_of_message(0),
+        m_sequence(0),
+        m_headerVersion(net_lib::HV_V1),
+        m_batchedSend(true),
+        m_sentPacks(0),
+        m_latency(),
         m_thread(),
         m_mtx()
 {
     getBuffer = nullptr;
     unlockBufferF = nullptr;
+    waitBufferF = nullptr;
 }
 
 CStreamingNet::~CStreamingNet() {
@@ -39,6 +45,7 @@ void CStreamingNet::startServer() {
     }
 
     m_index_of_message = 0;
+    m_sequence = 0;
 //    m_SendData = 0;
     m_asionet = new net_lib::CAsioNet(net_lib::EMode::M_SERVER, m_protocol, m_host, m_port);
     m_asionet->serverConnectNotify.connect([](std::string host)
@@ -94,11 +101,21 @@ auto CStreamingNet::getProtocol() -> net_lib::EProtocol{
 auto CStreamingNet::task() -> void{
     while(m_threadRun){
         if (getBuffer && unlockBufferF){
+            if (waitBufferF){
+                auto res = waitBufferF();
+                if (res == CLOSED){
+                    break;
+                }
+                if (res != READY){
+                    continue;
+                }
+            }
             auto pack = getBuffer();
             sendBuffers(pack);
             if (pack)
                 unlockBufferF();
-            usleep(100);
+            if (!waitBufferF)
+                usleep(100);
         }
     }
 }
@@ -108,12 +125,49 @@ auto CStreamingNet::sendBuffers(DataLib::CDataBuffersPack::Ptr pack) -> void {
     if (m_asionet && pack){
         if (m_asionet->isConnected()) {
             uint32_t split_size = (getProtocol() == net_lib::EProtocol::P_TCP ? TCP_BUFFER_LIMIT : UDP_BUFFER_LIMIT);
-            auto packs = net_lib::buildPack(m_index_of_message++,pack,split_size);            
-            for(auto &buff : packs){
-                m_asionet->sendSyncData(buff);
+            auto packs = net_lib::buildPack(m_index_of_message++,pack,split_size,m_headerVersion,&m_sequence);
+            if (m_batchedSend){
+                m_asionet->sendSyncData(packs);
+            }else{
+                for(auto &buff : packs){
+                    m_asionet->sendSyncData(buff);
+                }
+            }
+            // Measured once the data is handed to the socket
+            if (pack->getTimestamp()){
+                m_latency.add(DataLib::CLatencyHistogram::now() - pack->getTimestamp());
             }
+            m_sentPacks++;
         }
     }
 }
 
+auto CStreamingNet::setBatchedSend(bool enable) -> void{
+    m_batchedSend = enable;
+}
+
+auto CStreamingNet::setHeaderVersion(net_lib::EHeaderVersion version) -> void{
+    m_headerVersion = version;
+}
+
+auto CStreamingNet::getHeaderVersion() -> net_lib::EHeaderVersion{
+    return m_headerVersion;
+}
+
+auto CStreamingNet::getLatencyHistogram() -> DataLib::CLatencyHistogram&{
+    return m_latency;
+}
+
+auto CStreamingNet::getSentPacks() -> uint64_t{
+    return m_sentPacks;
+}
+
+auto CStreamingNet::getSyscallsPerPack() -> double{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if (m_asionet && m_sentPacks){
+        return (double)m_asionet->getSendSyscalls() / (double)m_sentPacks;
+    }
+    return 0;
+}
+
 
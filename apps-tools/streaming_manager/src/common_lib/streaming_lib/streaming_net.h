@@ -9,6 +9,7 @@
 
 #include "data_lib/signal.hpp"
 #include "data_lib/buffers_pack.h"
+#include "data_lib/latency_histogram.h"
 
 #include "net_lib/asio_common.h"
 #include "net_lib/asio_net.h"
@@ -28,9 +29,17 @@ class CStreamingNet
 
 public:
 
+    enum EWaitResult{
+        READY   = 0,
+        TIMEOUT = 1,
+        // The buffer is destroyed, nothing more will be sent
+        CLOSED  = 2
+    };
+
     using Ptr = std::shared_ptr<CStreamingNet>;
     typedef std::function<DataLib::CDataBuffersPack::Ptr()> getBufferFunc;
     typedef std::function<void()> unlockBufferFunc;
+    typedef std::function<EWaitResult()> waitBufferFunc;
 
     static auto create(std::string &_host, std::string &_port, net_lib::EProtocol _protocol) -> Ptr;
 
@@ -43,9 +52,20 @@ public:
     auto stop() -> void;
     auto getProtocol() -> net_lib::EProtocol;
     auto sendBuffers(DataLib::CDataBuffersPack::Ptr pack) -> void;
+    auto setBatchedSend(bool enable) -> void;
+    // Header version is negotiated over the config connection, v1 by default
+    auto setHeaderVersion(net_lib::EHeaderVersion version) -> void;
+    auto getHeaderVersion() -> net_lib::EHeaderVersion;
+    auto getSentPacks() -> uint64_t;
+    auto getSyscallsPerPack() -> double;
+    // Time from DMA completion until the pack is written to the socket
+    auto getLatencyHistogram() -> DataLib::CLatencyHistogram&;
 
     getBufferFunc getBuffer;
     unlockBufferFunc unlockBufferF;
+    // Optional. Blocks until the producer has a pack, without it the thread polls.
+    // The thread stops sending when it returns CLOSED.
+    waitBufferFunc waitBufferF;
 
 private:
 
@@ -61,6 +81,11 @@ private:
     net_lib::CAsioNet  *m_asionet;
 
     uint64_t            m_index_of_message;
+    uint32_t            m_sequence;
+    std::atomic<net_lib::EHeaderVersion> m_headerVersion;
+    std::atomic_bool    m_batchedSend;
+    std::atomic<uint64_t> m_sentPacks;
+    DataLib::CLatencyHistogram m_latency;
     std::thread         m_thread;
     std::atomic_bool    m_threadRun;
     std::mutex          m_mtx;
@@ -1,4 +1,5 @@
 #include <stdint.h>
+#include <algorithm>
 #include "streaming_net_buffer.h"
 #include "data_lib/thread_cout.h"
 #include "data_lib/neon_asm.h"
@@ -14,8 +15,19 @@ auto CStreamingNetBuffer::create() -> CStreamingNetBuffer::Ptr{
 CStreamingNetBuffer::CStreamingNetBuffer():
     m_currentPack(nullptr),
     m_tempBuffer(),
+    m_layout(),
+    m_layoutSize(0),
+    m_layoutSplit(0),
+    m_layoutFragments(0),
+    m_direct(false),
+    m_packBuffer(nullptr),
+    m_received(),
+    m_receivedFragments(0),
     m_currentPackId(0),
-    m_buffersAllSize(0)
+    m_buffersAllSize(0),
+    m_sequenceValid(false),
+    m_lastSequence(0),
+    m_lostFrames(0)
 {
 }
 
@@ -29,9 +41,19 @@ auto CStreamingNetBuffer::addNewBuffer(uint8_t* buffer,size_t len) -> void {
     size_t   buffersAllSize = 0;
     uint64_t packOrderId = 0;
     DataLib::EDataBuffersPackChannel channel = DataLib::EDataBuffersPackChannel::CH1;
+    bool isV2 = checkSequence(buffer,len);
+
+    // v2 carries only the low 32 bits of the pack id
+    auto expandId = [this,isV2](uint64_t id) -> uint64_t{
+        if (!isV2) return id;
+        uint64_t full = (m_currentPackId & ~0xFFFFFFFFull) | id;
+        if (full + 0x80000000ull < m_currentPackId) full += 0x100000000ull;
+        return full;
+    };
 
     auto begPack = net_lib::extractBeginPack(buffer,len,&new_id,&buffersAllSize);
     if (begPack){
+        new_id = expandId(new_id);
 //        aprintf(stderr,"extractBeginPack %d cur %d\n",new_id,m_currentPackId);
         if (m_currentPack){
             // Drop broken buffer
@@ -40,12 +62,14 @@ auto CStreamingNetBuffer::addNewBuffer(uint8_t* buffer,size_t len) -> void {
             m_currentPack = begPack;
             m_currentPackId = new_id;
             m_buffersAllSize = buffersAllSize;
+            m_direct = beginDirectPack();
         }else{
             // Check buffers order and drop old
             if (m_currentPackId <= new_id){
                 m_currentPack = begPack;
                 m_currentPackId = new_id;
                 m_buffersAllSize = buffersAllSize;
+                m_direct = beginDirectPack();
             }
         }
         return;
@@ -53,9 +77,20 @@ auto CStreamingNetBuffer::addNewBuffer(uint8_t* buffer,size_t len) -> void {
 
     auto endPack = net_lib::extractEndPack(buffer,len,&new_id);
     if (endPack){
+        new_id = expandId(new_id);
 //        aprintf(stderr,"extractEndPack %d cur %d\n",new_id,m_currentPackId);
         if (m_currentPack){
             if (m_currentPackId == new_id){
+                if (m_direct){
+                    if (finishDirectPack()){
+                        receivedPackNotify(m_currentPack,m_currentPackId);
+                        resetInternalBuffers();
+                    }else{
+                        resetInternalBuffers();
+                        brokenPacksNotify(1);
+                    }
+                    return;
+                }
                 if (isAllData()){
                     for(auto &kv: m_tempBuffer){
                         auto new_buff = kv.second.convertBuffer();
@@ -67,6 +102,7 @@ auto CStreamingNetBuffer::addNewBuffer(uint8_t* buffer,size_t len) -> void {
                             return;
                         }
                     }
+                    learnLayout();
                     receivedPackNotify(m_currentPack,m_currentPackId);
                     resetInternalBuffers();
 
@@ -80,8 +116,22 @@ auto CStreamingNetBuffer::addNewBuffer(uint8_t* buffer,size_t len) -> void {
         return;
     }
 
+    net_lib::SBufferPackInfo info;
+    if (m_direct && net_lib::extractBufferPackInfo(buffer,len,&info)){
+        if (expandId(info.id) == m_currentPackId){
+            if (!addDirectBuffer(info)){
+                // The pack does not match the learned layout
+                m_layoutSize = 0;
+                resetInternalBuffers();
+                brokenPacksNotify(1);
+            }
+        }
+        return;
+    }
+
     auto buffPack = net_lib::extractBufferPack(buffer,len,&new_id,&packOrderId,&channel);
     if (buffPack){
+        new_id = expandId(new_id);
 //        aprintf(stderr,"extractBufferPack %d cur %d\n",new_id , m_currentPackId);
         if (new_id == m_currentPackId){
             if (m_tempBuffer.find(channel) == m_tempBuffer.end()){
@@ -93,10 +143,143 @@ auto CStreamingNetBuffer::addNewBuffer(uint8_t* buffer,size_t len) -> void {
     }
 }
 
+auto CStreamingNetBuffer::checkSequence(uint8_t* buffer,size_t len) -> bool{
+    uint32_t sequence = 0;
+    if (!net_lib::extractSequence(buffer,len,&sequence)){
+        return false;
+    }
+    if (m_sequenceValid){
+        uint32_t lost = sequence - m_lastSequence - 1;
+        // Reordered or duplicated datagram
+        if (lost >= 0x80000000u){
+            return true;
+        }
+        if (lost){
+            m_lostFrames += lost;
+            lostFramesNotify(lost);
+        }
+    }
+    m_sequenceValid = true;
+    m_lastSequence = sequence;
+    return true;
+}
+
+auto CStreamingNetBuffer::getLostFrames() -> uint64_t{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_lostFrames;
+}
+
 auto CStreamingNetBuffer::resetInternalBuffers() -> void{
     m_currentPack = nullptr;
     m_tempBuffer.clear();
     m_buffersAllSize = 0;
+    m_direct = false;
+    m_packBuffer = nullptr;
+    m_receivedFragments = 0;
+}
+
+auto CStreamingNetBuffer::beginDirectPack() -> bool{
+    if (m_layoutSize == 0 || m_layoutSize != m_buffersAllSize){
+        return false;
+    }
+    m_packBuffer = net_lib::createBuffer((uint64_t)m_buffersAllSize);
+    if (!m_packBuffer){
+        outMemoryNotify(1);
+        return false;
+    }
+    m_received.assign((m_layoutFragments + 63) / 64,0);
+    m_receivedFragments = 0;
+    return true;
+}
+
+auto CStreamingNetBuffer::addDirectBuffer(const net_lib::SBufferPackInfo &info) -> bool{
+    if ((size_t)info.channel >= m_layout.size()){
+        return false;
+    }
+    auto &ch = m_layout[info.channel];
+    if (!ch.present || info.packOrder >= ch.fragments){
+        return false;
+    }
+    size_t offset = info.packOrder * m_layoutSplit;
+    if (info.dataSize != std::min(m_layoutSplit,ch.lenght - offset)){
+        return false;
+    }
+
+    size_t bit = ch.firstFragment + info.packOrder;
+    uint64_t mask = 1ull << (bit % 64);
+    if (m_received[bit / 64] & mask){
+        // Duplicated datagram
+        return true;
+    }
+    if (info.dataSize){
+        memcpy_neon(m_packBuffer.get() + ch.offset + offset,info.data,info.dataSize);
+    }
+    m_received[bit / 64] |= mask;
+    m_receivedFragments++;
+
+    if (info.packOrder == 0){
+        ch.adcMode = info.adcMode;
+        ch.bitBySample = info.bitBySample;
+        ch.lostFPGA = info.lostFPGA;
+        ch.lostINTERNAL = info.lostINTERNAL;
+    }
+    return true;
+}
+
+auto CStreamingNetBuffer::finishDirectPack() -> bool{
+    if (m_receivedFragments != m_layoutFragments){
+        return false;
+    }
+    for(size_t i = 0; i < m_layout.size(); i++){
+        auto &ch = m_layout[i];
+        if (!ch.present){
+            continue;
+        }
+        // Channel buffers share the pack buffer
+        auto ch_buffer = DataLib::CDataBuffer::Create(net_lib::net_buffer(m_packBuffer,m_packBuffer.get() + ch.offset),ch.lenght,ch.bitBySample);
+        ch_buffer->setADCMode(ch.adcMode);
+        ch_buffer->setLostSamples(DataLib::FPGA,ch.lostFPGA);
+        ch_buffer->setLostSamples(DataLib::RP_INTERNAL_BUFFER,ch.lostINTERNAL);
+        m_currentPack->addBuffer((DataLib::EDataBuffersPackChannel)i,ch_buffer);
+    }
+    return true;
+}
+
+auto CStreamingNetBuffer::learnLayout() -> void{
+    m_layout = {};
+    m_layoutSize = 0;
+
+    // All fragments except the last one of each channel have the split size
+    size_t split = 0;
+    for(auto &kv : m_tempBuffer){
+        for(auto &f : kv.second.buff_map){
+            split = std::max(split,f.second->getBufferLenght());
+        }
+    }
+
+    size_t offset = 0;
+    size_t fragments = 0;
+    for(auto &kv : m_tempBuffer){
+        if ((size_t)kv.first >= m_layout.size()){
+            return;
+        }
+        auto &ch = m_layout[kv.first];
+        ch.present = true;
+        ch.offset = offset;
+        ch.lenght = kv.second.getBuffersLenght();
+        ch.firstFragment = fragments;
+        ch.fragments = kv.second.buff_map.size();
+        size_t expected = split && ch.lenght ? (ch.lenght + split - 1) / split : 1;
+        if (ch.fragments != expected){
+            return;
+        }
+        offset += ch.lenght;
+        fragments += ch.fragments;
+    }
+
+    m_layoutSplit = split;
+    m_layoutFragments = fragments;
+    m_layoutSize = offset;
 }
 
 
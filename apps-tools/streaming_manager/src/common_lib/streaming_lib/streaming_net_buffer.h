@@ -3,9 +3,12 @@
 
 #include <mutex>
 #include <list>
+#include <array>
+#include <vector>
 
 #include "data_lib/signal.hpp"
 #include "data_lib/buffers_pack.h"
+#include "net_lib/asio_common.h"
 
 namespace streaming_lib {
 
@@ -28,7 +31,11 @@ public:
 //    auto isBufferFull() -> bool;
 
 
+    // Frames missed according to the v2 sequence counter
+    auto getLostFrames() -> uint64_t;
+
     sigslot::signal<uint64_t> brokenPacksNotify;
+    sigslot::signal<uint64_t> lostFramesNotify;
     sigslot::signal<uint64_t> outMemoryNotify;
     sigslot::signal<DataLib::CDataBuffersPack::Ptr,uint64_t> receivedPackNotify;
 
@@ -45,6 +52,20 @@ private:
         auto convertBuffer() -> DataLib::CDataBuffer::Ptr;
     };
 
+    // Place of one channel in the pack buffer of the direct path
+    struct ChannelLayout{
+        bool     present = false;
+        size_t   offset = 0;
+        size_t   lenght = 0;
+        size_t   firstFragment = 0;
+        size_t   fragments = 0;
+        // Taken from the first fragment of the current pack
+        DataLib::CDataBuffer::ADC_MODE adcMode = DataLib::CDataBuffer::ATT_1_1;
+        uint8_t  bitBySample = 0;
+        uint64_t lostFPGA = 0;
+        uint64_t lostINTERNAL = 0;
+    };
+
     CStreamingNetBuffer(const CStreamingNetBuffer &) = delete;
     CStreamingNetBuffer(CStreamingNetBuffer &&) = delete;
     CStreamingNetBuffer& operator=(const CStreamingNetBuffer&) =delete;
@@ -52,11 +73,33 @@ private:
 
     auto resetInternalBuffers() -> void;
     auto isAllData() -> bool;
+    auto checkSequence(uint8_t* buffer,size_t len) -> bool;
+
+    auto beginDirectPack() -> bool;
+    auto addDirectBuffer(const net_lib::SBufferPackInfo &info) -> bool;
+    auto finishDirectPack() -> bool;
+    auto learnLayout() -> void;
 
     DataLib::CDataBuffersPack::Ptr m_currentPack;
     std::map<DataLib::EDataBuffersPackChannel,BuffersAgregator> m_tempBuffer;
+
+    // Direct path. Once a pack was received through m_tempBuffer, the
+    // following packs with the same buffersSize are expected to have the
+    // same channels and fragment size. Fragments are then copied straight to
+    // their offset in one pack buffer and tracked in a bitmap.
+    std::array<ChannelLayout,4> m_layout;
+    size_t   m_layoutSize;
+    size_t   m_layoutSplit;
+    size_t   m_layoutFragments;
+    bool     m_direct;
+    net_lib::net_buffer m_packBuffer;
+    std::vector<uint64_t> m_received;
+    size_t   m_receivedFragments;
     uint64_t m_currentPackId;
     size_t   m_buffersAllSize;
+    bool     m_sequenceValid;
+    uint32_t m_lastSequence;
+    uint64_t m_lostFrames;
     std::mutex m_mtx;
 };
 
@@ -91,6 +91,13 @@ auto File::GetMetadata(shared_ptr<Segment> segment) -> vector<shared_ptr<Metadat
     return GetMetadataItem(*m_reader,segment,m_prevMetaDataLookup);
 }
 
+auto File::GetMetadataLayout(shared_ptr<Segment> segment) -> vector<shared_ptr<Metadata>>{
+    m_reader->SetReadRawData(false);
+    auto metadata = GetMetadataItem(*m_reader,segment,m_prevMetaDataLookup);
+    m_reader->SetReadRawData(true);
+    return metadata;
+}
+
 auto File::Close() -> bool{
     m_prevMetaDataLookup.clear();
     if (m_reader){
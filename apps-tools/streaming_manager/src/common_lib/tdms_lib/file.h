@@ -23,6 +23,8 @@ namespace TDMS
             auto ReadFileWithoutClose(string m_fileName) -> vector<shared_ptr<Segment>>;
             auto Close() -> bool;
             auto GetMetadata(shared_ptr<Segment>) -> vector<shared_ptr<Metadata>>;
+            // Same as GetMetadata, but the raw data is not read
+            auto GetMetadataLayout(shared_ptr<Segment>) -> vector<shared_ptr<Metadata>>;
             auto WriteFile(string m_fileName,WriterSegment &segment,bool Append) -> void;
             auto WriteMemory(std::iostream& stream,WriterSegment &segment) -> void;
             auto Print(vector<shared_ptr<Metadata>> &data,bool PrintRaw,long limitData) -> void;
@@ -9,6 +9,11 @@ Reader::Reader(iostream &fileStream, uint64_t fileSize,bool showLog){
     m_fileStream = &fileStream;
     m_fileSize = fileSize;
     m_showLog = showLog;
+    m_readRawData = true;
+}
+
+auto Reader::SetReadRawData(bool enable) -> void{
+    m_readRawData = enable;
 }
 
 uint64_t Reader::GetFileSize(){
@@ -99,7 +104,7 @@ auto Reader::ReadMetadata(shared_ptr<Segment> segment) -> vector<shared_ptr<Meta
             metadata->RawData.Size = rawDataIndexLength == 28 ? (long)m_bstream.Read<int64_t>(*m_fileStream, TDMSType::Integer64) :
                 (long)DataType::GetArrayLength(metadata->RawData.DataType.GetDataType(), metadata->RawData.Count);
 
-            vector<shared_ptr<DataType::Raw>> raw = ReadRawData(metadata->RawData);
+            vector<shared_ptr<DataType::Raw>> raw = m_readRawData ? ReadRawData(metadata->RawData) : vector<shared_ptr<DataType::Raw>>();
             if (m_showLog) cout << "RawData.Size " << metadata->RawData.Size << endl;
             metadata->RawData.DataType.InitDataType(dataType, raw);
             if (isInterleaved)
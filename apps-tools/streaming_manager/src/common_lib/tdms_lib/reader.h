@@ -17,6 +17,8 @@ namespace TDMS
             Reader(iostream &fileStream,uint64_t fileSize,bool showLog = false);
             ~Reader();
             auto GetFileSize() -> uint64_t;
+            // Without raw data ReadMetadata() only fills the layout (offset, size, type)
+            auto SetReadRawData(bool enable) -> void;
             auto ReadFirstSegment() -> shared_ptr<Segment>;
             auto ReadSegment(uint64_t offset) -> shared_ptr<Segment>;
             auto ReadMetadata(shared_ptr<Segment> segment) -> vector<shared_ptr<Metadata>>;
@@ -30,6 +32,7 @@ namespace TDMS
             uint64_t     m_fileSize;
             BinaryStream m_bstream;
             bool         m_showLog;
+            bool         m_readRawData;
 	};
 }
 
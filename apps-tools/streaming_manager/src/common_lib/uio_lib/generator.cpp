@@ -6,6 +6,7 @@
 #include "generator.h"
 #include <stdio.h>
 #include <string.h>
+#include <poll.h>
 
 #include "data_lib/thread_cout.h"
 
@@ -251,6 +252,35 @@ auto CGenerator::write(uint8_t *_buffer1,uint8_t *_buffer2, size_t _size_ch1, si
     return ret;
 }
 
+auto CGenerator::wait(int timeout_ms) -> bool{
+    int32_t cnt = 1;
+    constexpr size_t cnt_size = sizeof(cnt);
+    ssize_t bytes = ::write(m_Fd, &cnt, cnt_size); // Unmmask interrupt
+    if (bytes == cnt_size) {
+        struct pollfd pfd = {.fd = m_Fd, .events = POLLIN ,.revents = 0};
+        int rv = poll(&pfd, 1, timeout_ms);
+        if (rv >= 1) {
+            uint32_t info;
+            if (read(m_Fd, &info, sizeof(info)) != sizeof(info)){
+                perror("CGenerator::wait()");
+            }
+            clearInterrupt();
+        } else if (rv == 0) {
+            return false;
+        } else {
+            perror("CGenerator::wait()");
+        }
+        return true;
+    }
+    return false;
+}
+
+auto CGenerator::clearInterrupt() -> bool{
+    const std::lock_guard<std::mutex> lock(m_waitLock);
+    // Interrupt acknowledge for both channels
+    setRegister(m_Map,&(m_Map->dma_control),0x0202);
+    return true;
+}
 
 auto CGenerator::start() -> void{
     const std::lock_guard<std::mutex> lock(m_waitLock);
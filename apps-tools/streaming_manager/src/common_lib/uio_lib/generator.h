@@ -55,6 +55,9 @@ public:
     auto initSecond(uint8_t *_buffer1,uint8_t *_buffer2, size_t _size_ch1, size_t _size_ch2) -> bool;
     
     auto write(uint8_t *_buffer1,uint8_t *_buffer2, size_t _size_ch1, size_t _size_ch2) -> bool;
+    // Blocks until the DMA finished one of the buffers. Returns false on timeout
+    auto wait(int timeout_ms = 1000) -> bool;
+    auto clearInterrupt() -> bool;
     auto setCalibration(int32_t ch1_offset,float ch1_gain, int32_t ch2_offset, float ch2_gain) -> void;
     auto start() -> void;
     auto stop() -> void;
@@ -5,6 +5,7 @@
 #include "generator.h"
 #include <stdio.h>
 #include <string.h>
+#include <thread>
 
 using namespace uio_lib;
 
@@ -87,6 +88,16 @@ auto CGenerator::write(uint8_t *,uint8_t *, size_t, size_t) -> bool {
     return ret;
 }
 
+auto CGenerator::wait(int) -> bool {
+    // One DMA buffer lasts dac_buf_size / 2 samples
+    auto hz = m_dacSpeedHz ? m_dacSpeedHz : 1;
+    std::this_thread::sleep_for(std::chrono::microseconds((uint64_t)dac_buf_size / 2 * 1000000 / hz));
+    return true;
+}
+
+auto CGenerator::clearInterrupt() -> bool {
+    return true;
+}
 
 auto CGenerator::start() -> void {}
 
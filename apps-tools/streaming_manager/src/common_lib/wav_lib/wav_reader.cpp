@@ -1,7 +1,9 @@
 #include <cassert>
 #include <sstream>
 #include <cstring>
+#include <vector>
 #include "wav_reader.h"
+#include "data_lib/stream_kernels.h"
 
 using namespace std;
 
@@ -58,38 +60,25 @@ auto CWaveReader::getBuffers(uint8_t **ch1,size_t *size_ch1, uint8_t **ch2,size_
         int channels = m_header.NumOfChan;
         int dataBitSize = m_header.bitsPerSample;
         if (dataBitSize != 16) return false;
+        if (channels != 1 && channels != 2) return false;
         if (channels == 1 || channels == 2){
             *ch1 = new uint8_t[32 * 1024];
         }
         if (channels == 2){
             *ch2 = new uint8_t[32 * 1024];
         }
+        // One read for the whole block, then split the frames into channels
         int size = 16 * 1024;
-        for(int i = 0 ; i < size; i++){
-            uint16_t  value = 0;
-            m_read_fs.read((char*)&value,sizeof(value));
-            if (!m_read_fs){
-                delFunc();
-                return true;
-            }
-            if (*ch1){
-                ((uint16_t*)*ch1)[i] = value;
-                *size_ch1 += 2;
-            }
-
-            if (channels == 2){
-                value = 0;
-                m_read_fs.read((char*)&value,sizeof(value));
-                if (!m_read_fs){
-                    delFunc();
-                    return true;
-                }
-                if (*ch2){
-                    ((uint16_t*)*ch2)[i] = value;
-                    *size_ch2 += 2;
-                }
-            }
+        std::vector<int16_t> frames(size * channels);
+        m_read_fs.read((char*)frames.data(),frames.size() * sizeof(int16_t));
+        size_t count = m_read_fs.gcount() / (sizeof(int16_t) * channels);
+        if (channels == 1){
+            memcpy(*ch1,frames.data(),count * sizeof(int16_t));
+        }else{
+            split_2ch_16bit((int16_t*)*ch1,(int16_t*)*ch2,frames.data(),count);
+            *size_ch2 = count * sizeof(int16_t);
         }
+        *size_ch1 = count * sizeof(int16_t);
         delFunc();
         return true;
     }
@@ -2,6 +2,7 @@
 #include <sstream>
 #include <vector>
 #include "wav_writer.h"
+#include "data_lib/stream_kernels.h"
 
 CWaveWriter::CWaveWriter(){
     resetHeaderInit();
@@ -12,7 +13,7 @@ auto CWaveWriter::resetHeaderInit() -> void{
     m_headerInit = true;
 }
 
-auto CWaveWriter::BuildWAVStream(std::map<DataLib::EDataBuffersPackChannel,SBuffPass> new_buffs) -> std::iostream *{
+auto CWaveWriter::BuildWAVStream(std::map<DataLib::EDataBuffersPackChannel,SBuffPass> new_buffs,CBufferPool::Ptr pool) -> std::iostream *{
 
     auto ch1 = new_buffs[DataLib::CH1];
     auto ch2 = new_buffs[DataLib::CH2];
@@ -75,7 +76,8 @@ auto CWaveWriter::BuildWAVStream(std::map<DataLib::EDataBuffersPackChannel,SBuff
     m_bitDepth = maxBitBySample;
     m_OSCRate = OSCRate;
 
-    std::stringstream *memory = new std::stringstream(std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    auto memory = createMemoryStream(pool);
+    bool withHeader = m_headerInit;
     if (m_headerInit)
     {
         BuildHeader(memory);
@@ -125,7 +127,35 @@ auto CWaveWriter::BuildWAVStream(std::map<DataLib::EDataBuffersPackChannel,SBuff
     try{
         uint8_t* cross_buff = new uint8_t[buffLen];
 
-        for(size_t i = 0; i < maxSamples; i++){
+        // Integer channels of the same format and length are interleaved by the vector kernels
+        bool uniform = (m_numChannels == 2 || m_numChannels == 4) && (m_bitDepth == 8 || m_bitDepth == 16);
+        for(uint8_t ch = 0; ch < m_numChannels && uniform; ch++){
+            uniform = channelsBits[ch] == m_bitDepth && channelsSamples[ch] == maxSamples;
+        }
+
+        if (uniform && m_bitDepth == 8){
+            const int8_t *src[4] = {nullptr,nullptr,nullptr,nullptr};
+            for(uint8_t ch = 0; ch < m_numChannels; ch++){
+                src[ch] = (const int8_t*)channels[ch].get();
+            }
+            if (m_numChannels == 2)
+                pack_2ch_8bit((int8_t*)cross_buff,src[0],src[1],maxSamples);
+            else
+                pack_4ch_8bit((int8_t*)cross_buff,src,maxSamples);
+        }
+
+        if (uniform && m_bitDepth == 16){
+            const int16_t *src[4] = {nullptr,nullptr,nullptr,nullptr};
+            for(uint8_t ch = 0; ch < m_numChannels; ch++){
+                src[ch] = (const int16_t*)channels[ch].get();
+            }
+            if (m_numChannels == 2)
+                pack_2ch_16bit((int16_t*)cross_buff,src[0],src[1],maxSamples);
+            else
+                pack_4ch_16bit((int16_t*)cross_buff,src,maxSamples);
+        }
+
+        for(size_t i = 0; i < maxSamples && !uniform; i++){
             for(uint8_t ch = 0; ch < m_numChannels; ch++){
                 if (m_bitDepth == 8){
                     if (channelsSamples[ch] > i){
@@ -156,15 +186,18 @@ auto CWaveWriter::BuildWAVStream(std::map<DataLib::EDataBuffersPackChannel,SBuff
         }
         memory->write((const char*)cross_buff, buffLen);
         delete [] cross_buff;
-        return memory;
+        if (!memory->fail()){
+            return memory;
+        }
     }catch(std::exception &e){
         fprintf(stderr,"[ERROR] CDataBuffer: %s\n",e.what());
     }
+    m_headerInit = withHeader;
     delete memory;
     return nullptr;
 }
 
-auto CWaveWriter::BuildHeader(std::stringstream *memory) -> void{
+auto CWaveWriter::BuildHeader(std::iostream *memory) -> void{
 
     int sampleRate = 44100;
     int32_t dataChunkSize = m_samplesPerChannel * m_numChannels * (m_bitDepth / 8);
@@ -199,13 +232,13 @@ auto CWaveWriter::BuildHeader(std::stringstream *memory) -> void{
 }
 
 
-auto CWaveWriter::addStringToFileData (std::stringstream *memory, std::string s) -> void
+auto CWaveWriter::addStringToFileData (std::iostream *memory, std::string s) -> void
 {
     memory->write(s.data(),s.size());
 }
 
 
-void CWaveWriter::addInt32ToFileData (std::stringstream *memory, int32_t i)
+void CWaveWriter::addInt32ToFileData (std::iostream *memory, int32_t i)
 {
     char bytes[4];
     
@@ -227,7 +260,7 @@ void CWaveWriter::addInt32ToFileData (std::stringstream *memory, int32_t i)
     
 }
 
-void CWaveWriter::addInt16ToFileData (std::stringstream *memory, int16_t i)
+void CWaveWriter::addInt16ToFileData (std::iostream *memory, int16_t i)
 {
     char bytes[2];
     
@@ -16,13 +16,14 @@ class CWaveWriter
 public:
     CWaveWriter();
     auto resetHeaderInit() -> void;
-    auto BuildWAVStream(std::map<DataLib::EDataBuffersPackChannel,SBuffPass> new_buffs) -> std::iostream *;
+    // Returns nullptr if the pool is exhausted. The header is then written with the next stream
+    auto BuildWAVStream(std::map<DataLib::EDataBuffersPackChannel,SBuffPass> new_buffs,CBufferPool::Ptr pool = nullptr) -> std::iostream *;
 
 private:
-    auto addInt32ToFileData (std::stringstream *memory, int32_t i) -> void;
-    auto addInt16ToFileData (std::stringstream *memory, int16_t i) -> void;
-    auto addStringToFileData (std::stringstream *memory, std::string s) -> void;
-    auto BuildHeader(std::stringstream *memory) -> void;
+    auto addInt32ToFileData (std::iostream *memory, int32_t i) -> void;
+    auto addInt16ToFileData (std::iostream *memory, int16_t i) -> void;
+    auto addStringToFileData (std::iostream *memory, std::string s) -> void;
+    auto BuildHeader(std::iostream *memory) -> void;
 
     bool m_headerInit;
     uint32_t m_numChannels;
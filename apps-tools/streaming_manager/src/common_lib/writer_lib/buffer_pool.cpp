@@ -0,0 +1,230 @@
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <algorithm>
+#include "buffer_pool.h"
+
+auto CBufferPool::create(uint64_t maxSize,size_t blockSize) -> CBufferPool::Ptr{
+    return std::make_shared<CBufferPool>(maxSize,blockSize);
+}
+
+CBufferPool::CBufferPool(uint64_t maxSize,size_t blockSize):
+    m_blockSize(blockSize),
+    m_maxSize(maxSize),
+    m_exhausted(0),
+    m_all(),
+    m_free(),
+    m_mtx()
+{
+}
+
+CBufferPool::~CBufferPool(){
+    for(auto block : m_all){
+        free(block);
+    }
+}
+
+auto CBufferPool::acquire() -> uint8_t*{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if (!m_free.empty()){
+        auto block = m_free.back();
+        m_free.pop_back();
+        return block;
+    }
+    if ((m_all.size() + 1) * m_blockSize > m_maxSize){
+        m_exhausted++;
+        return nullptr;
+    }
+    void *block = nullptr;
+    if (posix_memalign(&block,ALIGN,m_blockSize) != 0){
+        m_exhausted++;
+        return nullptr;
+    }
+    m_all.push_back((uint8_t*)block);
+    m_free.reserve(m_all.size());
+    return (uint8_t*)block;
+}
+
+auto CBufferPool::release(uint8_t *block) -> void{
+    if (!block) return;
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_free.push_back(block);
+}
+
+auto CBufferPool::getAllocatedSize() -> uint64_t{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_all.size() * m_blockSize;
+}
+
+auto CBufferPool::getUsedSize() -> uint64_t{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return (m_all.size() - m_free.size()) * m_blockSize;
+}
+
+auto CBufferPool::getExhaustedCount() -> uint64_t{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_exhausted;
+}
+
+CPoolStreamBuf::CPoolStreamBuf(CBufferPool::Ptr pool):
+    m_pool(pool),
+    m_blockSize(pool->getBlockSize()),
+    m_blocks(),
+    m_size(0),
+    m_pBlock(0),
+    m_gBlock(0),
+    m_gPos(0)
+{
+}
+
+CPoolStreamBuf::~CPoolStreamBuf(){
+    for(auto block : m_blocks){
+        m_pool->release(block);
+    }
+}
+
+auto CPoolStreamBuf::syncSize() -> void{
+    if (pbase()){
+        m_size = std::max(m_size,putPos());
+    }
+}
+
+auto CPoolStreamBuf::getPos() -> uint64_t{
+    if (eback()){
+        return m_gBlock * m_blockSize + (gptr() - eback());
+    }
+    return m_gPos;
+}
+
+auto CPoolStreamBuf::putPos() -> uint64_t{
+    if (pbase()){
+        return m_pBlock * m_blockSize + (pptr() - pbase());
+    }
+    return m_pBlock * m_blockSize;
+}
+
+auto CPoolStreamBuf::setGetPos(uint64_t pos) -> void{
+    if (pos < m_size){
+        m_gBlock = pos / m_blockSize;
+        auto block = (char*)m_blocks[m_gBlock];
+        auto end = std::min<uint64_t>(m_blockSize, m_size - m_gBlock * m_blockSize);
+        setg(block, block + pos % m_blockSize, block + end);
+    }else{
+        setg(nullptr,nullptr,nullptr);
+        m_gPos = pos;
+    }
+}
+
+auto CPoolStreamBuf::setPutPos(uint64_t pos) -> void{
+    m_pBlock = pos / m_blockSize;
+    if (m_pBlock < m_blocks.size()){
+        auto block = (char*)m_blocks[m_pBlock];
+        setp(block, block + m_blockSize);
+        pbump((int)(pos % m_blockSize));
+    }else{
+        // Only possible on a block boundary at the end of data
+        setp(nullptr,nullptr);
+    }
+}
+
+auto CPoolStreamBuf::overflow(int_type c) -> int_type{
+    if (!pbase() || pptr() == epptr()){
+        syncSize();
+        size_t idx = pbase() ? m_pBlock + 1 : m_pBlock;
+        if (idx == m_blocks.size()){
+            auto block = m_pool->acquire();
+            if (!block){
+                return traits_type::eof();
+            }
+            m_blocks.push_back(block);
+        }
+        m_pBlock = idx;
+        auto block = (char*)m_blocks[m_pBlock];
+        setp(block, block + m_blockSize);
+    }
+    if (!traits_type::eq_int_type(c, traits_type::eof())){
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+auto CPoolStreamBuf::underflow() -> int_type{
+    syncSize();
+    setGetPos(getPos());
+    if (gptr() < egptr()){
+        return traits_type::to_int_type(*gptr());
+    }
+    return traits_type::eof();
+}
+
+auto CPoolStreamBuf::xsputn(const char_type* s, std::streamsize n) -> std::streamsize{
+    std::streamsize done = 0;
+    while(done < n){
+        if (pptr() == epptr()){
+            if (traits_type::eq_int_type(overflow(traits_type::eof()), traits_type::eof())){
+                break;
+            }
+        }
+        auto chunk = std::min<std::streamsize>(n - done, epptr() - pptr());
+        memcpy(pptr(), s + done, chunk);
+        pbump((int)chunk);
+        done += chunk;
+    }
+    return done;
+}
+
+auto CPoolStreamBuf::xsgetn(char_type* s, std::streamsize n) -> std::streamsize{
+    std::streamsize done = 0;
+    while(done < n){
+        if (gptr() == egptr()){
+            if (traits_type::eq_int_type(underflow(), traits_type::eof())){
+                break;
+            }
+        }
+        auto chunk = std::min<std::streamsize>(n - done, egptr() - gptr());
+        memcpy(s + done, gptr(), chunk);
+        gbump((int)chunk);
+        done += chunk;
+    }
+    return done;
+}
+
+auto CPoolStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) -> pos_type{
+    syncSize();
+    int64_t base = 0;
+    if (dir == std::ios_base::end){
+        base = m_size;
+    }else if (dir == std::ios_base::cur){
+        base = (which & std::ios_base::in) ? getPos() : putPos();
+    }
+    int64_t pos = base + off;
+    if (pos < 0 || (uint64_t)pos > m_size){
+        return pos_type(off_type(-1));
+    }
+    if (which & std::ios_base::in){
+        setGetPos(pos);
+    }
+    if (which & std::ios_base::out){
+        setPutPos(pos);
+    }
+    return pos_type(pos);
+}
+
+auto CPoolStreamBuf::seekpos(pos_type pos, std::ios_base::openmode which) -> pos_type{
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+CPoolStream::CPoolStream(CBufferPool::Ptr pool):
+    std::iostream(nullptr),
+    m_buf(pool)
+{
+    rdbuf(&m_buf);
+}
+
+auto createMemoryStream(CBufferPool::Ptr pool) -> std::iostream*{
+    if (pool){
+        return new CPoolStream(pool);
+    }
+    return new std::stringstream(std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+}
@@ -0,0 +1,101 @@
+#ifndef WRITER_LIB_BUFFER_POOL_H
+#define WRITER_LIB_BUFFER_POOL_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <iostream>
+
+/*
+ * Fixed-size aligned blocks shared between the streaming thread, which fills
+ * them, and the file writer thread, which returns them after writing.
+ * Blocks are allocated on first use and are never freed while the pool is
+ * alive. When maxSize is reached acquire() returns nullptr instead of growing.
+ */
+class CBufferPool
+{
+public:
+
+    using Ptr = std::shared_ptr<CBufferPool>;
+
+    static constexpr size_t BLOCK_SIZE = 256 * 1024;
+    static constexpr size_t ALIGN      = 4096;
+
+    static auto create(uint64_t maxSize,size_t blockSize = BLOCK_SIZE) -> Ptr;
+
+    CBufferPool(uint64_t maxSize,size_t blockSize);
+    ~CBufferPool();
+
+    auto acquire() -> uint8_t*;
+    auto release(uint8_t *block) -> void;
+
+    auto getBlockSize() const -> size_t { return m_blockSize; }
+    auto getMaxSize() const -> uint64_t { return m_maxSize; }
+    auto getAllocatedSize() -> uint64_t;
+    auto getUsedSize() -> uint64_t;
+    auto getExhaustedCount() -> uint64_t;
+
+private:
+
+    CBufferPool(const CBufferPool &) = delete;
+    CBufferPool(CBufferPool &&) = delete;
+    CBufferPool& operator=(const CBufferPool&) =delete;
+    CBufferPool& operator=(const CBufferPool&&) =delete;
+
+    size_t   m_blockSize;
+    uint64_t m_maxSize;
+    uint64_t m_exhausted;
+    std::vector<uint8_t*> m_all;
+    std::vector<uint8_t*> m_free;
+    std::mutex m_mtx;
+};
+
+/*
+ * Seekable stream buffer over a chain of pool blocks. Supports everything the
+ * TDMS/WAV/BIN builders and the queue use: write, read, seekg/tellg and
+ * seekp/tellp inside the written range. If the pool is exhausted the write
+ * fails and the stream gets badbit. Blocks go back to the pool on destruction.
+ */
+class CPoolStreamBuf : public std::streambuf
+{
+public:
+    CPoolStreamBuf(CBufferPool::Ptr pool);
+    ~CPoolStreamBuf();
+
+protected:
+    auto overflow(int_type c) -> int_type override;
+    auto underflow() -> int_type override;
+    auto xsputn(const char_type* s, std::streamsize n) -> std::streamsize override;
+    auto xsgetn(char_type* s, std::streamsize n) -> std::streamsize override;
+    auto seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) -> pos_type override;
+    auto seekpos(pos_type pos, std::ios_base::openmode which) -> pos_type override;
+
+private:
+    auto syncSize() -> void;
+    auto getPos() -> uint64_t;
+    auto putPos() -> uint64_t;
+    auto setGetPos(uint64_t pos) -> void;
+    auto setPutPos(uint64_t pos) -> void;
+
+    CBufferPool::Ptr m_pool;
+    size_t   m_blockSize;
+    std::vector<uint8_t*> m_blocks;
+    uint64_t m_size;
+    size_t   m_pBlock;
+    size_t   m_gBlock;
+    uint64_t m_gPos; // Used when there is no get area
+};
+
+class CPoolStream : public std::iostream
+{
+public:
+    CPoolStream(CBufferPool::Ptr pool);
+
+private:
+    CPoolStreamBuf m_buf;
+};
+
+// Pooled stream if the pool is set, otherwise std::stringstream
+auto createMemoryStream(CBufferPool::Ptr pool) -> std::iostream*;
+
+#endif
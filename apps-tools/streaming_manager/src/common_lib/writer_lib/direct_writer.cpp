@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include "direct_writer.h"
+#include "data_lib/thread_cout.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+CDirectFileWriter::CDirectFileWriter():
+    m_fd(-1),
+    m_blocks(),
+    m_free(),
+    m_requests(),
+    m_inFlight(0),
+    m_workers(),
+    m_stop(false),
+    m_current(nullptr),
+    m_currentSize(0),
+    m_offset(0),
+    m_writeSize(0),
+    m_error(false),
+    m_errno(0)
+{
+}
+
+CDirectFileWriter::~CDirectFileWriter(){
+    close();
+}
+
+auto CDirectFileWriter::open(std::string fileName) -> bool{
+#ifdef __linux__
+    if (m_fd >= 0){
+        return false;
+    }
+    m_fd = ::open(fileName.c_str(),O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT,0644);
+    if (m_fd < 0){
+        aprintf(stderr,"[CDirectFileWriter] Can't open %s with O_DIRECT: %s\n",fileName.c_str(),strerror(errno));
+        return false;
+    }
+
+    for(uint32_t i = 0; i < BLOCKS; i++){
+        void *block = nullptr;
+        if (posix_memalign(&block,BLOCK_ALIGN,BLOCK_SIZE) != 0){
+            aprintf(stderr,"[CDirectFileWriter] Can't allocate aligned buffer\n");
+            freeBlocks();
+            ::close(m_fd);
+            m_fd = -1;
+            return false;
+        }
+        m_blocks.push_back((uint8_t*)block);
+        m_free.push_back((uint8_t*)block);
+    }
+
+    m_stop = false;
+    m_error = false;
+    m_errno = 0;
+    m_offset = 0;
+    m_writeSize = 0;
+    m_current = nullptr;
+    m_currentSize = 0;
+    m_inFlight = 0;
+    for(uint32_t i = 0; i < IN_FLIGHT; i++){
+        m_workers.emplace_back(&CDirectFileWriter::worker,this);
+    }
+    return true;
+#else
+    (void)fileName;
+    return false;
+#endif
+}
+
+auto CDirectFileWriter::isOpen() -> bool{
+    return m_fd >= 0;
+}
+
+auto CDirectFileWriter::hasError() -> bool{
+    return m_error;
+}
+
+auto CDirectFileWriter::getErrno() -> int{
+    return m_errno;
+}
+
+auto CDirectFileWriter::getWriteSize() -> uint64_t{
+    return m_writeSize;
+}
+
+auto CDirectFileWriter::getFreeBlock() -> uint8_t*{
+    std::unique_lock<std::mutex> lock(m_mtx);
+    m_cv.wait(lock,[this]{ return !m_free.empty() || m_error; });
+    if (m_error){
+        return nullptr;
+    }
+    auto block = m_free.front();
+    m_free.pop_front();
+    return block;
+}
+
+auto CDirectFileWriter::submit(size_t size) -> void{
+    SRequest req;
+    req.block = m_current;
+    req.offset = m_offset;
+    // O_DIRECT needs the length aligned as well, the tail is cut in close()
+    req.size = (size + BLOCK_ALIGN - 1) / BLOCK_ALIGN * BLOCK_ALIGN;
+    if (req.size > size){
+        memset(m_current + size,0,req.size - size);
+    }
+    m_offset += req.size;
+    m_current = nullptr;
+    m_currentSize = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_requests.push_back(req);
+    }
+    m_cv.notify_all();
+}
+
+auto CDirectFileWriter::write(std::streambuf *buffer,uint64_t size) -> bool{
+    if (m_fd < 0 || m_error){
+        return false;
+    }
+    while(size){
+        if (!m_current){
+            m_current = getFreeBlock();
+            if (!m_current){
+                return false;
+            }
+            m_currentSize = 0;
+        }
+        auto part = std::min<uint64_t>(size,BLOCK_SIZE - m_currentSize);
+        auto readed = buffer->sgetn((char*)m_current + m_currentSize,part);
+        if (readed <= 0){
+            break;
+        }
+        m_currentSize += readed;
+        m_writeSize += readed;
+        size -= readed;
+        if (m_currentSize == BLOCK_SIZE){
+            submit(m_currentSize);
+        }
+    }
+    return !m_error;
+}
+
+auto CDirectFileWriter::worker() -> void{
+#ifdef __linux__
+    while(true){
+        SRequest req;
+        {
+            std::unique_lock<std::mutex> lock(m_mtx);
+            m_cv.wait(lock,[this]{ return !m_requests.empty() || m_stop; });
+            if (m_requests.empty()){
+                return;
+            }
+            req = m_requests.front();
+            m_requests.pop_front();
+            m_inFlight++;
+        }
+
+        size_t pos = 0;
+        while(pos < req.size){
+            auto ret = pwrite(m_fd,req.block + pos,req.size - pos,req.offset + pos);
+            if (ret < 0 && errno == EINTR){
+                continue;
+            }
+            if (ret <= 0){
+                m_errno = ret < 0 ? errno : ENOSPC;
+                m_error = true;
+                break;
+            }
+            pos += ret;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            m_free.push_back(req.block);
+            m_inFlight--;
+        }
+        m_cv.notify_all();
+    }
+#endif
+}
+
+auto CDirectFileWriter::waitAll() -> void{
+    std::unique_lock<std::mutex> lock(m_mtx);
+    m_cv.wait(lock,[this]{ return m_requests.empty() && m_inFlight == 0; });
+}
+
+auto CDirectFileWriter::freeBlocks() -> void{
+    for(auto b : m_blocks){
+        free(b);
+    }
+    m_blocks.clear();
+    m_free.clear();
+}
+
+auto CDirectFileWriter::close() -> bool{
+#ifdef __linux__
+    if (m_fd < 0){
+        return false;
+    }
+    if (m_current && m_currentSize && !m_error){
+        submit(m_currentSize);
+    }
+    waitAll();
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for(auto &th : m_workers){
+        if (th.joinable()){
+            th.join();
+        }
+    }
+    m_workers.clear();
+    m_requests.clear();
+
+    // Remove padding of the last block
+    if (ftruncate(m_fd,m_writeSize) != 0 && !m_error){
+        m_errno = errno;
+        m_error = true;
+    }
+    ::close(m_fd);
+    m_fd = -1;
+    m_current = nullptr;
+    freeBlocks();
+    return !m_error;
+#else
+    return false;
+#endif
+}
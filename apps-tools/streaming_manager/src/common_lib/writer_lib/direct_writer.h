@@ -0,0 +1,78 @@
+#ifndef WRITER_LIB_DIRECTWRITER_H
+#define WRITER_LIB_DIRECTWRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <list>
+#include <string>
+#include <streambuf>
+
+/*
+ * Sequential file writer on top of O_DIRECT. Data is copied into aligned
+ * preallocated blocks, full blocks are written with pwrite by several
+ * threads at once, so more than one request is queued on the device.
+ * The last partial block is padded and the file is truncated on close.
+ * Only available on Linux, open() fails on other systems and on file
+ * systems without O_DIRECT support.
+ */
+class CDirectFileWriter{
+    public:
+
+        static constexpr size_t BLOCK_SIZE = 1024 * 1024;
+        static constexpr size_t BLOCK_ALIGN = 4096;
+        static constexpr uint32_t BLOCKS = 8;
+        static constexpr uint32_t IN_FLIGHT = 4;
+
+        CDirectFileWriter();
+        ~CDirectFileWriter();
+
+        auto open(std::string fileName) -> bool;
+        auto isOpen() -> bool;
+        // Blocks while all buffers are in flight
+        auto write(std::streambuf *buffer,uint64_t size) -> bool;
+        auto close() -> bool;
+        auto hasError() -> bool;
+        auto getErrno() -> int;
+        auto getWriteSize() -> uint64_t;
+
+    private:
+
+        CDirectFileWriter(const CDirectFileWriter &) = delete;
+        CDirectFileWriter(CDirectFileWriter &&) = delete;
+        CDirectFileWriter& operator=(const CDirectFileWriter&) =delete;
+        CDirectFileWriter& operator=(const CDirectFileWriter&&) =delete;
+
+        struct SRequest{
+            uint8_t *block;
+            uint64_t offset;
+            size_t   size;
+        };
+
+        auto worker() -> void;
+        auto getFreeBlock() -> uint8_t*;
+        auto submit(size_t size) -> void;
+        auto waitAll() -> void;
+        auto freeBlocks() -> void;
+
+        int m_fd;
+        std::vector<uint8_t*> m_blocks;
+        std::list<uint8_t*> m_free;
+        std::list<SRequest> m_requests;
+        uint32_t m_inFlight;
+        std::vector<std::thread> m_workers;
+        std::mutex m_mtx;
+        std::condition_variable m_cv;
+        bool m_stop;
+
+        uint8_t *m_current;
+        size_t   m_currentSize;
+        uint64_t m_offset;
+        uint64_t m_writeSize;
+        std::atomic_bool m_error;
+        std::atomic_int  m_errno;
+};
+
+#endif
@@ -81,97 +81,61 @@ auto dirNameOf(const std::string& fname) -> std::string{
 }
 
 
-auto buildTDMSStream(std::map<DataLib::EDataBuffersPackChannel,SBuffPass> new_buffs) -> std::iostream *{
-    TDMS::File outFile;
-    TDMS::WriterSegment segment;
-    vector<shared_ptr<TDMS::Metadata>> data;
-//    std::time_t tim_sec = std::time(0);
-//    std::time_t local = std::mktime(std::localtime(&tim_sec));
-//    std::time_t gmt = std::mktime(std::gmtime(&tim_sec));
-//    auto timezone = static_cast<long> (local - gmt);
-
-    auto root = segment.GenerateRoot();
-    root->TableOfContents.HasMetaData = true;
-    root->TableOfContents.HasRawData = true;
-    data.push_back(root);
-    auto group = segment.GenerateGroup("Group");
+static auto addTDMSGroup(TDMS::WriterSegment &segment,vector<shared_ptr<TDMS::Metadata>> &data,const std::string &name,std::map<DataLib::EDataBuffersPackChannel,SBuffPass> &new_buffs) -> void{
+    auto group = segment.GenerateGroup(name);
     data.push_back(group);
 
-//    auto *time = TDMS::DataType::GetRawTimeValue(tim_sec + timezone);
-//    TDMS::DataType dataprop;
-//    dataprop.InitDataType(TDMS::DataType::TimeStamp,time);
-//    segment.AddProperties(root,"time_stamp_now",dataprop);
-
-
-
-    if (new_buffs.find(DataLib::CH1) != new_buffs.end())
-    {
-        auto settings = new_buffs.at(DataLib::CH1);
+    const char *names[] = {"ch1","ch2","ch3","ch4"};
+    for(auto i = (int)DataLib::CH1; i <= (int)DataLib::CH4; i++){
+        DataLib::EDataBuffersPackChannel ch = (DataLib::EDataBuffersPackChannel)i;
+        if (new_buffs.find(ch) == new_buffs.end())
+            continue;
+        auto settings = new_buffs.at(ch);
         if (settings.bufferLen){
             auto data_type = TDMS::TDMSType::Integer8;
             if (settings.bitsBySample == 16) data_type = TDMS::TDMSType::Integer16;
             if (settings.bitsBySample == 32) data_type = TDMS::TDMSType::SingleFloat;
             auto sampelsCount = settings.samplesCount;
             auto buffer = settings.buffer;
-            auto channel = segment.GenerateChannel("Group", "ch1");
+            auto channel = segment.GenerateChannel(name, names[i - (int)DataLib::CH1]);
             data.push_back(channel);
             segment.AddRaw(channel, data_type, sampelsCount , buffer);
         }
     }
+}
 
-    if (new_buffs.find(DataLib::CH2) != new_buffs.end())
-    {
-        auto settings = new_buffs.at(DataLib::CH2);
-        if (settings.bufferLen){
-            auto data_type = TDMS::TDMSType::Integer8;
-            if (settings.bitsBySample == 16) data_type = TDMS::TDMSType::Integer16;
-            if (settings.bitsBySample == 32) data_type = TDMS::TDMSType::SingleFloat;
-            auto sampelsCount = settings.samplesCount;
-            auto buffer = settings.buffer;
-            auto channel = segment.GenerateChannel("Group", "ch2");
-            data.push_back(channel);
-            segment.AddRaw(channel, data_type, sampelsCount , buffer);
-        }
-    }
+auto buildTDMSStream(std::map<DataLib::EDataBuffersPackChannel,SBuffPass> new_buffs,CBufferPool::Ptr pool) -> std::iostream *{
+    std::map<std::string,std::map<DataLib::EDataBuffersPackChannel,SBuffPass>> groups;
+    groups["Group"] = new_buffs;
+    return buildTDMSStream(groups,pool);
+}
 
-    if (new_buffs.find(DataLib::CH3) != new_buffs.end())
-    {
-        auto settings = new_buffs.at(DataLib::CH3);
-        if (settings.bufferLen){
-            auto data_type = TDMS::TDMSType::Integer8;
-            if (settings.bitsBySample == 16) data_type = TDMS::TDMSType::Integer16;
-            if (settings.bitsBySample == 32) data_type = TDMS::TDMSType::SingleFloat;
-            auto sampelsCount = settings.samplesCount;
-            auto buffer = settings.buffer;
-            auto channel = segment.GenerateChannel("Group", "ch3");
-            data.push_back(channel);
-            segment.AddRaw(channel, data_type, sampelsCount , buffer);
-        }
-    }
+auto buildTDMSStream(std::map<std::string,std::map<DataLib::EDataBuffersPackChannel,SBuffPass>> groups,CBufferPool::Ptr pool) -> std::iostream *{
+    TDMS::File outFile;
+    TDMS::WriterSegment segment;
+    vector<shared_ptr<TDMS::Metadata>> data;
 
-    if (new_buffs.find(DataLib::CH4) != new_buffs.end())
-    {
-        auto settings = new_buffs.at(DataLib::CH4);
-        if (settings.bufferLen){
-            auto data_type = TDMS::TDMSType::Integer8;
-            if (settings.bitsBySample == 16) data_type = TDMS::TDMSType::Integer16;
-            if (settings.bitsBySample == 32) data_type = TDMS::TDMSType::SingleFloat;
-            auto sampelsCount = settings.samplesCount;
-            auto buffer = settings.buffer;
-            auto channel = segment.GenerateChannel("Group", "ch4");
-            data.push_back(channel);
-            segment.AddRaw(channel, data_type, sampelsCount , buffer);
-        }
+    auto root = segment.GenerateRoot();
+    root->TableOfContents.HasMetaData = true;
+    root->TableOfContents.HasRawData = true;
+    data.push_back(root);
+
+    for(auto &kv : groups){
+        addTDMSGroup(segment,data,kv.first,kv.second);
     }
 
     segment.LoadMetadata(data);
-    stringstream *memory = new stringstream(ios_base::in | ios_base::out | ios_base::binary);
+    auto memory = createMemoryStream(pool);
     outFile.WriteMemory(*memory,segment);
+    if (memory->fail()){
+        delete memory;
+        return nullptr;
+    }
     return memory;
 }
 
-auto buildBINStream(DataLib::CDataBuffersPack::Ptr buff_pack,std::map<DataLib::EDataBuffersPackChannel,uint32_t> _samples) -> std::iostream *{
-    stringstream *memory = new stringstream(ios_base::in | ios_base::out | ios_base::binary);
+auto buildBINStream(DataLib::CDataBuffersPack::Ptr buff_pack,std::map<DataLib::EDataBuffersPackChannel,uint32_t> _samples,CBufferPool::Ptr pool) -> std::iostream *{
+    auto memory = createMemoryStream(pool);
     CBinInfo::BinHeader header;
     DataLib::CDataBuffer::Ptr ch[4] = {NULL,NULL,NULL,NULL};
     ch[0] = buff_pack->getBuffer(DataLib::CH1);
@@ -203,6 +167,10 @@ auto buildBINStream(DataLib::CDataBuffersPack::Ptr buff_pack,std::map<DataLib::E
     }
     //Write end segment
     memory->write((const char*)g_endOfSegment,12);
+    if (memory->fail()){
+        delete memory;
+        return nullptr;
+    }
     return memory;
 }
 
@@ -5,6 +5,7 @@
 #include <map>
 
 #include "w_binary.h"
+#include "buffer_pool.h"
 #include "data_lib/buffers_pack.h"
 #include "net_lib/asio_common.h"
 
@@ -25,8 +26,11 @@ auto getFreeSpaceDisk(std::string _filePath) ->  uint64_t;
 auto readBinInfo(std::iostream *buffer) -> CBinInfo;
 auto readCSV(std::iostream *buffer,int64_t *_position,int *_channels,uint64_t *samplePos,bool skipData = false) -> std::iostream *;
 
-auto buildTDMSStream(std::map<DataLib::EDataBuffersPackChannel,SBuffPass> new_buffs) -> std::iostream *;
-auto buildBINStream (DataLib::CDataBuffersPack::Ptr buff_pack, std::map<DataLib::EDataBuffersPackChannel,uint32_t> _samples) -> std::iostream *;
+// If the pool is set, the stream is built from pool blocks. Returns nullptr if the pool is exhausted
+auto buildTDMSStream(std::map<DataLib::EDataBuffersPackChannel,SBuffPass> new_buffs,CBufferPool::Ptr pool = nullptr) -> std::iostream *;
+// One TDMS group per map key, used to write several boards into one segment
+auto buildTDMSStream(std::map<std::string,std::map<DataLib::EDataBuffersPackChannel,SBuffPass>> groups,CBufferPool::Ptr pool = nullptr) -> std::iostream *;
+auto buildBINStream (DataLib::CDataBuffersPack::Ptr buff_pack, std::map<DataLib::EDataBuffersPackChannel,uint32_t> _samples,CBufferPool::Ptr pool = nullptr) -> std::iostream *;
 
 auto dirNameOf(const std::string& fname) -> std::string;
 
@@ -1,4 +1,5 @@
 #include <ctime>
+#include <cstring>
 #include "file_queue_manager.h"
 #include "file_helper.h"
 #include "data_lib/thread_cout.h"
@@ -11,6 +12,10 @@ FileQueueManager::FileQueueManager(bool testMode):Queue(){
     th = nullptr;
     m_testMode = testMode;
     m_fileName = "";
+    m_directWrite = false;
+    m_wavPendingSize = 0;
+    m_memoryLimit = 0;
+    m_pool = nullptr;
 }
 
 FileQueueManager::~FileQueueManager(){
@@ -27,6 +32,18 @@ auto FileQueueManager::deleteFile() -> void{
     }
 }
 
+auto FileQueueManager::setDirectWrite(bool enable) -> void{
+    m_directWrite = enable;
+}
+
+auto FileQueueManager::setMemoryLimit(uint64_t bytes) -> void{
+    m_memoryLimit = bytes;
+}
+
+auto FileQueueManager::getBufferPool() -> CBufferPool::Ptr{
+    return m_pool;
+}
+
 auto FileQueueManager::addBufferToWrite(std::iostream *buffer) -> bool{
     if (!buffer){
         return false;
@@ -55,6 +72,15 @@ auto FileQueueManager::openFile(std::string FileName,bool Append) -> void{
         }
     }
     m_fileName = FileName;
+    m_wavPendingSize = 0;
+    // Test mode rewrites the beginning of the file, it is left on fstream
+    if (m_directWrite && !m_testMode){
+        if (m_direct.open(FileName)){
+            aprintf(stdout,"Direct write: %d x %d Kb buffers, %d in flight\n",CDirectFileWriter::BLOCKS,CDirectFileWriter::BLOCK_SIZE / 1024,CDirectFileWriter::IN_FLIGHT);
+        }else{
+            aprintf(stderr,"Direct write is not supported, use buffered write\n");
+        }
+    }
     auto dirName = dirNameOf(FileName);
     if (dirName == ""){
         dirName = ".";
@@ -67,7 +93,14 @@ auto FileQueueManager::openFile(std::string FileName,bool Append) -> void{
     m_aviablePhyMemory = getTotalSystemMemory();
     aprintf(stdout,"Available physical memory: %d Mb\n",m_aviablePhyMemory / (1024 * 1024));
     m_aviablePhyMemory /= 2;
-    aprintf(stdout,"Used physical memory: %d Mb\n", m_aviablePhyMemory / (1024 * 1024));
+    if (m_memoryLimit){
+        m_aviablePhyMemory = m_memoryLimit;
+    }
+    // Blocks stay allocated between files, the pool is recreated only if the limit changes
+    if (!m_pool || m_pool->getMaxSize() != m_aviablePhyMemory){
+        m_pool = CBufferPool::create(m_aviablePhyMemory);
+    }
+    aprintf(stdout,"Used physical memory: %d Mb (%d Kb blocks)\n", m_aviablePhyMemory / (1024 * 1024),CBufferPool::BLOCK_SIZE / 1024);
     m_hasWriteSize = 0;
 }
 
@@ -121,6 +154,7 @@ auto FileQueueManager::task() -> void{
             bstream = popQueue();
         }
     }
+    closeDirect();
     m_threadWork = false;
     m_waitLock.unlock();
 }
@@ -138,6 +172,16 @@ auto FileQueueManager::writeToFile() -> int{
     bstream->seekg(0, bstream->end);
     auto Length = bstream->tellg();
 
+    if (m_direct.isOpen() && ((m_hasWriteSize + Length) < m_freeSize)) {
+        bstream->seekg(0, bstream->beg);
+        if (writeToDirect(bstream,Length)){
+            delete bstream;
+            return 0;
+        }
+        delete bstream;
+        return 1;
+    }
+
     if (fs.good() && ((m_hasWriteSize + Length) < m_freeSize)) {
         bstream->seekg(0, bstream->beg);
         if (m_testMode) {
@@ -175,6 +219,42 @@ auto FileQueueManager::writeToFile() -> int{
     return 0;
 }
 
+auto FileQueueManager::writeToDirect(std::iostream *bstream,uint64_t length) -> bool{
+    if (!m_direct.write(bstream->rdbuf(),length)){
+        m_IsOutOfSpace  = true;
+        m_hasErrorWrite = true;
+        aprintf(stdout,"Disk is full or error state: %s\n",strerror(m_direct.getErrno()));
+        outSpaceNotifyThread();
+        return false;
+    }
+    m_hasWriteSize += length;
+    if (m_fileType == CStreamSettings::DataFormat::WAV){
+        // The header can only be patched when all blocks are on the disk
+        if (m_firstSectionWrite){
+            m_wavPendingSize += length;
+        }
+        m_firstSectionWrite = true;
+    }
+    return true;
+}
+
+auto FileQueueManager::closeDirect() -> void{
+    if (!m_direct.isOpen()){
+        return;
+    }
+    if (!m_direct.close() && !m_hasErrorWrite){
+        m_IsOutOfSpace  = true;
+        m_hasErrorWrite = true;
+        aprintf(stdout,"Disk is full or error state: %s\n",strerror(m_direct.getErrno()));
+        outSpaceNotifyThread();
+    }
+    if (m_fileType == CStreamSettings::DataFormat::WAV && m_wavPendingSize){
+        updateWavFile(m_wavPendingSize);
+        fs.flush();
+    }
+    m_wavPendingSize = 0;
+}
+
 auto FileQueueManager::outSpaceNotifyThread() -> void{
     try{
         std::thread th([this](){
@@ -10,6 +10,8 @@
 #include <fstream>
 #include <iostream>
 #include "w_queue.h"
+#include "direct_writer.h"
+#include "buffer_pool.h"
 #include "data_lib/thread_cout.h"
 #include "data_lib/signal.hpp"
 #include "settings_lib/stream_settings.h"
@@ -30,6 +32,12 @@ class FileQueueManager:public Queue{
         auto updateWavFile(int _size) -> void;
         auto writeToFile() -> int;
         auto deleteFile() -> void;
+        // Use O_DIRECT writer for the next openFile. Falls back to fstream if it is not supported.
+        auto setDirectWrite(bool enable) -> void;
+        // Ceiling for blocks waiting to be written. 0 - half of physical memory. Applied on openFile
+        auto setMemoryLimit(uint64_t bytes) -> void;
+        // Streams for addBufferToWrite must be built from this pool
+        auto getBufferPool() -> CBufferPool::Ptr;
 
         sigslot::signal<> outSpaceNotify;
         sigslot::signal<> stopNotify;
@@ -38,6 +46,8 @@ class FileQueueManager:public Queue{
 
         auto task() -> void;
         auto outSpaceNotifyThread() -> void;
+        auto writeToDirect(std::iostream *bstream,uint64_t length) -> bool;
+        auto closeDirect() -> void;
 
         std::fstream fs;
         std::thread *th;
@@ -55,6 +65,11 @@ class FileQueueManager:public Queue{
         uint64_t m_aviablePhyMemory;
         bool m_testMode;
         std::string m_fileName;
+        bool m_directWrite;
+        CDirectFileWriter m_direct;
+        int64_t m_wavPendingSize;
+        uint64_t m_memoryLimit;
+        CBufferPool::Ptr m_pool;
 };
 
 #endif
@@ -6,8 +6,12 @@
 #include <functional>
 #include <inttypes.h>
 #include <chrono>
+#include <cstring>
+#include <fstream>
+#include <vector>
 #include "converter_lib/converter.h"
 #include "writer_lib/file_helper.h"
+#include "reader_lib/bin_reader_api.h"
 #include "data_lib/thread_cout.h"
 
 
@@ -41,10 +45,12 @@ bool CheckMissing(const char* val,const char* Message)
 }
 
 void UsingArgs(char const* progName){
-    std::cout << "Usage: " << progName << " file_name [-i][-s start][-e end]\n";
+    std::cout << "Usage: " << progName << " file_name [-i][-s start][-e end][-t threads][-b]\n";
     std::cout << "\t-i get info about file\n";
     std::cout << "\t-s Segment from which the conversion starts\n";
     std::cout << "\t-e Segment where the conversion will end\n";
+    std::cout << "\t-t Number of formatting threads. 0 - sequential converter\n";
+    std::cout << "\t-b Benchmark: convert with the sequential and the pipelined converter and compare the results\n";
 
 }
 
@@ -52,6 +58,49 @@ void sigHandlerStopCSV (int){
     g_converter->stopWriteToCSV();
 }
 
+auto compareFiles(std::string file1,std::string file2) -> bool{
+    std::ifstream f1(file1, std::ios::binary);
+    std::ifstream f2(file2, std::ios::binary);
+    if (f1.fail() || f2.fail()) return false;
+    std::vector<char> b1(1024 * 1024);
+    std::vector<char> b2(1024 * 1024);
+    while(f1 && f2){
+        f1.read(b1.data(),b1.size());
+        f2.read(b2.data(),b2.size());
+        if (f1.gcount() != f2.gcount()) return false;
+        if (memcmp(b1.data(),b2.data(),f1.gcount()) != 0) return false;
+    }
+    return f1.eof() && f2.eof();
+}
+
+auto benchmark(std::string file_name,int32_t s,int32_t e,uint32_t threads) -> int{
+    std::string csv_file = file_name.substr(0, file_name.size()-3) + "csv";
+    std::string seq_file = csv_file + ".seq";
+    auto run = [&](uint32_t t) -> double{
+        auto begin = std::chrono::steady_clock::now();
+        g_converter->setThreads(t);
+        g_converter->convertToCSV(file_name,s,e,t == 0 ? "sequential" : "pipelined");
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    };
+
+    auto seqTime = run(0);
+    std::remove(seq_file.c_str());
+    std::rename(csv_file.c_str(),seq_file.c_str());
+    auto pipeTime = run(threads);
+
+    std::ifstream in(csv_file, std::ios::binary | std::ios::ate);
+    double size = in.fail() ? 0 : (double)in.tellg() / (1024 * 1024);
+    bool same = compareFiles(seq_file,csv_file);
+    std::remove(seq_file.c_str());
+
+    aprintf(stdout,"\nCSV size: %.1f Mb\n",size);
+    aprintf(stdout,"Sequential:\t%.3f s\t%.1f Mb/s\n",seqTime,seqTime > 0 ? size / seqTime : 0);
+    aprintf(stdout,"Pipelined (%d threads):\t%.3f s\t%.1f Mb/s\n",threads,pipeTime,pipeTime > 0 ? size / pipeTime : 0);
+    aprintf(stdout,"Speedup:\t%.2f\n",pipeTime > 0 ? seqTime / pipeTime : 0);
+    aprintf(stdout,"Output:\t%s\n",same ? "IDENTICAL" : "DIFFERENT");
+    return same ? 0 : -1;
+}
+
 int ParseInt(string value) noexcept{
     try {
         int x = std::stoi (value);
@@ -77,6 +126,8 @@ int main(int argc, char* argv[])
     }
 
     bool check_info = cmdOptionExists(argv, argv + argc, "-i");
+    bool bench = cmdOptionExists(argv, argv + argc, "-b");
+    int32_t threads = -1;
     int32_t s = -2;
     int32_t e = -2;
     if (cmdOptionExists(argv, argv + argc, "-s")){
@@ -105,40 +156,79 @@ int main(int argc, char* argv[])
         }
     }
 
+    if (cmdOptionExists(argv, argv + argc, "-t")){
+        char *threads_char  = getCmdOption(argv, argv + argc, "-t");
+        if (CheckMissing(threads_char,"threads")){
+            UsingArgs(argv[0]);
+            return -1;
+        }
+        // 0 is allowed here
+        threads = threads_char[0] == '0' && threads_char[1] == 0 ? 0 : ParseInt(threads_char);
+        if (threads == -1) {
+            UsingArgs(argv[0]);
+            return -1;
+        }
+    }
+
     if (s >0 && e >0 && s > e) {
         std::cout << "The start segment must be less than or equal to the end.\n";
         return -1;
     }
     
     std::string file_name = argv[1];
+    if (bench){
+        g_converter = converter_lib::CConverter::create();
+        if (threads <= 0) threads = g_converter->getThreads();
+        return benchmark(file_name,s,e,threads);
+    }
     if (!check_info){
         g_converter = converter_lib::CConverter::create();
+        if (threads >= 0) g_converter->setThreads(threads);
         g_converter->convertToCSV(file_name,s,e,"");
     }else{
-        std::fstream fs;
-        fs.open(file_name, std::ios::binary | std::ofstream::in | std::ofstream::out);
-        if (fs.fail()) {
+        auto reader = bin_reader_open(file_name.c_str(),1);
+        if (!reader) {
             std::cout <<" Error open file: " << file_name << "\n";
         }else{
-            auto bi = readBinInfo(&fs);
+            uint64_t segCount = bin_reader_segments_count(reader);
+            uint64_t samples_ch[4] = {0,0,0,0};
+            uint64_t lost_ch[4] = {0,0,0,0};
+            uint8_t  format_ch[4] = {0,0,0,0};
+            uint64_t segSamplesCount = 0;
+            uint64_t segLastSamplesCount = 0;
+            for(uint64_t seg = 0; seg < segCount; seg++){
+                bin_segment_info_t info;
+                bin_reader_segment_info(reader,seg,&info);
+                uint64_t samplesCount = 0;
+                for(int i = 0; i < 4 ; i++){
+                    if (info.format_size[i]){
+                        format_ch[i] = info.format_size[i];
+                        samplesCount += info.size_ch[i] / info.format_size[i];
+                        samples_ch[i] += info.size_ch[i] / info.format_size[i];
+                    }
+                    lost_ch[i] += info.lost_ch[i];
+                }
+                if (seg == 0) segSamplesCount = samplesCount;
+                segLastSamplesCount = samplesCount;
+            }
 
-            aprintf(stdout,"Segments count: %llu\n",bi.segCount);
-            aprintf(stdout,"Samples per segment: %llu\n",bi.segSamplesCount);
-            aprintf(stdout,"Samples in last segment: %llu\n",bi.segLastSamplesCount);
-            aprintf(stdout,"Status of last segment: %s\n",bi.lastSegState ? "OK": "BROKEN");
+            aprintf(stdout,"Segments count: %llu\n",segCount);
+            aprintf(stdout,"Samples per segment: %llu\n",segSamplesCount);
+            aprintf(stdout,"Samples in last segment: %llu\n",segLastSamplesCount);
+            aprintf(stdout,"Status of last segment: %s\n",bin_reader_last_segment_ok(reader) ? "OK": "BROKEN");
+            aprintf(stdout,"Index: %s\n",bin_reader_index_from_cache(reader) ? "loaded from cache": "built");
 
             for(int i = 0; i < 4 ; i++){
                 aprintf(stdout,"\nChannel %d:\n",i+1);
                 string dft = "Unknown";
-                if (bi.dataFormatSize[i] == 1) dft = "Int8";
-                if (bi.dataFormatSize[i] == 2) dft = "Int16";
-                if (bi.dataFormatSize[i] == 4) dft = "Float";
+                if (format_ch[i] == 1) dft = "Int8";
+                if (format_ch[i] == 2) dft = "Int16";
+                if (format_ch[i] == 4) dft = "Float";
                 aprintf(stdout,"\tData format type:\t%s\n",dft.c_str());
-                aprintf(stdout,"\tSamples count:\t%llu\n",bi.samples_ch[i]);
-                aprintf(stdout,"\tLost samples count: %llu\n",bi.lostCount[i]);
+                aprintf(stdout,"\tSamples count:\t%llu\n",samples_ch[i]);
+                aprintf(stdout,"\tLost samples count: %llu\n",lost_ch[i]);
             }
-
-
+            bin_reader_close(reader);
         }
     }
 
@@ -0,0 +1,191 @@
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#include "aggregator.h"
+#include "data_lib/latency_histogram.h"
+#include "data_lib/thread_cout.h"
+#include "options.h"
+#include "config.h"
+
+CPackAggregator::SHost::SHost(const std::string &_name):
+    name(_name),
+    queue(AGGREGATOR_QUEUE_SIZE),
+    finished(false),
+    dropped(0),
+    networkLost(0),
+    written(0),
+    missing(0),
+    late(0),
+    skewSum(0),
+    skewMax(0)
+{}
+
+auto CPackAggregator::create(streaming_lib::CStreamingFile::Ptr file,const std::vector<std::string> &hosts) -> CPackAggregator::Ptr{
+    return std::make_shared<CPackAggregator>(file,hosts);
+}
+
+CPackAggregator::CPackAggregator(streaming_lib::CStreamingFile::Ptr file,const std::vector<std::string> &hosts):
+    m_file(file),
+    m_hosts(),
+    m_thread(),
+    m_stop(false),
+    m_hasLast(false),
+    m_lastId(0),
+    m_waitSince(0),
+    m_segments(0)
+{
+    for(auto &host : hosts){
+        m_hosts.push_back(std::make_unique<SHost>(host));
+    }
+}
+
+CPackAggregator::~CPackAggregator(){
+    stop();
+}
+
+auto CPackAggregator::start() -> void{
+    m_stop = false;
+    m_thread = std::thread(&CPackAggregator::writerThread, this);
+}
+
+auto CPackAggregator::stop() -> void{
+    m_stop = true;
+    if (m_thread.joinable()){
+        m_thread.join();
+    }
+}
+
+auto CPackAggregator::getFile() -> streaming_lib::CStreamingFile::Ptr{
+    return m_file;
+}
+
+auto CPackAggregator::getHost(const std::string &host) -> SHost*{
+    for(auto &h : m_hosts){
+        if (h->name == host)
+            return h.get();
+    }
+    return nullptr;
+}
+
+auto CPackAggregator::push(const std::string &host,DataLib::CDataBuffersPack::Ptr pack,uint64_t id) -> bool{
+    auto h = getHost(host);
+    if (!h) return false;
+    SItem item;
+    item.pack = pack;
+    item.id = id;
+    item.time = DataLib::CLatencyHistogram::now();
+    if (!h->queue.push(std::move(item))){
+        h->dropped++;
+        return false;
+    }
+    return true;
+}
+
+auto CPackAggregator::addNetWorkLost(const std::string &host,uint64_t count) -> void{
+    auto h = getHost(host);
+    if (h){
+        h->networkLost += count;
+    }
+    m_file->addNetWorkLost(count);
+}
+
+auto CPackAggregator::finish(const std::string &host) -> void{
+    auto h = getHost(host);
+    if (h){
+        h->finished = true;
+    }
+}
+
+auto CPackAggregator::writerThread() -> void{
+    while(true){
+        bool drain = m_stop;
+        if (!writeNext(drain)){
+            if (drain) break;
+            sleepMs(1);
+        }
+    }
+}
+
+// Writes one segment with the smallest queued pack ID. Returns false if there was nothing to write
+auto CPackAggregator::writeNext(bool drain) -> bool{
+    uint64_t target = UINT64_MAX;
+    bool waiting = false;
+    bool pressure = false;
+    for(auto &h : m_hosts){
+        // Packs older than the last written segment came too late, their segment is already in the file
+        auto item = h->queue.front();
+        while(item && m_hasLast && item->id <= m_lastId){
+            h->late++;
+            h->queue.pop();
+            item = h->queue.front();
+        }
+        if (item){
+            target = std::min(target,item->id);
+            if (h->queue.size() * 2 >= h->queue.capacity())
+                pressure = true;
+        }else if (!h->finished){
+            waiting = true;
+        }
+    }
+
+    if (target == UINT64_MAX)
+        return false;
+
+    auto now = DataLib::CLatencyHistogram::now();
+    if (waiting && !drain && !pressure){
+        if (m_waitSince == 0)
+            m_waitSince = now;
+        if (now - m_waitSince < (uint64_t)AGGREGATOR_MAX_WAIT_MS * 1000000)
+            return false;
+    }
+    m_waitSince = 0;
+
+    std::map<std::string,DataLib::CDataBuffersPack::Ptr> packs;
+    std::vector<std::pair<SHost*,uint64_t>> arrivals;
+    uint64_t first = UINT64_MAX;
+    for(auto &h : m_hosts){
+        auto item = h->queue.front();
+        if (item && item->id == target){
+            packs[h->name] = item->pack;
+            arrivals.push_back({h.get(),item->time});
+            first = std::min(first,item->time);
+            h->written++;
+            h->queue.pop();
+        }else{
+            h->missing++;
+        }
+    }
+
+    // Skew is the arrival time of the pack relative to the first board that delivered the same pack ID
+    for(auto &a : arrivals){
+        auto skew = a.second - first;
+        a.first->skewSum += skew;
+        a.first->skewMax = std::max(a.first->skewMax,skew);
+    }
+
+    m_hasLast = true;
+    m_lastId = target;
+    m_segments++;
+    m_file->passGroups(packs);
+    return true;
+}
+
+auto CPackAggregator::printStatistic() -> void{
+    std::stringstream ss;
+    ss << "\n" << getTS() << " Aggregated segments: " << m_segments << "\n";
+    ss << "Host              | Written packs | Missing packs | Late packs | Dropped packs | Broken packs | Avg skew, ms | Max skew, ms |\n";
+    ss << "------------------|---------------|---------------|------------|---------------|--------------|--------------|--------------|\n";
+    for(auto &h : m_hosts){
+        double avg = h->written ? (double)h->skewSum / h->written / 1000000.0 : 0;
+        ss << std::left << std::setw(18) << h->name << "|";
+        ss << " " << std::setw(14) << h->written << "|";
+        ss << " " << std::setw(14) << h->missing << "|";
+        ss << " " << std::setw(11) << h->late << "|";
+        ss << " " << std::setw(14) << h->dropped << "|";
+        ss << " " << std::setw(13) << h->networkLost << "|";
+        ss << " " << std::setw(13) << std::fixed << std::setprecision(3) << avg << "|";
+        ss << " " << std::setw(13) << std::fixed << std::setprecision(3) << (double)h->skewMax / 1000000.0 << "|\n";
+    }
+    aprintf(stdout,"%s",ss.str().c_str());
+}
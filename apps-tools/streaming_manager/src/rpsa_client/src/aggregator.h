@@ -0,0 +1,95 @@
+#ifndef AGGREGATOR_H
+#define AGGREGATOR_H
+
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <string>
+
+#include "data_lib/buffers_pack.h"
+#include "data_lib/spsc_queue.h"
+#include "streaming_lib/streaming_file.h"
+
+#define AGGREGATOR_QUEUE_SIZE 64
+#define AGGREGATOR_MAX_WAIT_MS 500
+
+/*
+ * Writes the streams of several boards into one file. Every board gets its
+ * own queue that is filled by the network thread of the board, one writer
+ * thread takes packs with the same pack ID from all queues and writes them as
+ * one TDMS segment with a group per board.
+ *
+ * A board that has no pack for the ID is counted as missing for that segment.
+ * The writer waits for a late board at most AGGREGATOR_MAX_WAIT_MS, or until
+ * the queue of another board is half full.
+ */
+class CPackAggregator{
+
+public:
+
+    using Ptr = std::shared_ptr<CPackAggregator>;
+
+    static auto create(streaming_lib::CStreamingFile::Ptr file,const std::vector<std::string> &hosts) -> Ptr;
+
+    CPackAggregator(streaming_lib::CStreamingFile::Ptr file,const std::vector<std::string> &hosts);
+    ~CPackAggregator();
+
+    auto start() -> void;
+    // Writes out all queued packs and stops the writer thread
+    auto stop() -> void;
+
+    auto getFile() -> streaming_lib::CStreamingFile::Ptr;
+
+    // Called from the network thread of the host. Returns false if the queue is full and the pack is dropped
+    auto push(const std::string &host,DataLib::CDataBuffersPack::Ptr pack,uint64_t id) -> bool;
+    auto addNetWorkLost(const std::string &host,uint64_t count) -> void;
+    // The host will not send any more packs, the writer stops waiting for it
+    auto finish(const std::string &host) -> void;
+
+    auto printStatistic() -> void;
+
+private:
+
+    CPackAggregator(const CPackAggregator &) = delete;
+    CPackAggregator(CPackAggregator &&) = delete;
+    CPackAggregator& operator=(const CPackAggregator&) =delete;
+    CPackAggregator& operator=(const CPackAggregator&&) =delete;
+
+    struct SItem{
+        DataLib::CDataBuffersPack::Ptr pack = nullptr;
+        uint64_t id = 0;
+        uint64_t time = 0;
+    };
+
+    struct SHost{
+        std::string name;
+        DataLib::CSPSCQueue<SItem> queue;
+        std::atomic<bool> finished;
+        std::atomic<uint64_t> dropped;
+        std::atomic<uint64_t> networkLost;
+        // Only used by the writer thread
+        uint64_t written;
+        uint64_t missing;
+        uint64_t late;
+        uint64_t skewSum;
+        uint64_t skewMax;
+
+        SHost(const std::string &_name);
+    };
+
+    auto getHost(const std::string &host) -> SHost*;
+    auto writerThread() -> void;
+    auto writeNext(bool drain) -> bool;
+
+    streaming_lib::CStreamingFile::Ptr m_file;
+    std::vector<std::unique_ptr<SHost>> m_hosts;
+    std::thread m_thread;
+    std::atomic<bool> m_stop;
+    bool m_hasLast;
+    uint64_t m_lastId;
+    uint64_t m_waitSince;
+    uint64_t m_segments;
+};
+
+#endif
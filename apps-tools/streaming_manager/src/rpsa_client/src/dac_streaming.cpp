@@ -50,6 +50,9 @@ auto dac_runClient(DacSettings conf) -> void{
         case CStreamSettings::WAV:
             file_type = CDACStreamingManager::WAV_TYPE;
             break;
+        case CStreamSettings::BIN:
+            file_type = CDACStreamingManager::BIN_TYPE;
+            break;
         default:
             stopDACStreaming(conf.host);
             return;
@@ -244,6 +247,9 @@ auto startDACStreaming(std::shared_ptr<ClientNetConfigManager> cl,ClientOpt::Opt
                     case ClientOpt::StreamingType::WAV:
                         conf.file_type = CStreamSettings::WAV;
                         break;
+                    case ClientOpt::StreamingType::BIN:
+                        conf.file_type = CStreamSettings::BIN;
+                        break;
                     default:
                         conf.file_type = CStreamSettings::UNDEF;
                         return;
@@ -58,10 +58,11 @@ static struct option long_options_streaming[] = {
         {"timeout",      required_argument, 0, 't'},
         {"verbose",      no_argument,       0, 'v'},
         {"benchmark",    required_argument, 0, 'b'},
+        {"aggregate",    no_argument,       0, 'a'},
         {0, 0, 0, 0}
 };
 
-static constexpr char optstring_streaming[] = "sh:p:c:f:d:l:m:t:vb:";
+static constexpr char optstring_streaming[] = "sh:p:c:f:d:l:m:t:vb:a";
 
 static struct option long_options_dac_streaming[] = {
         /* These options set a flag. */
@@ -289,8 +290,8 @@ auto ClientOpt::usage(char const* progName) -> void{
             "\tThis mode allows you to control streaming as a client, and also captures data in network streaming mode.\n"
             "\n"
             "\tOptions:\n"
-            "\t\t%s -s -h IPs [-p PORT] [-c PORT] -f tdms|wav|csv|bin [-d NAME] [-m raw|volt] [-l SAMPLES] [-t MSEC] [-v] [-b TD|F]\n"
-            "\t\t%s --streaming --hosts=IPs [--port=PORT] [--config_port=PORT] --format=tdms|wav|csv|bin [--dir=NAME] [--limit=SAMPLES] [--mode=raw|volt] [--timeout=MSEC] [--verbose] [--benchmark=TD|F]\n"
+            "\t\t%s -s -h IPs [-p PORT] [-c PORT] -f tdms|wav|csv|bin [-d NAME] [-m raw|volt] [-l SAMPLES] [-t MSEC] [-v] [-b TD|F] [-a]\n"
+            "\t\t%s --streaming --hosts=IPs [--port=PORT] [--config_port=PORT] --format=tdms|wav|csv|bin [--dir=NAME] [--limit=SAMPLES] [--mode=raw|volt] [--timeout=MSEC] [--verbose] [--benchmark=TD|F] [--aggregate]\n"
             "\n"
             "\t\t--streaming            -s           Enable streaming mode.\n"
             "\t\t--hosts=IP,...         -h IP,...    You can specify one or more board IP addresses through a separator - ','\n"
@@ -314,13 +315,15 @@ auto ClientOpt::usage(char const* progName) -> void{
             "\t\t--benchmark=MODE       -b MODE      Starts the throughput test mode at the current settings.\n"
             "\t\t                                    Keys: TD = Adds validation of data. Works only in network test mode.\n"
             "\t\t                                          F  = Full system performance testing.\n"
+            "\t\t--aggregate            -a           Writes all boards into one file, aligned by packet number. Each board is a separate group.\n"
+            "\t\t                                    Only for the tdms format.\n"
             "\n"
             "DAC streaming Mode:\n"
             "\tThis mode allows you to generate output data using a signal from a file.\n"
             "\n"
             "\tOptions:\n"
-            "\t\t%s -o -h IPs [-p PORT] [-c PORT] -f tdms|wav -d FILE_NAME [-r inf|COUNT] [-m SIZE] [-v] [-b]\n"
-            "\t\t%s --out_streaming --hosts=IPs [--port=PORT] [--config_port=PORT] --format=tdms|wav --data=FILE_NAME [--repeat=inf|COUNT] [--memory SIZE] [--verbose] [--benchmark]\n"
+            "\t\t%s -o -h IPs [-p PORT] [-c PORT] -f tdms|wav|bin -d FILE_NAME [-r inf|COUNT] [-m SIZE] [-v] [-b]\n"
+            "\t\t%s --out_streaming --hosts=IPs [--port=PORT] [--config_port=PORT] --format=tdms|wav|bin --data=FILE_NAME [--repeat=inf|COUNT] [--memory SIZE] [--verbose] [--benchmark]\n"
             "\t\t%s -oc CONFIG_FILE\n"
             "\t\t%s --out_streaming_conf CONFIG_FILE\n"
             "\n"
@@ -334,6 +337,7 @@ auto ClientOpt::usage(char const* progName) -> void{
             "\t\t--format=FORMAT        -f FORMAT    The format in which the data will be used.\n"
             "\t\t                                    Keys: tdsm = NI TDMS File Format.\n"
             "\t\t                                          wav = Waveform Audio File Format.\n"
+            "\t\t                                          bin = Binary format of streaming files. Only 16 bit data.\n"
             "\t\t--data=FILE_NAME       -d FILE_NAME Path to the file for streaming.\n"
             "\t\t--memory=SIZE          -m SIZE      Use RAM cache.\n"
             "\t\t                                        Example: --mmemory 1048576 or --memory 1M or --memory 1024k\n"
@@ -615,6 +619,10 @@ auto ClientOpt::parse(int argc, char* argv[]) -> ClientOpt::Options{
                     opt.verbous = true;
                     break;
 
+                case 'a':
+                    opt.aggregate = true;
+                    break;
+
                 case 'b':
                     opt.testmode = TestMode::ENABLE;
                     if (strcmp(optarg, "TD") == 0) {
@@ -741,6 +749,10 @@ auto ClientOpt::parse(int argc, char* argv[]) -> ClientOpt::Options{
                 fprintf(stderr,"[ERROR] Missing required key in streaming mode\n");
                 exit( EXIT_FAILURE );
             }
+            if (opt.aggregate && opt.streamign_type != StreamingType::TDMS){
+                fprintf(stderr,"[ERROR] Key --aggregate works only with --format=tdms\n");
+                exit( EXIT_FAILURE );
+            }
             return opt;
         }
     }
@@ -818,6 +830,8 @@ auto ClientOpt::parse(int argc, char* argv[]) -> ClientOpt::Options{
                         opt.streamign_type = StreamingType::TDMS;
                     } else if (strcmp(optarg, "wav") == 0) {
                         opt.streamign_type = StreamingType::WAV;
+                    } else if (strcmp(optarg, "bin") == 0) {
+                        opt.streamign_type = StreamingType::BIN;
                     } else {
                         fprintf(stderr, "Error key --format: %s\n", optarg);
                         opt.mode = Mode::ERROR_PARAM;
@@ -115,6 +115,7 @@ namespace ClientOpt {
         StreamingType streamign_type;
         SaveType      save_type;
         int           samples;
+        bool          aggregate; // All hosts into one file
         ////////////////////////
 
         Options(){
@@ -132,6 +133,7 @@ namespace ClientOpt {
             streamign_type = StreamingType::NONE;
             save_type = SaveType::NONE;
             samples = -1;
+            aggregate = false;
             dac_file = "";
             dac_repeat = (int)RepeatDAC::NONE;
             dac_memory = 1048576;
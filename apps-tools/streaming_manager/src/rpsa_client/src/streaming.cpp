@@ -9,6 +9,7 @@
 #include "config.h"
 #include "remote.h"
 #include "test_helper.h"
+#include "aggregator.h"
 
 //std::map<std::string,streaming_lib::CStreamingFile::Ptr> g_file_manager;
 std::map<std::string,converter_lib::CConverter::Ptr> g_converter;
@@ -26,6 +27,7 @@ std::atomic<int>   g_runClientCounter;
 std::map<std::string,bool>            g_terminate;
 
 std::vector<std::thread>              clients;
+CPackAggregator::Ptr                  g_aggregator;
 
 auto stopCSV () -> void;
 auto stopStreaming() -> void;
@@ -77,16 +79,28 @@ auto runClient(std::string  host,StateRunnedHosts state) -> void{
         protocol = net_lib::EProtocol::P_UDP;
 
     bool testMode = g_soption.testmode == ClientOpt::TestMode::ENABLE;
-    auto g_file_manager = streaming_lib::CStreamingFile::create(file_type, g_soption.save_dir, g_soption.samples , convert_v,testMode);
-    g_file_manager->run(host + "_" + g_filenameDate);
+    // In aggregate mode all hosts write into one file owned by the aggregator
+    auto g_s_aggregator = g_aggregator;
+    auto g_file_manager = g_s_aggregator ? g_s_aggregator->getFile() : streaming_lib::CStreamingFile::create(file_type, g_soption.save_dir, g_soption.samples , convert_v,testMode);
+    if (!g_s_aggregator)
+        g_file_manager->run(host + "_" + g_filenameDate);
     auto g_net_buffer = streaming_lib::CStreamingNetBuffer::create();
     g_net_buffer->outMemoryNotify.connect([host](uint64_t ram){
         if (g_soption.verbous)
             aprintf(stderr,"%s Out of memory (%d)\n", getTS(": ").c_str(),host.c_str(),ram);
     });
 
+    g_net_buffer->lostFramesNotify.connect([host](uint64_t count){
+        if (g_soption.verbous)
+            aprintf(stderr,"%s Lost frames %s (%d)\n", getTS(": ").c_str(),host.c_str(),count);
+    });
+
     auto g_s_file_w = std::weak_ptr<streaming_lib::CStreamingFile>(g_file_manager);
-    g_net_buffer->brokenPacksNotify.connect([g_s_file_w,host](uint64_t count){
+    g_net_buffer->brokenPacksNotify.connect([g_s_file_w,g_s_aggregator,host](uint64_t count){
+        if (g_s_aggregator){
+            g_s_aggregator->addNetWorkLost(host,count);
+            return;
+        }
         auto obj = g_s_file_w.lock();
         if(obj){
             obj->addNetWorkLost(count);
@@ -94,7 +108,7 @@ auto runClient(std::string  host,StateRunnedHosts state) -> void{
     });
 
 
-    g_net_buffer->receivedPackNotify.connect([g_s_file_w,host](DataLib::CDataBuffersPack::Ptr pack,uint64_t){
+    g_net_buffer->receivedPackNotify.connect([g_s_file_w,g_s_aggregator,host](DataLib::CDataBuffersPack::Ptr pack,uint64_t id){
         auto obj = g_s_file_w.lock();
         if (obj){
             if (g_soption.testmode == ClientOpt::TestMode::ENABLE || g_soption.verbous){
@@ -146,7 +160,12 @@ auto runClient(std::string  host,StateRunnedHosts state) -> void{
                 auto h = host;
                 addStatisticSteaming(h,sizeCh1 + sizeCh2,sempCh1,sempCh2,sempCh3,sempCh4,lostRate, net, flost,brokenBuffer);
             }
-          obj->passBuffers(pack);
+            if (g_s_aggregator){
+                if (!g_s_aggregator->push(host,pack,id) && g_soption.verbous)
+                    aprintf(stderr,"%s Aggregator queue is full %s\n", getTS(": ").c_str(),host.c_str());
+            }else{
+                obj->passBuffers(pack);
+            }
         }
     });
 
@@ -192,8 +211,12 @@ auto runClient(std::string  host,StateRunnedHosts state) -> void{
         }
     }
 
-    g_file_manager->stopAndFlush();
     g_asionet->stop();
+    if (g_s_aggregator){
+        g_s_aggregator->finish(host);
+        return;
+    }
+    g_file_manager->stopAndFlush();
     if (g_soption.streamign_type == ClientOpt::StreamingType::CSV && g_soption.testmode != ClientOpt::TestMode::ENABLE) {
         const std::lock_guard<std::mutex> lock(g_s_csv_mutex);
         auto fileName = g_file_manager->getCSVFileName();
@@ -239,6 +262,25 @@ auto startStreaming(std::shared_ptr<ClientNetConfigManager> cl,ClientOpt::Option
     runned_hosts.clear();
     remote_opt.remote_mode = ClientOpt::RemoteMode::START;
     if (startRemote(cl,remote_opt,&runned_hosts)){
+        std::vector<std::string> streamingHosts;
+        for(auto kv:runned_hosts){
+            if (kv.second == StateRunnedHosts::TCP || kv.second == StateRunnedHosts::UDP){
+                streamingHosts.push_back(kv.first);
+                g_terminate[kv.first] = false;
+            }
+        }
+
+        if (g_soption.aggregate){
+            if (g_soption.save_dir == "")
+                g_soption.save_dir = ".";
+            bool convert_v = g_soption.save_type == ClientOpt::SaveType::VOL;
+            bool testMode = g_soption.testmode == ClientOpt::TestMode::ENABLE;
+            auto file = streaming_lib::CStreamingFile::create(CStreamSettings::TDMS, g_soption.save_dir, g_soption.samples, convert_v, testMode);
+            file->run("multi_" + g_filenameDate);
+            g_aggregator = CPackAggregator::create(file,streamingHosts);
+            g_aggregator->start();
+        }
+
         for(auto kv:runned_hosts){
             if (kv.second == StateRunnedHosts::TCP || kv.second == StateRunnedHosts::UDP)
                 clients.push_back(std::thread(runClient, kv.first,kv.second));
@@ -294,6 +336,13 @@ auto startStreaming(std::shared_ptr<ClientNetConfigManager> cl,ClientOpt::Option
             }
         }
 
+        if (g_aggregator){
+            g_aggregator->stop();
+            g_aggregator->getFile()->stopAndFlush();
+            g_aggregator->printStatistic();
+            g_aggregator = nullptr;
+        }
+
 
         remote_opt.remote_mode = ClientOpt::RemoteMode::STOP;
         if (!startRemote(cl,remote_opt,&runned_hosts)){
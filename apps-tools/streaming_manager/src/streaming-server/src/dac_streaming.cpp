@@ -135,12 +135,17 @@ auto startDACServer(bool verbMode,bool testMode) -> void{
 			{
 				stopDACNonBlocking(status);
             });
+            g_dac_manger->notifyUnderrun.connect([](uint64_t count)
+			{
+				printWithLog(LOG_WARNING,stderr,"[Streaming] DAC file reader underrun: %llu\n",(unsigned long long)count);
+            });
 
 		}
 
         g_dac_app = std::make_shared<CDACStreamingApplication>(g_dac_manger, g_gen);
 		g_dac_app->setVerbousMode(g_dac_verbMode);
 		g_dac_app->setTestMode(testMode);
+		g_dac_app->setInterruptMode(settings.getDACInterrupt());
 
 		g_dac_app->runNonBlock();
 		if (g_dac_manger->isLocalMode()){
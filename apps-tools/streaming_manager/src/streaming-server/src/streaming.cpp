@@ -82,6 +82,9 @@ auto startServer(bool verbMode,bool testMode,bool is_master) -> void{
         auto ip_addr_host = std::string("127.0.0.1");
 		auto samples      = settings.getSamples();
 		auto save_mode    = settings.getType();
+		auto zero_copy    = settings.getZeroCopy() && use_file == CStreamSettings::NET;
+		auto direct_write = settings.getDirectWrite();
+		auto memory_limit = settings.getFileMemoryLimit();
 
 		auto use_calib    = settings.getCalibration();
 		auto attenuator   = settings.getAttenuator();
@@ -176,31 +179,50 @@ auto startServer(bool verbMode,bool testMode,bool is_master) -> void{
 
         g_s_buffer = streaming_lib::CStreamingBufferCached::create();
         auto g_s_buffer_w = std::weak_ptr<CStreamingBufferCached>(g_s_buffer);
+        CStreamingBufferCached::ConsumerId netConsumer = 0;
+        CStreamingBufferCached::ConsumerId fileConsumer = 0;
 
 		if (use_file == CStreamSettings::NET) {
             auto proto = protocol == CStreamSettings::TCP ? net_lib::EProtocol::P_TCP : net_lib::EProtocol::P_UDP;
             g_s_net = streaming_lib::CStreamingNet::create(ip_addr_host,sock_port,proto);
+            g_s_net->setHeaderVersion(g_serverNetConfig->getHeaderVersion());
+            if (!g_s_buffer->addConsumer(&netConsumer)){
+                throw std::runtime_error("Can't add the network consumer");
+            }
 
-            g_s_net->getBuffer = [g_s_buffer_w]() -> DataLib::CDataBuffersPack::Ptr{
+            g_s_net->getBuffer = [g_s_buffer_w,netConsumer]() -> DataLib::CDataBuffersPack::Ptr{
                 auto obj = g_s_buffer_w.lock();
                 if (obj) {
-                    return obj->readBuffer();
+                    return obj->readBuffer(netConsumer);
                 }
                 return nullptr;
             };
 
-            g_s_net->unlockBufferF = [g_s_buffer_w](){
+            g_s_net->unlockBufferF = [g_s_buffer_w,netConsumer](){
 				auto obj = g_s_buffer_w.lock();
 				if (obj){
-					obj->unlockBufferRead();
+					obj->unlockBufferRead(netConsumer);
 				}
 				return nullptr;
         	};
+
+            g_s_net->waitBufferF = [g_s_buffer_w,netConsumer]() -> CStreamingNet::EWaitResult{
+                auto obj = g_s_buffer_w.lock();
+                if (!obj || obj->isWaitToDestory()){
+                    return CStreamingNet::CLOSED;
+                }
+                return obj->waitBuffer(netConsumer) ? CStreamingNet::READY : CStreamingNet::TIMEOUT;
+            };
         }
 
         if (use_file == CStreamSettings::FILE) {
             auto f_path = std::string(FILE_PATH);
             g_s_file = streaming_lib::CStreamingFile::create(format,f_path,samples, save_mode == CStreamSettings::VOLT, testMode);
+            if (!g_s_buffer->addConsumer(&fileConsumer)){
+                throw std::runtime_error("Can't add the file consumer");
+            }
+            g_s_file->setDirectWrite(direct_write);
+            g_s_file->setMemoryLimit((uint64_t)memory_limit * 1024 * 1024);
             g_s_file->stopNotify.connect([](CStreamingFile::EStopReason r){
                 switch (r) {
                     case CStreamingFile::EStopReason::NORMAL:{
@@ -234,6 +256,7 @@ auto startServer(bool verbMode,bool testMode,bool is_master) -> void{
         g_s_buffer->generateBuffers();
         g_s_fpga->setVerbousMode(g_verbMode);
         g_s_fpga->setTestMode(testMode);
+        g_s_fpga->setZeroCopyMode(zero_copy);
 
         auto weak_obj = std::weak_ptr<CStreamingBufferCached>(g_s_buffer);
         g_s_fpga->getBuffF = [weak_obj](uint64_t lostFPGA) -> DataLib::CDataBuffersPack::Ptr {
@@ -252,15 +275,26 @@ auto startServer(bool verbMode,bool testMode,bool is_master) -> void{
             return nullptr;
         };
 
+        if (zero_copy){
+            // The pack is sent from the FPGA thread directly out of the DMA memory
+            auto g_s_net_w = std::weak_ptr<CStreamingNet>(g_s_net);
+            g_s_fpga->oscNotify.connect([g_s_net_w](DataLib::CDataBuffersPack::Ptr pack) {
+                auto n_obj = g_s_net_w.lock();
+                if (n_obj){
+                    n_obj->sendBuffers(pack);
+                }
+            });
+        }
+
         auto g_s_file_w = std::weak_ptr<CStreamingFile>(g_s_file);
-        g_s_fpga->oscNotify.connect([g_s_file_w,g_s_buffer_w](DataLib::CDataBuffersPack::Ptr) {
+        g_s_fpga->oscNotify.connect([g_s_file_w,g_s_buffer_w,fileConsumer](DataLib::CDataBuffersPack::Ptr) {
             auto f_obj = g_s_file_w.lock();
 			auto b_obj = g_s_buffer_w.lock();
             if (f_obj && b_obj){
-				auto p = b_obj->readBuffer();
+				auto p = b_obj->readBuffer(fileConsumer);
 				if (p){
                 	f_obj->passBuffers(p);
-					b_obj->unlockBufferRead();
+					b_obj->unlockBufferRead(fileConsumer);
 				}
             }
         });
@@ -273,7 +307,11 @@ auto startServer(bool verbMode,bool testMode,bool is_master) -> void{
     	std::string filenameDate = time_str;
 
         if (g_s_net){
-            g_s_net->run();
+            if (zero_copy){
+                g_s_net->runNonThread();
+            }else{
+                g_s_net->run();
+            }
 
             if (g_s_net->getProtocol() == net_lib::EProtocol::P_TCP){
                 g_serverNetConfig->sendServerStartedTCP();
@@ -310,7 +348,16 @@ auto stopNonBlocking(ServerNetConfigManager::EStopReason x) -> void{
 
 auto stopServer(ServerNetConfigManager::EStopReason reason) -> void{
 	try{
-        if (g_s_buffer) g_s_buffer->notifyToDestory();
+        if (g_s_buffer) {
+            g_s_buffer->notifyToDestory();
+            if (g_verbMode){
+                aprintf(stdout,"[Streaming] Ring size %d max occupancy %d overruns %lld\n",g_s_buffer->getRingSize(),g_s_buffer->getMaxOccupancy(),g_s_buffer->getOverruns());
+            }
+        }
+        if (g_s_net && g_verbMode){
+            aprintf(stdout,"[Streaming] Sent packs %lld syscalls per pack %.2f\n",g_s_net->getSentPacks(),g_s_net->getSyscallsPerPack());
+            aprintf(stdout,"[Streaming] DMA to send latency: %s",g_s_net->getLatencyHistogram().toString().c_str());
+        }
         g_s_net = nullptr;
         g_s_file = nullptr;
         g_s_buffer = nullptr;
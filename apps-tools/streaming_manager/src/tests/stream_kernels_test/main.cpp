@@ -0,0 +1,183 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "data_lib/stream_kernels.h"
+
+#define SAMPLES 1000000
+#define REPEATS 20
+
+// Reference loops, written out here so the test does not depend on the scalar code of the library
+
+template<typename T>
+auto refSplit(std::vector<std::vector<T>> &dst, const std::vector<T> &src, size_t channels, size_t samples) -> void{
+    for(size_t i = 0; i < samples; i++)
+        for(size_t ch = 0; ch < channels; ch++)
+            dst[ch][i] = src[i * channels + ch];
+}
+
+template<typename T>
+auto refPack(std::vector<T> &dst, const std::vector<std::vector<T>> &src, size_t channels, size_t samples) -> void{
+    for(size_t i = 0; i < samples; i++)
+        for(size_t ch = 0; ch < channels; ch++)
+            dst[i * channels + ch] = src[ch][i];
+}
+
+auto refNarrow(std::vector<int8_t> &dst, const std::vector<int16_t> &src, unsigned shift) -> void{
+    for(size_t i = 0; i < src.size(); i++){
+        int v = src[i] >> shift;
+        if (v > 127) v = 127;
+        if (v < -128) v = -128;
+        dst[i] = (int8_t)v;
+    }
+}
+
+auto refCalib(std::vector<int16_t> &dst, const std::vector<int16_t> &src, float gain, int32_t offset) -> void{
+    int64_t g = (int64_t)(gain * 16384.f + 0.5f);
+    for(size_t i = 0; i < src.size(); i++){
+        int64_t v = ((src[i] + offset) * g + 8192) >> 14;
+        if (v > 32767) v = 32767;
+        if (v < -32768) v = -32768;
+        dst[i] = (int16_t)v;
+    }
+}
+
+template<typename T>
+auto randomVector(size_t size) -> std::vector<T>{
+    std::vector<T> v(size);
+    for(auto &x : v)
+        x = (T)rand();
+    return v;
+}
+
+template<typename T>
+auto fillChannels(size_t channels, size_t samples) -> std::vector<std::vector<T>>{
+    std::vector<std::vector<T>> v;
+    for(size_t ch = 0; ch < channels; ch++)
+        v.push_back(randomVector<T>(samples));
+    return v;
+}
+
+template<typename T>
+auto testSplit(EVoltConvertPath path, size_t channels, size_t samples, double *rate) -> bool{
+    auto src = randomVector<T>(samples * channels);
+    std::vector<std::vector<T>> ref(channels,std::vector<T>(samples));
+    std::vector<std::vector<T>> dst(channels,std::vector<T>(samples));
+    refSplit(ref,src,channels,samples);
+    T *ptr[4] = {dst[0].data(), dst[1].data(), channels == 4 ? dst[2].data() : nullptr, channels == 4 ? dst[3].data() : nullptr};
+    auto begin = std::chrono::steady_clock::now();
+    for(int r = 0; r < (rate ? REPEATS : 1); r++){
+        if constexpr (sizeof(T) == 1){
+            if (channels == 2) split_2ch_8bit(ptr[0],ptr[1],src.data(),samples,path);
+            else split_4ch_8bit(ptr,src.data(),samples,path);
+        }else{
+            if (channels == 2) split_2ch_16bit(ptr[0],ptr[1],src.data(),samples,path);
+            else split_4ch_16bit(ptr,src.data(),samples,path);
+        }
+    }
+    if (rate)
+        *rate = (double)samples * channels * REPEATS / std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count() / 1e6;
+    return dst == ref;
+}
+
+template<typename T>
+auto testPack(EVoltConvertPath path, size_t channels, size_t samples, double *rate) -> bool{
+    auto src = fillChannels<T>(channels,samples);
+    std::vector<T> ref(samples * channels);
+    std::vector<T> dst(samples * channels);
+    refPack(ref,src,channels,samples);
+    const T *ptr[4] = {src[0].data(), src[1].data(), channels == 4 ? src[2].data() : nullptr, channels == 4 ? src[3].data() : nullptr};
+    auto begin = std::chrono::steady_clock::now();
+    for(int r = 0; r < (rate ? REPEATS : 1); r++){
+        if constexpr (sizeof(T) == 1){
+            if (channels == 2) pack_2ch_8bit(dst.data(),ptr[0],ptr[1],samples,path);
+            else pack_4ch_8bit(dst.data(),ptr,samples,path);
+        }else{
+            if (channels == 2) pack_2ch_16bit(dst.data(),ptr[0],ptr[1],samples,path);
+            else pack_4ch_16bit(dst.data(),ptr,samples,path);
+        }
+    }
+    if (rate)
+        *rate = (double)samples * channels * REPEATS / std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count() / 1e6;
+    return dst == ref;
+}
+
+auto testNarrow(EVoltConvertPath path, size_t samples, unsigned shift, double *rate) -> bool{
+    auto src = randomVector<int16_t>(samples);
+    std::vector<int8_t> ref(samples);
+    std::vector<int8_t> dst(samples);
+    refNarrow(ref,src,shift);
+    auto begin = std::chrono::steady_clock::now();
+    for(int r = 0; r < (rate ? REPEATS : 1); r++){
+        narrow_16_to_8bit(dst.data(),src.data(),samples,shift,path);
+    }
+    if (rate)
+        *rate = (double)samples * REPEATS / std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count() / 1e6;
+    return dst == ref;
+}
+
+auto testCalib(EVoltConvertPath path, size_t samples, float gain, int32_t offset, double *rate) -> bool{
+    auto src = randomVector<int16_t>(samples);
+    // Extremes to hit the saturation
+    if (samples >= 2){
+        src[0] = 32767;
+        src[1] = -32768;
+    }
+    std::vector<int16_t> ref(samples);
+    std::vector<int16_t> dst(samples);
+    refCalib(ref,src,gain,offset);
+    auto begin = std::chrono::steady_clock::now();
+    for(int r = 0; r < (rate ? REPEATS : 1); r++){
+        calib_16bit(dst.data(),src.data(),samples,gain,offset,path);
+    }
+    if (rate)
+        *rate = (double)samples * REPEATS / std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count() / 1e6;
+    return dst == ref;
+}
+
+auto report(const char *name, EVoltConvertPath path, bool ok, double rate) -> bool{
+    printf("%-12s %-6s %10.1f Msamples/s %s\n",name,convert_to_volt_path_name(path),rate,ok ? "OK" : "MISMATCH");
+    return ok;
+}
+
+int main(int, char**){
+    srand(0);
+    printf("Best path: %s\n",convert_to_volt_path_name(convert_to_volt_best_path()));
+
+    bool ok = true;
+    const EVoltConvertPath paths[] = {VCP_SCALAR, VCP_NEON, VCP_SSE2};
+    for(auto path : paths){
+        if (!convert_to_volt_path_supported(path))
+            continue;
+
+        // Small sizes run the scalar tails of the vector loops
+        bool tails = true;
+        for(size_t n = 0; n < 70; n++){
+            tails &= testSplit<int8_t>(path,2,n,nullptr) && testSplit<int8_t>(path,4,n,nullptr);
+            tails &= testSplit<int16_t>(path,2,n,nullptr) && testSplit<int16_t>(path,4,n,nullptr);
+            tails &= testPack<int8_t>(path,2,n,nullptr) && testPack<int8_t>(path,4,n,nullptr);
+            tails &= testPack<int16_t>(path,2,n,nullptr) && testPack<int16_t>(path,4,n,nullptr);
+            tails &= testNarrow(path,n,8,nullptr) && testNarrow(path,n,3,nullptr);
+            tails &= testCalib(path,n,1.0f,0,nullptr) && testCalib(path,n,1.37f,-120,nullptr);
+        }
+        ok &= report("tails",path,tails,0);
+
+        double rate = 0;
+        bool res;
+        res = testSplit<int8_t>(path,2,SAMPLES,&rate);   ok &= report("split2 8bit",path,res,rate);
+        res = testSplit<int8_t>(path,4,SAMPLES,&rate);   ok &= report("split4 8bit",path,res,rate);
+        res = testSplit<int16_t>(path,2,SAMPLES,&rate);  ok &= report("split2 16bit",path,res,rate);
+        res = testSplit<int16_t>(path,4,SAMPLES,&rate);  ok &= report("split4 16bit",path,res,rate);
+        res = testPack<int8_t>(path,2,SAMPLES,&rate);    ok &= report("pack2 8bit",path,res,rate);
+        res = testPack<int8_t>(path,4,SAMPLES,&rate);    ok &= report("pack4 8bit",path,res,rate);
+        res = testPack<int16_t>(path,2,SAMPLES,&rate);   ok &= report("pack2 16bit",path,res,rate);
+        res = testPack<int16_t>(path,4,SAMPLES,&rate);   ok &= report("pack4 16bit",path,res,rate);
+        res = testNarrow(path,SAMPLES,8,&rate);          ok &= report("narrow >>8",path,res,rate);
+        res = testNarrow(path,SAMPLES,2,&rate);          ok &= report("narrow >>2",path,res,rate);
+        res = testCalib(path,SAMPLES,0.98f,35,&rate);    ok &= report("calib",path,res,rate);
+        res = testCalib(path,SAMPLES,1.9f,-3000,&rate);  ok &= report("calib sat",path,res,rate);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,60 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "data_lib/volt_convert.h"
+
+#define SAMPLES 1000000
+#define REPEATS 50
+
+// Same gain as CStreamingFile::convertBuffers for 1:20 attenuator
+#define GAIN_8BIT  (20.0f / 128.0f)
+#define GAIN_16BIT (20.0f / 32768.0f)
+
+template<typename T,typename F>
+auto bench(const char *name,EVoltConvertPath path,std::vector<T> &src,std::vector<float> &ref,F func) -> bool{
+    std::vector<float> dst(src.size());
+    auto begin = std::chrono::steady_clock::now();
+    for(int i = 0; i < REPEATS; i++){
+        func(dst.data(),src.data(),src.size(),path);
+    }
+    auto end = std::chrono::steady_clock::now();
+    double sec = std::chrono::duration<double>(end - begin).count();
+    bool equal = memcmp(dst.data(),ref.data(),ref.size() * sizeof(float)) == 0;
+    printf("%-6s %-6s %10.1f Msamples/s %s\n",name,convert_to_volt_path_name(path),(double)src.size() * REPEATS / sec / 1e6,equal ? "OK" : "MISMATCH");
+    return equal;
+}
+
+int main(int, char**){
+    // Odd size to also run the scalar tail of the vector kernels
+    std::vector<int8_t>  src8(SAMPLES + 7);
+    std::vector<int16_t> src16(SAMPLES + 7);
+    srand(0);
+    for(size_t i = 0; i < src8.size(); i++){
+        src8[i] = (int8_t)rand();
+        src16[i] = (int16_t)rand();
+    }
+
+    std::vector<float> ref8(src8.size());
+    std::vector<float> ref16(src16.size());
+    convert_to_volt_8bit(ref8.data(),src8.data(),src8.size(),GAIN_8BIT,0,VCP_SCALAR);
+    convert_to_volt_16bit(ref16.data(),src16.data(),src16.size(),GAIN_16BIT,0,VCP_SCALAR);
+
+    printf("Best path: %s\n",convert_to_volt_path_name(convert_to_volt_best_path()));
+
+    bool ok = true;
+    const EVoltConvertPath paths[] = {VCP_SCALAR, VCP_NEON, VCP_SSE2, VCP_AVX2};
+    for(auto path : paths){
+        if (!convert_to_volt_path_supported(path))
+            continue;
+        ok &= bench("8bit",path,src8,ref8,[](float *d,const int8_t *s,size_t n,EVoltConvertPath p){
+            convert_to_volt_8bit(d,s,n,GAIN_8BIT,0,p);
+        });
+        ok &= bench("16bit",path,src16,ref16,[](float *d,const int16_t *s,size_t n,EVoltConvertPath p){
+            convert_to_volt_16bit(d,s,n,GAIN_16BIT,0,p);
+        });
+    }
+    return ok ? 0 : 1;
+}
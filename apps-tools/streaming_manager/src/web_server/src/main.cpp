@@ -660,6 +660,9 @@ void startServer(bool testMode) {
 		auto ip_addr_host = ss_ip_addr.Value();
 		auto samples      = settings.getSamples();
 		auto save_mode    = settings.getType();
+		auto zero_copy    = settings.getZeroCopy() && use_file == CStreamSettings::NET;
+		auto direct_write = settings.getDirectWrite();
+		auto memory_limit = settings.getFileMemoryLimit();
 
 		auto use_calib    = settings.getCalibration();
 		auto attenuator   = settings.getAttenuator();
@@ -746,31 +749,49 @@ void startServer(bool testMode) {
 
 		g_s_buffer = streaming_lib::CStreamingBufferCached::create();
 		auto g_s_buffer_w = std::weak_ptr<streaming_lib::CStreamingBufferCached>(g_s_buffer);
+		streaming_lib::CStreamingBufferCached::ConsumerId netConsumer = 0;
+		streaming_lib::CStreamingBufferCached::ConsumerId fileConsumer = 0;
         if (use_file == CStreamSettings::NET) {
             auto proto = protocol == CStreamSettings::TCP ? net_lib::EProtocol::P_TCP : net_lib::EProtocol::P_UDP;
             g_s_net = streaming_lib::CStreamingNet::create(ip_addr_host,sock_port,proto);
+            g_s_net->setHeaderVersion(g_serverNetConfig->getHeaderVersion());
+            if (!g_s_buffer->addConsumer(&netConsumer)){
+                throw std::runtime_error("Can't add the network consumer");
+            }
 
-
-            g_s_net->getBuffer = [g_s_buffer_w]() -> DataLib::CDataBuffersPack::Ptr{
+            g_s_net->getBuffer = [g_s_buffer_w,netConsumer]() -> DataLib::CDataBuffersPack::Ptr{
                 auto obj = g_s_buffer_w.lock();
                 if (obj) {
-                    return obj->readBuffer();
+                    return obj->readBuffer(netConsumer);
                 }
                 return nullptr;
             };
 
-			g_s_net->unlockBufferF = [g_s_buffer_w](){
+			g_s_net->unlockBufferF = [g_s_buffer_w,netConsumer](){
 				auto obj = g_s_buffer_w.lock();
 				if (obj){
-					obj->unlockBufferRead();
+					obj->unlockBufferRead(netConsumer);
 				}
 				return nullptr;
         	};
+
+            g_s_net->waitBufferF = [g_s_buffer_w,netConsumer]() -> streaming_lib::CStreamingNet::EWaitResult{
+                auto obj = g_s_buffer_w.lock();
+                if (!obj || obj->isWaitToDestory()){
+                    return streaming_lib::CStreamingNet::CLOSED;
+                }
+                return obj->waitBuffer(netConsumer) ? streaming_lib::CStreamingNet::READY : streaming_lib::CStreamingNet::TIMEOUT;
+            };
         }
 
         if (use_file == CStreamSettings::FILE) {
             auto f_path = std::string(FILE_PATH);
             g_s_file = streaming_lib::CStreamingFile::create(format,f_path,samples, save_mode == CStreamSettings::VOLT, testMode);
+            if (!g_s_buffer->addConsumer(&fileConsumer)){
+                throw std::runtime_error("Can't add the file consumer");
+            }
+            g_s_file->setDirectWrite(direct_write);
+            g_s_file->setMemoryLimit((uint64_t)memory_limit * 1024 * 1024);
             g_s_file->stopNotify.connect([](streaming_lib::CStreamingFile::EStopReason r){
                 switch (r) {
                     case streaming_lib::CStreamingFile::EStopReason::NORMAL:{
@@ -805,6 +826,7 @@ void startServer(bool testMode) {
 
 		g_s_buffer->generateBuffers();
         g_s_fpga->setTestMode(testMode);
+        g_s_fpga->setZeroCopyMode(zero_copy);
 
 		auto weak_obj = std::weak_ptr<streaming_lib::CStreamingBufferCached>(g_s_buffer);
         g_s_fpga->getBuffF = [weak_obj](uint64_t lostFPGA) -> DataLib::CDataBuffersPack::Ptr {
@@ -825,15 +847,25 @@ void startServer(bool testMode) {
 
         auto g_s_file_w = std::weak_ptr<streaming_lib::CStreamingFile>(g_s_file);
 		auto g_s_net_w = std::weak_ptr<streaming_lib::CStreamingNet>(g_s_net);
-        g_s_fpga->oscNotify.connect([g_s_net_w,g_s_file_w,rate,g_s_buffer_w](DataLib::CDataBuffersPack::Ptr pack) {
+        if (zero_copy){
+            // The pack is sent from the FPGA thread directly out of the DMA memory
+            g_s_fpga->oscNotify.connect([g_s_net_w](DataLib::CDataBuffersPack::Ptr pack) {
+                auto n_obj = g_s_net_w.lock();
+                if (n_obj){
+                    n_obj->sendBuffers(pack);
+                }
+            });
+        }
+
+        g_s_fpga->oscNotify.connect([g_s_net_w,g_s_file_w,rate,g_s_buffer_w,fileConsumer](DataLib::CDataBuffersPack::Ptr pack) {
 
 			auto f_obj = g_s_file_w.lock();
 			auto b_obj = g_s_buffer_w.lock();
             if (f_obj && b_obj){
-				auto p = b_obj->readBuffer();
+				auto p = b_obj->readBuffer(fileConsumer);
 				if (p){
                 	f_obj->passBuffers(p);
-					b_obj->unlockBufferRead();
+					b_obj->unlockBufferRead(fileConsumer);
 				}
             }
         });
@@ -846,7 +878,11 @@ void startServer(bool testMode) {
         std::string filenameDate = time_str;
 
         if (g_s_net){
-            g_s_net->run();
+            if (zero_copy){
+                g_s_net->runNonThread();
+            }else{
+                g_s_net->run();
+            }
 			usleep(1000);
             if (g_s_net->getProtocol() == net_lib::EProtocol::P_TCP){
                 g_serverNetConfig->sendServerStartedTCP();
@@ -1008,11 +1044,16 @@ auto startDACServer(bool testMode) -> void{
             {
                 stopDACNonBlocking(status);
             });
+            g_dac_manger->notifyUnderrun.connect([](uint64_t count)
+            {
+                WARNING("DAC file reader underrun: %llu",(unsigned long long)count);
+            });
 
         }
 
         g_dac_app = std::make_shared<dac_streaming_lib::CDACStreamingApplication>(g_dac_manger, g_gen);
         g_dac_app->setTestMode(testMode);
+        g_dac_app->setInterruptMode(settings.getDACInterrupt());
 
         g_dac_app->runNonBlock();
         if (g_dac_manger->isLocalMode()){
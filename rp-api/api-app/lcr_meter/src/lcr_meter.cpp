@@ -37,6 +37,9 @@
 #include "utils.h"
 #include "math/rp_algorithms.h"
 
+// Longest single wait for the acquisition
+#define LCR_WAIT_SLICE_US 10000
+
 CLCRHardware    g_lcr_hw;
 CLCRGenerator   g_generator;
 
@@ -235,8 +238,8 @@ void lcr_MainThread(){
 /* Acquire functions. Callback to the API structure */
 int lcr_ThreadAcqData(buffers_t *data, int *dec, float *freq)
 {
-    rp_acq_trig_state_t state;
     uint32_t pos;
+    bool     triggered = false;
     bool     fillState = false;
     *freq = g_generator.getFreq();
     lcr_getDecimationValue(*freq, dec,g_adc_rate);
@@ -247,16 +250,12 @@ int lcr_ThreadAcqData(buffers_t *data, int *dec, float *freq)
     ECHECK(rp_AcqStart());
     ECHECK(rp_AcqSetTriggerSrc(RP_TRIG_SRC_NOW));
 
-    state = RP_TRIG_STATE_TRIGGERED;
-    while(true){
-        rp_AcqGetTriggerState(&state);
-        if(state == RP_TRIG_STATE_TRIGGERED){
-            break;
-        }
+    while(!triggered){
+        ECHECK(rp_AcqWaitTriggered(LCR_WAIT_SLICE_US, &triggered));
     }
 
     while(!fillState){
-        ECHECK(rp_AcqGetBufferFillState(&fillState));
+        ECHECK(rp_AcqWaitBufferFull(LCR_WAIT_SLICE_US, &fillState));
     }
 
     ECHECK(rp_AcqStop());
@@ -38,6 +38,9 @@ static auto adc_channels = rpApp_BaGetADCChannels();
 
 typedef double data_t;
 
+// Longest single wait for the acquisition
+#define BA_WAIT_SLICE_US 10000
+
 #define EXEC_CHECK_MUTEX(x, mutex){ \
  		int retval = (x); \
  		if(retval != RP_OK) { \
@@ -623,7 +626,7 @@ int rpApp_BaSafeThreadAcqData(rp_ba_buffer_t &_buffer, int _decimation, int _acq
 	sleep_time = sleep_time < 1 ? 1 : sleep_time;
 	bool fillState = false;
 
-	rp_acq_trig_state_t trig_state = RP_TRIG_STATE_TRIGGERED;
+	bool triggered = false;
 
 	pthread_mutex_lock(&mutex);
 	EXEC_CHECK_MUTEX(rp_AcqSetDecimationFactor(_decimation), mutex);
@@ -634,18 +637,12 @@ int rpApp_BaSafeThreadAcqData(rp_ba_buffer_t &_buffer, int _decimation, int _acq
 	// Trigger, it is needed for the RP_DEC_1 decimation
 	EXEC_CHECK_MUTEX(rp_AcqSetTriggerSrc(RP_TRIG_SRC_NOW), mutex);
 
-	for (;;) {
-		EXEC_CHECK_MUTEX(rp_AcqGetTriggerState(&trig_state), mutex);
-
-		if (trig_state == RP_TRIG_STATE_TRIGGERED) {
-			break;
-		} else {
-			usleep(1);
-		}
+	while(!triggered){
+		EXEC_CHECK_MUTEX(rp_AcqWaitTriggered(BA_WAIT_SLICE_US, &triggered), mutex);
 	}
 
 	while(!fillState){
-		EXEC_CHECK_MUTEX(rp_AcqGetBufferFillState(&fillState), mutex);
+		EXEC_CHECK_MUTEX(rp_AcqWaitBufferFull(BA_WAIT_SLICE_US, &fillState), mutex);
 	}
 
 	EXEC_CHECK_MUTEX(rp_AcqStop(), mutex); // Why the write pointer is not stopped?
@@ -23,6 +23,7 @@
 #include <inttypes.h>
 #include <mutex>
 #include <thread>
+#include <atomic>
 
 #include "osciloscopeApp.h"
 #include "common.h"
@@ -35,8 +36,11 @@
 #include "osciloscope_logic/adc_controller.h"
 
 #define FLOAT_EPS 0.00001f
+// Longest single wait for the trigger, so a reset request is handled quickly
+#define WAIT_SLICE_MS 10.0
 
 std::atomic_bool g_threadRun = false;
+std::atomic<void (*)(void)> g_viewReadyCallback(nullptr);
 
 volatile double ch_ampOffset[MAX_ADC_CHANNELS], math_ampOffset;
 volatile double ch_ampScale[MAX_ADC_CHANNELS],  math_ampScale = 1;
@@ -782,6 +786,11 @@ int osc_refreshViewData(){
     return RP_OK;
 }
 
+int osc_setViewReadyCallback(void (*callback)(void)){
+    g_viewReadyCallback = callback;
+    return RP_OK;
+}
+
 
 
 /*
@@ -1006,8 +1015,7 @@ int waitToFillPreTriggerBuffer(float _timescale) {
 
 
 int waitTrigger(float _timescale,bool _disableTimeout,bool *_isresetted,bool *_exitByTimeout) {
-    auto trig_state = RP_TRIG_STATE_WAITING;
-    auto timeout_state = false;
+    bool triggered = false;
     // Max timeout 1 second
     auto timeOut  = MIN(g_viewController.calculateTimeOut(_timescale),1000.0);
     timeOut += g_viewController.getClock();
@@ -1017,16 +1025,23 @@ int waitTrigger(float _timescale,bool _disableTimeout,bool *_isresetted,bool *_e
     *_exitByTimeout = false;
 
     g_viewController.setTriggerState(false);
-    do {
+    while(true) {
         if (g_adcController.isNeedResetWaitTrigger()){
             *_isresetted = true;
             break;
         }
-        timeout_state = _disableTimeout ? true : timeOut > g_viewController.getClock();
-        ECHECK_APP(rp_AcqGetTriggerState(&trig_state));
-    } while ((trig_state != RP_TRIG_STATE_TRIGGERED) && timeout_state);
-    g_viewController.setTriggerState(trig_state == RP_TRIG_STATE_TRIGGERED);
-    *_exitByTimeout = (!timeout_state) && (trig_state != RP_TRIG_STATE_TRIGGERED);
+        auto now = g_viewController.getClock();
+        if (!_disableTimeout && timeOut <= now){
+            break;
+        }
+        auto waitMs = _disableTimeout ? WAIT_SLICE_MS : MIN(timeOut - now, WAIT_SLICE_MS);
+        ECHECK_APP(rp_AcqWaitTriggered((uint32_t)(waitMs * 1000.0), &triggered));
+        if (triggered){
+            break;
+        }
+    }
+    g_viewController.setTriggerState(triggered);
+    *_exitByTimeout = !(*_isresetted) && !triggered;
     return RP_OK;
 }
 
@@ -1042,9 +1057,9 @@ int waitToFillAfterTriggerBuffer(float _timescale) {
     auto timeOut  = MIN(g_viewController.calculateTimeOut(_timescale),1000.0);
     timeOut += g_viewController.getClock();
     bool bufferIsFill = false;
-    do {
-        ECHECK_APP(rp_AcqGetBufferFillState(&bufferIsFill));
-    } while (!bufferIsFill && timeOut > g_viewController.getClock());
+    // Check at least once, the buffer may already be full
+    auto waitMs = MAX(timeOut - g_viewController.getClock(), 0.0);
+    ECHECK_APP(rp_AcqWaitBufferFull((uint32_t)(waitMs * 1000.0), &bufferIsFill));
     return RP_OK;
 }
 
@@ -1384,6 +1399,10 @@ void mainThreadFun() {
             g_mutex.unlock();
             g_viewController.updateViewDone();
             checkAutoscale(true);
+            auto callback = g_viewReadyCallback.load();
+            if (callback){
+                callback();
+            }
         }
     }
 }
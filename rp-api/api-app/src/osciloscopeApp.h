@@ -98,6 +98,7 @@ int osc_getViewSize(uint32_t *size);
 int osc_getViewLimits(uint32_t* start, uint32_t* end);
 int osc_scaleMath();
 int osc_refreshViewData();
+int osc_setViewReadyCallback(void (*callback)(void));
 
 
 int osc_SetSmoothMode(rp_channel_t _channel, rpApp_osc_interpolationMode _mode);
@@ -112,6 +112,10 @@ int rpApp_OscRefreshViewData() {
     return osc_refreshViewData();
 }
 
+int rpApp_OscSetViewReadyCallback(void (*callback)(void)) {
+    return osc_setViewReadyCallback(callback);
+}
+
 int rpApp_OscIsRunning(bool *running) {
     return osc_isRunning(running);
 }
@@ -639,6 +639,14 @@ int rpApp_OscScaleMath();
 */
 int rpApp_OscRefreshViewData();
 
+/**
+* Sets a function that is called from the oscilloscope thread every time new view data is ready.
+* The function must be short, it blocks the acquisition. NULL removes the callback.
+* @param callback Function to call.
+* @return If the function is successful, the return value is RP_OK.
+*/
+int rpApp_OscSetViewReadyCallback(void (*callback)(void));
+
 int rpApp_OscSetSmoothMode(rp_channel_t _channel, rpApp_osc_interpolationMode _mode);
 
 int rpApp_OscGetSmoothMode(rp_channel_t _channel, rpApp_osc_interpolationMode *_mode);
@@ -52,6 +52,8 @@ typedef struct rp_spectr_worker_res_s {
 /* Output signals */
 // 0 - Xaxis; 1 - Ch 1; 2 - Ch 2; 3 - Ch 3; 4 - Ch 4
 #define SPECTR_OUT_SIG_NUM   (MAX_ADC_CHANNELS + 1)
+// Longest single wait for the acquisition, so state changes are handled quickly
+#define SPECTR_WAIT_SLICE_US 10000
 
 int rp_spectr_get_signals_channel(float **signals, size_t size);
 int rp_spectr_get_params(rp_spectr_worker_res_t *result);
@@ -305,10 +307,10 @@ void *rp_spectr_worker_thread(void *args)
 
         // /* start working */
 
-        rp_acq_trig_state_t stateTrig = RP_TRIG_STATE_WAITING;
-        /* polling until data is ready */
+        bool triggered = false;
+        /* waiting until data is ready */
         while(1) {
-            /* change in state, abort polling */
+            /* change in state, abort waiting */
             if((rp_spectr_ctrl != old_state)) {
                 break;
             }
@@ -317,17 +319,17 @@ void *rp_spectr_worker_thread(void *args)
                 return 0;
             }
 
-            if (rp_AcqGetTriggerState(&stateTrig)){
+            if (rp_AcqWaitTriggered(SPECTR_WAIT_SLICE_US, &triggered)){
                 return 0;
             }
 
-            if(stateTrig == RP_TRIG_STATE_TRIGGERED){
+            if(triggered){
                 break;
             }
         }
         bool fillState = false;
         while(!fillState){
-            rp_AcqGetBufferFillState(&fillState);
+            rp_AcqWaitBufferFull(SPECTR_WAIT_SLICE_US, &fillState);
             if((rp_spectr_ctrl != old_state)) {
                 break;
             }
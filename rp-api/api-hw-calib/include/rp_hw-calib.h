@@ -191,6 +191,14 @@ rp_calib_error rp_CalibInitSpecific(rp_HPeModels_t model);
  */
 rp_calib_params_t rp_GetCalibrationSettings();
 
+/**
+ * Returns the version of the calibration settings in memory.
+ * The version changes every time the settings are loaded, reset or set.
+ * Allows to cache values derived from the calibration and to detect when they are outdated.
+ * @return Calibration settings version
+ */
+uint32_t rp_CalibGetVersion();
+
 /**
 * Returns default calibration settings.
 * These calibration settings are populated only once from EEPROM at rp_Init().
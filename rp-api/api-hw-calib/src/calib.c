@@ -23,9 +23,12 @@
 static rp_calib_params_t g_calib;
 static bool g_model_loaded = false;
 static rp_HPeModels_t g_model = STEM_125_10_v1_0;
+static uint32_t g_calib_version = 0;
 
 rp_calib_error calib_InitModel(rp_HPeModels_t model,bool use_factory_zone, bool adjust){
-    return calib_InitModelEx(model, use_factory_zone, &g_calib,adjust);
+    rp_calib_error ret = calib_InitModelEx(model, use_factory_zone, &g_calib,adjust);
+    g_calib_version++;
+    return ret;
 }
 
 rp_calib_error calib_InitModelEx(rp_HPeModels_t model,bool use_factory_zone,rp_calib_params_t *calib,bool adjust){
@@ -328,6 +331,11 @@ rp_calib_params_t calib_GetParams()
     return g_calib;
 }
 
+uint32_t calib_GetVersion()
+{
+    return g_calib_version;
+}
+
 rp_calib_params_t calib_GetDefaultCalib(){
     if (!g_model_loaded){
         rp_HPeModels_t model = STEM_125_14_v1_1; // Default model
@@ -372,6 +380,7 @@ void calib_SetToZero(bool is_new_format) {
         g_calib = calib_GetUniversalDefaultCalib();
     else
         g_calib = calib_GetDefaultCalib();
+    g_calib_version++;
 }
 
 rp_calib_error calib_Reset(bool use_factory_zone,bool is_new_format) {
@@ -381,6 +390,7 @@ rp_calib_error calib_Reset(bool use_factory_zone,bool is_new_format) {
         int res = calib_WriteParams(g_model,&g_calib,use_factory_zone,false);
         if (res != RP_HW_CALIB_OK){
             g_calib = calib;
+            g_calib_version++;
             return res;
         }
         return calib_Init(use_factory_zone);
@@ -419,6 +429,7 @@ rp_calib_error calib_LoadFromFactoryZone(bool convert_to_new){
 
 rp_calib_error calib_SetParams(rp_calib_params_t *calib_params){
     g_calib = *calib_params;
+    g_calib_version++;
     //calib_PrintEx(stderr,&g_calib);
     return RP_HW_CALIB_OK;
 }
@@ -25,6 +25,7 @@ rp_calib_error calib_InitModel(rp_HPeModels_t model,bool use_factory_zone,bool a
 rp_calib_error calib_InitModelEx(rp_HPeModels_t model,bool use_factory_zone,rp_calib_params_t *calib,bool adjust);
 
 rp_calib_params_t calib_GetParams();
+uint32_t calib_GetVersion();
 rp_calib_params_t calib_GetDefaultCalib();
 rp_calib_params_t calib_GetUniversalDefaultCalib();
 
@@ -32,6 +32,10 @@ rp_calib_params_t rp_GetCalibrationSettings(){
     return calib_GetParams();
 }
 
+uint32_t rp_CalibGetVersion(){
+    return calib_GetVersion();
+}
+
 rp_calib_params_t rp_GetDefaultCalibrationSettings(){
     return calib_GetDefaultCalib();
 }
@@ -48,6 +48,17 @@ int rp_AcqGetArmKeep(bool* state);
  */
 int rp_AcqGetBufferFillState(bool* state);
 
+/**
+ * Waits until the ADC buffer is full of data after the trigger, at most timeout_us.
+ * The thread sleeps while waiting. It is woken up by the FPGA interrupt where the FPGA provides one,
+ * otherwise the state is checked with a step derived from the decimation and the trigger delay.
+ * @param timeout_us Maximum wait time in microseconds
+ * @param state Returns true if the buffer is full, false on timeout
+ * @return If the function is successful, the return value is RP_OK.
+ * If the function is unsuccessful, the return value is any of RP_E* values that indicate an error.
+ */
+int rp_AcqWaitBufferFull(uint32_t timeout_us, bool* state);
+
 /**
  * Sets the decimation used at acquiring signal. There is only a set of pre-defined decimation
  * values which can be specified. See the #rp_acq_decimation_t enum values.
@@ -152,6 +163,17 @@ int rp_AcqGetTriggerSrc(rp_acq_trig_src_t* source);
  */
 int rp_AcqGetTriggerState(rp_acq_trig_state_t* state);
 
+/**
+ * Waits until the trigger happened, at most timeout_us.
+ * The thread sleeps while waiting. It is woken up by the FPGA interrupt where the FPGA provides one,
+ * otherwise the state is checked with a step derived from the decimation.
+ * @param timeout_us Maximum wait time in microseconds
+ * @param state Returns true if the trigger happened, false on timeout
+ * @return If the function is successful, the return value is RP_OK.
+ * If the function is unsuccessful, the return value is any of RP_E* values that indicate an error.
+ */
+int rp_AcqWaitTriggered(uint32_t timeout_us, bool* state);
+
 /**
  * Sets the number of decimated data after trigger written into memory.
  * @param decimated_data_num Number of decimated data. It must not be higher than the ADC buffer size.
@@ -472,6 +472,27 @@ int rp_GenTriggerOnly(rp_channel_t channel);
 */
 int rp_GenResetChannelSM(rp_channel_t channel);
 
+/**
+* Starts a configuration transaction on the channel. Until the matching rp_GenConfigCommit,
+* setters only store the new parameters and the signal table is neither synthesized nor
+* written to the FPGA. Amplitude, offset and other register settings still apply at once.
+* Transactions can be nested, the signal is updated by the outermost commit.
+* @param channel Channel A or B
+* @return If the function is successful, the return value is RP_OK.
+* If the function is unsuccessful, the return value is any of RP_E* values that indicate an error.
+*/
+int rp_GenConfigBegin(rp_channel_t channel);
+
+/**
+* Ends a configuration transaction started by rp_GenConfigBegin. If a setter changed the signal
+* during the transaction, the signal is synthesized and written to the FPGA once.
+* @param channel Channel A or B
+* @return If the function is successful, the return value is RP_OK.
+* If the function is unsuccessful, the return value is any of RP_E* values that indicate an error.
+* RP_EIPV is returned if no transaction was started.
+*/
+int rp_GenConfigCommit(rp_channel_t channel);
+
 /**
 * Sets the DAC protection mode from overheating. Only works with Redpitaya 250-12 otherwise returns RP_NOTS
 * @param channel Channel A or B for witch we want to set protection.
@@ -18,6 +18,12 @@
 #include <math.h>
 #include <string.h>
 #include <assert.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
 
 #include "common.h"
 #include "oscilloscope.h"
@@ -58,6 +64,120 @@ rp_acq_trig_src_t last_trig_src = RP_TRIG_SRC_DISABLED;
 float ch_hyst[4] = {0.005,0.005,0.005,0.005};
 float ch_trash[4] = {0.005,0.005,0.005,0.005};
 
+/*
+ * Acquisition context.
+ *
+ * Snapshot of the values the readout needs: bits, sign and full scale of the
+ * ADC plus gain, AC/DC mode, probe gain and calibration of every channel.
+ * It is rebuilt only after the gain or AC/DC mode was set or when the
+ * calibration version changes. Readouts work on a copy, so one readout never
+ * mixes values from before and after a change.
+ */
+
+typedef struct {
+    int                 status;
+    rp_pinState_t       gain;
+    rp_acq_ac_dc_mode_t power_mode;
+    float               gainValue;
+    uint_gain_calib_t   calib;
+} acq_channel_context_t;
+
+typedef struct {
+    int                   status;
+    uint32_t              version;
+    uint32_t              calib_version;
+    uint8_t               channels;
+    uint8_t               bits;
+    bool                  is_sign;
+    float                 fullScale;
+    acq_channel_context_t ch[4];
+} acq_context_t;
+
+static pthread_mutex_t acq_context_mutex = PTHREAD_MUTEX_INITIALIZER;
+static acq_context_t acq_context;
+static bool acq_context_valid = false;
+
+static void acq_InvalidateContext(){
+    pthread_mutex_lock(&acq_context_mutex);
+    acq_context_valid = false;
+    pthread_mutex_unlock(&acq_context_mutex);
+}
+
+static void acq_BuildContext(acq_context_t *ctx){
+    ctx->version++;
+    ctx->calib_version = rp_CalibGetVersion();
+    ctx->status = RP_OK;
+
+    if (rp_HPGetFastADCChannelsCount(&ctx->channels) != RP_HP_OK
+        || rp_HPGetFastADCBits(&ctx->bits) != RP_HP_OK
+        || rp_HPGetFastADCIsSigned(&ctx->is_sign) != RP_HP_OK
+        || rp_HPGetHWADCFullScale(&ctx->fullScale) != RP_HP_OK){
+        ERROR("Can't get fast ADC parameters");
+        ctx->status = RP_EOOR;
+        return;
+    }
+
+    for (uint8_t i = 0; i < ctx->channels && i < 4; i++){
+        rp_channel_t channel = (rp_channel_t)i;
+        acq_channel_context_t *ch = &ctx->ch[i];
+        ch->status = RP_EOOR;
+        ch->gain = gain_ch[i];
+        ch->power_mode = power_mode_ch[i];
+
+        if (acq_GetGainV(channel, &ch->gainValue) != RP_OK){
+            continue;
+        }
+
+        int ret = RP_HW_CALIB_OK;
+        switch (ch->gain)
+        {
+            case RP_LOW:
+                ret = rp_CalibGetFastADCCalibValueI(convertCh(channel),convertPower(ch->power_mode),&ch->calib);
+                break;
+
+            case RP_HIGH:
+                ret = rp_CalibGetFastADCCalibValue_1_20I(convertCh(channel),convertPower(ch->power_mode),&ch->calib);
+                break;
+
+            default:
+                ERROR("Unknown mode: %d",ch->gain);
+                continue;
+        }
+
+        if (ret != RP_HW_CALIB_OK){
+            ERROR("Get calibaration: %d",ret);
+            continue;
+        }
+        ch->status = RP_OK;
+    }
+}
+
+static void acq_GetContext(acq_context_t *ctx){
+    pthread_mutex_lock(&acq_context_mutex);
+    if (!acq_context_valid || acq_context.calib_version != rp_CalibGetVersion()){
+        acq_BuildContext(&acq_context);
+        acq_context_valid = true;
+    }
+    *ctx = acq_context;
+    pthread_mutex_unlock(&acq_context_mutex);
+}
+
+static int acq_CheckContextChannel(const acq_context_t *ctx, rp_channel_t channel){
+    if (ctx->status != RP_OK){
+        return ctx->status;
+    }
+    if (channel >= ctx->channels || channel > RP_CH_4){
+        ERROR("Channel is larger than allowed");
+        return RP_NOTS;
+    }
+    return ctx->ch[channel].status;
+}
+
+static int acq_GetChannelContext(rp_channel_t channel, acq_context_t *ctx){
+    acq_GetContext(ctx);
+    return acq_CheckContextChannel(ctx, channel);
+}
+
 /*----------------------------------------------------------------------------*/
 /**
  * @brief Converts time in [ns] to ADC samples
@@ -259,6 +379,7 @@ int acq_SetGain(rp_channel_t channel, rp_pinState_t state){
     else {
         status = setEqFilters(channel);
     }
+    acq_InvalidateContext();
     return status;
 }
 
@@ -483,6 +604,86 @@ int acq_GetTriggerState(rp_acq_trig_state_t* state){
     return RP_OK;
 }
 
+/*
+ * The wait functions check the state, then sleep and check again. The sleep
+ * ends early on the interrupt of the UIO device, if the FPGA has one. Without
+ * the interrupt the first sleep step is derived from the time the FPGA needs
+ * for the samples at the current decimation and doubles up to
+ * ACQ_WAIT_MAX_STEP_US, so slow triggers do not keep a core busy.
+ */
+
+#define ACQ_WAIT_MIN_STEP_US 10
+#define ACQ_WAIT_MAX_STEP_US 5000
+
+static uint64_t acq_GetTimeUs(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Time in us to write the given number of decimated samples */
+static uint32_t acq_SamplesToUs(uint32_t samples){
+    uint32_t decimation = 1;
+    double sp = 0;
+    if (acq_GetDecimationFactor(&decimation) != RP_OK || acq_GetADCSamplePeriod(&sp) != RP_OK){
+        return ACQ_WAIT_MIN_STEP_US;
+    }
+    double us = (double)samples * decimation * sp / 1000.0;
+    return us > ACQ_WAIT_MAX_STEP_US ? ACQ_WAIT_MAX_STEP_US : (uint32_t)us;
+}
+
+static int acq_CheckTriggered(bool *state){
+    return osc_GetTriggerState(state);
+}
+
+static int acq_CheckBufferFull(bool *state){
+    return osc_GetBufferFillState(state);
+}
+
+static int acq_WaitState(int (*check)(bool*), uint32_t step_us, uint32_t timeout_us, bool *state){
+    uint64_t start = acq_GetTimeUs();
+    bool use_irq = true;
+    bool interrupted = false;
+    step_us = MAX(step_us, ACQ_WAIT_MIN_STEP_US);
+
+    while (true) {
+        int ret = check(state);
+        if (ret != RP_OK || *state) {
+            return ret;
+        }
+
+        // Woken up by an interrupt of something else, sleep for the rest of the wait
+        if (interrupted) {
+            use_irq = false;
+        }
+
+        uint64_t elapsed = acq_GetTimeUs() - start;
+        if (elapsed >= timeout_us) {
+            return RP_OK;
+        }
+
+        uint32_t wait_us = MIN(step_us, (uint32_t)(timeout_us - elapsed));
+        if (!use_irq || cmn_WaitInterrupt(wait_us, &interrupted) != RP_OK) {
+            use_irq = false;
+            interrupted = false;
+            usleep(wait_us);
+        }
+        step_us = MIN(step_us * 2, ACQ_WAIT_MAX_STEP_US);
+    }
+}
+
+int acq_WaitTriggered(uint32_t timeout_us, bool* state){
+    // A fraction of the buffer, the trigger is not accepted before the pre-trigger part is written
+    return acq_WaitState(acq_CheckTriggered, acq_SamplesToUs(ADC_BUFFER_SIZE / 16), timeout_us, state);
+}
+
+int acq_WaitBufferFull(uint32_t timeout_us, bool* state){
+    uint32_t delay = 0;
+    osc_GetTriggerDelay(&delay);
+    // After the trigger the FPGA still writes trigger delay samples
+    return acq_WaitState(acq_CheckBufferFull, acq_SamplesToUs(delay / 4), timeout_us, state);
+}
+
 int acq_SetTriggerDelay(int32_t decimated_data_num){
     int32_t trig_dly;
     if(decimated_data_num < -TRIG_DELAY_ZERO_OFFSET){
@@ -1029,136 +1230,231 @@ uint32_t acq_GetNormalizedDataPos(uint32_t pos){
     return (pos % ADC_BUFFER_SIZE);
 }
 
-int acq_GetDataRaw(rp_channel_t channel, uint32_t pos, uint32_t* size, int16_t* buffer,bool use_calib){
+/*
+ * Bulk readout of the ADC ring buffer.
+ *
+ * The read window is split into at most two contiguous spans (up to the end
+ * of the ring and from its beginning), so the inner loops have no modulo.
+ * The calibration is folded per channel into one gain and offset for the volt
+ * outputs, and all requested outputs are filled in one pass over the data.
+ */
 
-    CHECK_CHANNEL
+#define ACQ_CONV_BLOCK 256
+
+typedef struct {
+    bool     is_sign;
+    uint8_t  bits;
+    uint32_t mask;
+    /* Integer calibration of the raw output */
+    uint32_t raw_gain;
+    uint32_t raw_base;
+    int32_t  raw_offset;
+    /* log2(raw_base) or -1 if the base is not a power of two */
+    int32_t  raw_shift;
+    /* volt = cnts * volt_gain + volt_offset, limited by volt_min and volt_max */
+    float    volt_gain;
+    float    volt_offset;
+    float    volt_min;
+    float    volt_max;
+} acq_conv_t;
+
+static void acq_InitConv(acq_conv_t *conv, uint8_t bits, bool is_sign, const uint_gain_calib_t *raw_calib, const uint_gain_calib_t *volt_calib, float fullScale, float gainValue){
+    conv->is_sign = is_sign;
+    conv->bits = bits;
+    conv->mask = ((uint64_t)1 << bits) - 1;
+
+    conv->raw_gain = raw_calib->gain;
+    conv->raw_base = raw_calib->base;
+    conv->raw_offset = raw_calib->offset;
+    conv->raw_shift = -1;
+    for (int32_t i = 0; i < 32; i++) {
+        if (raw_calib->base == ((uint32_t)1 << i)) {
+            conv->raw_shift = i;
+            break;
+        }
+    }
 
-    *size = MIN(*size, ADC_BUFFER_SIZE);
+    float range = is_sign ? (float)(1 << (bits - 1)) : (float)(1 << bits);
+    float scale = fullScale / range * gainValue;
+    conv->volt_gain = (float)volt_calib->gain / (float)volt_calib->base * scale;
+    conv->volt_offset = -(float)volt_calib->offset * conv->volt_gain;
+    float limit_lo = is_sign ? -range * scale : 0;
+    float limit_hi = range * scale;
+    conv->volt_min = MIN(limit_lo, limit_hi);
+    conv->volt_max = MAX(limit_lo, limit_hi);
+}
 
-    const volatile uint32_t* raw_buffer = getRawBuffer(channel);
+static inline int32_t acq_SignExtend(const acq_conv_t *conv, uint32_t value){
+    return (int32_t)(value << (32 - conv->bits)) >> (32 - conv->bits);
+}
 
-    if (!raw_buffer) {
-        return RP_EOOR;
-    }
+static inline float acq_ConvertVolt(const acq_conv_t *conv, uint32_t value){
+    float cnts = conv->is_sign ? (float)acq_SignExtend(conv, value) : (float)(value & conv->mask);
+    float volt = cnts * conv->volt_gain + conv->volt_offset;
+    return volt < conv->volt_min ? conv->volt_min : (volt > conv->volt_max ? conv->volt_max : volt);
+}
 
-    rp_pinState_t mode;
+static inline int16_t acq_ConvertRaw(const acq_conv_t *conv, uint32_t value){
+    uint32_t cnts = value & conv->mask;
+    if (conv->is_sign)
+        return cmn_CalibCntsSigned(cnts, conv->bits, conv->raw_gain, conv->raw_base, conv->raw_offset);
+    return cmn_CalibCntsUnsigned(cnts, conv->bits, conv->raw_gain, conv->raw_base, conv->raw_offset);
+}
 
-    if (acq_GetGain(channel, &mode) != RP_OK){
-        return RP_EOOR;
-    }
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
 
-    rp_acq_ac_dc_mode_t power_mode;
-    if (acq_GetAC_DC(channel,&power_mode) != RP_OK){
-        return RP_EOOR;
+/* Converts the samples in groups of four. Returns the number of converted samples */
+static uint32_t acq_ConvertSpanNeon(const acq_conv_t *conv, const uint32_t *src, uint32_t size, int16_t *raw, float *volt){
+    if (raw && conv->raw_shift < 0) {
+        return 0;
     }
 
-    uint_gain_calib_t calib;
-    uint8_t bits = 0;
-    bool is_sign = false;
-    int ret = rp_HPGetFastADCBits(&bits);
-    ret |= rp_HPGetFastADCIsSigned(&is_sign);
+    const int32x4_t ext_l = vdupq_n_s32(32 - conv->bits);
+    const int32x4_t ext_r = vdupq_n_s32(-(32 - conv->bits));
+    const uint32x4_t mask = vdupq_n_u32(conv->mask);
+    const int32x4_t shift = vdupq_n_s32(-conv->raw_shift);
+    const int32x4_t gain = vdupq_n_s32((int32_t)conv->raw_gain);
+    const int32x4_t offset = vdupq_n_s32(conv->raw_offset);
+    const int32x4_t round = vdupq_n_s32((int32_t)(conv->raw_base - 1));
+    const int32x4_t lo = vdupq_n_s32(conv->is_sign ? -(1 << (conv->bits - 1)) : 0);
+    const int32x4_t hi = vdupq_n_s32(conv->is_sign ? (1 << (conv->bits - 1)) : (1 << conv->bits));
+    const float32x4_t v_gain = vdupq_n_f32(conv->volt_gain);
+    const float32x4_t v_offset = vdupq_n_f32(conv->volt_offset);
+    const float32x4_t v_min = vdupq_n_f32(conv->volt_min);
+    const float32x4_t v_max = vdupq_n_f32(conv->volt_max);
+
+    uint32_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        uint32x4_t value = vld1q_u32(src + i);
+        int32x4_t cnts;
+        float32x4_t f_cnts;
+        if (conv->is_sign) {
+            cnts = vshlq_s32(vshlq_s32(vreinterpretq_s32_u32(value), ext_l), ext_r);
+            f_cnts = vcvtq_f32_s32(cnts);
+        } else {
+            cnts = vreinterpretq_s32_u32(vandq_u32(value, mask));
+            f_cnts = vcvtq_f32_u32(vreinterpretq_u32_s32(cnts));
+        }
 
-    switch (mode)
-    {
-        case RP_LOW:
-            ret |= rp_CalibGetFastADCCalibValueI(convertCh(channel),convertPower(power_mode),&calib);
-            break;
+        if (volt) {
+            float32x4_t v = vmlaq_f32(v_offset, f_cnts, v_gain);
+            vst1q_f32(volt + i, vminq_f32(vmaxq_f32(v, v_min), v_max));
+        }
 
-        case RP_HIGH:
-            ret |= rp_CalibGetFastADCCalibValue_1_20I(convertCh(channel),convertPower(power_mode),&calib);
-            break;
+        if (raw) {
+            int32x4_t m = vmulq_s32(vsubq_s32(cnts, offset), gain);
+            if (conv->is_sign) {
+                /* Division by the base rounds towards zero as in cmn_CalibCntsSigned */
+                m = vaddq_s32(m, vandq_s32(vshrq_n_s32(m, 31), round));
+                m = vshlq_s32(m, shift);
+            } else {
+                m = vreinterpretq_s32_u32(vshlq_u32(vreinterpretq_u32_s32(m), shift));
+            }
+            m = vminq_s32(vmaxq_s32(m, lo), hi);
+            vst1_s16(raw + i, vmovn_s32(m));
+        }
+    }
+    return i;
+}
 
-        default:
-            ERROR("Unknown mode: %d",mode);
-            return RP_EOOR;
-            break;
+#endif
+
+static void acq_ConvertSpan(const acq_conv_t *conv, const uint32_t *src, uint32_t size, int16_t *raw, float *volt_f, double *volt_d){
+    float tmp[ACQ_CONV_BLOCK];
+    for (uint32_t block = 0; block < size; block += ACQ_CONV_BLOCK) {
+        uint32_t n = MIN(size - block, ACQ_CONV_BLOCK);
+        int16_t *raw_out = raw ? raw + block : NULL;
+        float *volt_out = volt_f ? volt_f + block : (volt_d ? tmp : NULL);
+        uint32_t i = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+        i = acq_ConvertSpanNeon(conv, src + block, n, raw_out, volt_out);
+#endif
+        for (; i < n; i++) {
+            if (raw_out) raw_out[i] = acq_ConvertRaw(conv, src[block + i]);
+            if (volt_out) volt_out[i] = acq_ConvertVolt(conv, src[block + i]);
+        }
+        if (volt_d) {
+            for (i = 0; i < n; i++) volt_d[block + i] = volt_out[i];
+        }
     }
+}
 
-    if (ret != RP_HW_CALIB_OK){
-        ERROR("Get calibaration: %d",ret);
-        return RP_EOOR;
+/* Reads size samples from the ring at pos into the requested outputs. Any output can be NULL */
+static void acq_ConvertRing(const acq_conv_t *conv, const volatile uint32_t *ring, uint32_t ring_size, uint32_t pos, uint32_t size, int16_t *raw, float *volt_f, double *volt_d){
+    pos %= ring_size;
+    uint32_t first = MIN(size, ring_size - pos);
+    /* The window is read after the acquisition has stopped, so it can be read as plain memory */
+    acq_ConvertSpan(conv, (const uint32_t*)(ring + pos), first, raw, volt_f, volt_d);
+    if (first < size) {
+        acq_ConvertSpan(conv, (const uint32_t*)ring, size - first,
+                        raw ? raw + first : NULL,
+                        volt_f ? volt_f + first : NULL,
+                        volt_d ? volt_d + first : NULL);
     }
+}
 
-    uint32_t gain  = use_calib ?  calib.gain : 1;
-    uint32_t g_base = use_calib ? calib.base : 1;
-    int32_t offset  = use_calib ? calib.offset  : 0;
+int acq_GetDataRaw(rp_channel_t channel, uint32_t pos, uint32_t* size, int16_t* buffer,bool use_calib){
 
-    uint32_t mask = ((uint64_t)1 << bits) - 1;
+    acq_context_t ctx;
+    int ret = acq_GetChannelContext(channel, &ctx);
+    if (ret != RP_OK){
+        return ret;
+    }
 
-    for (uint32_t i = 0; i < (*size); ++i) {
-        uint32_t cnts = (raw_buffer[(pos + i) % ADC_BUFFER_SIZE]) & mask;
-        if (is_sign)
-            buffer[i] = cmn_CalibCntsSigned(cnts,bits,gain,g_base,offset);
-        else
-            buffer[i] = cmn_CalibCntsUnsigned(cnts,bits,gain,g_base,offset);
+    *size = MIN(*size, ADC_BUFFER_SIZE);
+
+    const volatile uint32_t* raw_buffer = getRawBuffer(channel);
+
+    if (!raw_buffer) {
+        return RP_EOOR;
     }
 
+    uint_gain_calib_t no_calib = { .gain = 1, .base = 1, .precision = 0, .offset = 0 };
+    const uint_gain_calib_t *raw_calib = use_calib ? &ctx.ch[channel].calib : &no_calib;
+
+    acq_conv_t conv;
+    acq_InitConv(&conv, ctx.bits, ctx.is_sign, raw_calib, raw_calib, 1, 1);
+    acq_ConvertRing(&conv, raw_buffer, ADC_BUFFER_SIZE, pos, *size, buffer, NULL, NULL);
+
     return RP_OK;
 }
 
 
 int acq_axi_GetDataRaw(rp_channel_t channel, uint32_t pos, uint32_t* size, int16_t* buffer)
 {
-    CHECK_CHANNEL
+    acq_context_t ctx;
+    int ret = acq_GetChannelContext(channel, &ctx);
+    if (ret != RP_OK){
+        return ret;
+    }
 
     const volatile uint16_t* raw_buffer = getAxiRawBuffer(channel);
-    uint32_t buffer_size = 0;
-    switch (channel)
-    {
-    case RP_CH_1:
-        buffer_size = axi_ch_buffer_size_in_samples[0];
-        break;
-    case RP_CH_2:
-        buffer_size = axi_ch_buffer_size_in_samples[1];
-        break;
-    case RP_CH_3:
-        buffer_size = axi_ch_buffer_size_in_samples[2];
-        break;
-    case RP_CH_4:
-        buffer_size = axi_ch_buffer_size_in_samples[3];
-        break;
-    default:
-        return RP_EIPV;
-    }
+    uint32_t buffer_size = axi_ch_buffer_size_in_samples[channel];
 
     if (!raw_buffer) {
         return RP_EOOR;
     }
 
-    rp_pinState_t mode;
-
-    if (acq_GetGain(channel, &mode) != RP_OK){
-        return RP_EOOR;
-    }
-
-    uint8_t bits = 0;
-    bool is_sign = false;
-    int ret = rp_HPGetFastADCBits(&bits);
-    ret |= rp_HPGetFastADCIsSigned(&is_sign);
-
-    if (ret != RP_HW_CALIB_OK){
-        ERROR("Get calibaration: %d",ret);
-        return RP_EOOR;
-    }
-
+    uint8_t bits = ctx.bits;
     uint32_t mask = ((uint64_t)1 << bits) - 1;
 
     for (uint32_t i = 0; i < (*size); ++i) {
         uint32_t cnts = (raw_buffer[(pos + i) % buffer_size]) & mask;
-        if (is_sign)
+        if (ctx.is_sign)
             buffer[i] = cmn_CalibCntsSigned(cnts,bits,1,1,0);
         else
             buffer[i] = cmn_CalibCntsUnsigned(cnts,bits,1,1,0);
-        // printf("i %d pos %x value %d\n",i,(pos + i) % buffer_size,buffer[i] );
     }
-        // printf("\n");
 
     return RP_OK;
 }
 
-int acq_GetDataInBuffer(rp_channel_t channel, uint32_t pos, uint32_t* size,buffers_t *out){
+static int acq_GetDataInBufferEx(const acq_context_t *ctx, rp_channel_t channel, uint32_t pos, uint32_t* size,buffers_t *out){
 
-    CHECK_CHANNEL
+    int ret = acq_CheckContextChannel(ctx, channel);
+    if (ret != RP_OK){
+        return ret;
+    }
 
     *size = MIN(*size, ADC_BUFFER_SIZE);
 
@@ -1168,145 +1464,45 @@ int acq_GetDataInBuffer(rp_channel_t channel, uint32_t pos, uint32_t* size,buffe
         return RP_EOOR;
     }
 
-    rp_pinState_t mode;
-    float fullScale;
-    float gainValue;
-
-    if (acq_GetGainV(channel, &gainValue) != RP_OK){
-        return RP_EOOR;
-    }
-
-    if (acq_GetGain(channel, &mode) != RP_OK){
-        return RP_EOOR;
-    }
+    const acq_channel_context_t *ch = &ctx->ch[channel];
+    uint_gain_calib_t no_calib = { .gain = 1, .base = 1, .precision = 0, .offset = 0 };
 
-    rp_acq_ac_dc_mode_t power_mode;
-    if (acq_GetAC_DC(channel,&power_mode) != RP_OK){
-        return RP_EOOR;
-    }
-
-    if (rp_HPGetHWADCFullScale(&fullScale) != RP_OK){
-        return RP_EOOR;
-    }
-
-    uint_gain_calib_t calib;
-    uint8_t bits = 0;
-
-    bool is_sign = false;
-    int ret = rp_HPGetFastADCBits(&bits);
-    ret |= rp_HPGetFastADCIsSigned(&is_sign);
-
-
-    switch (mode)
-    {
-        case RP_LOW:
-            ret |= rp_CalibGetFastADCCalibValueI(convertCh(channel),convertPower(power_mode),&calib);
-            break;
-
-        case RP_HIGH:
-            ret |= rp_CalibGetFastADCCalibValue_1_20I(convertCh(channel),convertPower(power_mode),&calib);
-            break;
-
-        default:
-            ERROR("Unknown mode: %d",mode);
-            return RP_EOOR;
-            break;
-    }
-
-    if (ret != RP_HW_CALIB_OK){
-        ERROR("Get calibaration: %d",ret);
-        return RP_EOOR;
-    }
-
-    uint32_t gain_raw  = out->use_calib_for_raw ?  calib.gain : 1;
-    uint32_t g_base_raw = out->use_calib_for_raw ? calib.base : 1;
-    int32_t offset_raw  = out->use_calib_for_raw ? calib.offset  : 0;
-
-    uint32_t gain_volt  = out->use_calib_for_volts ?  calib.gain : 1;
-    uint32_t g_base_volt = out->use_calib_for_volts ? calib.base : 1;
-    int32_t offset_volt  = out->use_calib_for_volts ? calib.offset  : 0;
-
-    uint32_t mask = ((uint64_t)1 << bits) - 1;
-
-    bool is_need_raw = out->ch_i[channel] != NULL;
-    bool is_need_vold_f = out->ch_f[channel] != NULL;
-    bool is_need_vold_d = out->ch_d[channel] != NULL;
-    int16_t* iPtr = out->ch_i[channel];
-    float* fPtr = out->ch_f[channel];
-    double* dPtr = out->ch_d[channel];
-
-    for (uint32_t i = 0; i < (*size); ++i) {
-
-        uint32_t cnts = (raw_buffer[(pos + i) % ADC_BUFFER_SIZE]) & mask;
-
-        if (is_need_raw){
-            if (is_sign)
-                iPtr[i] = cmn_CalibCntsSigned(cnts,bits,gain_raw,g_base_raw,offset_raw);
-            else
-                iPtr[i] = cmn_CalibCntsUnsigned(cnts,bits,gain_raw,g_base_raw,offset_raw);
-        }
-
-        if (is_need_vold_d || is_need_vold_f){
-            float value = 0;
-            if (is_sign)
-                value = cmn_convertToVoltSigned(cnts,bits,fullScale,gain_volt,g_base_volt,offset_volt) * gainValue;
-            else
-                value = cmn_convertToVoltUnsigned(cnts,bits,fullScale,gain_volt,g_base_volt,offset_volt) * gainValue;
-            if (is_need_vold_f) fPtr[i] = value;
-            if (is_need_vold_d) dPtr[i] = value;
-        }
-    }
+    acq_conv_t conv;
+    acq_InitConv(&conv, ctx->bits, ctx->is_sign,
+                 out->use_calib_for_raw ? &ch->calib : &no_calib,
+                 out->use_calib_for_volts ? &ch->calib : &no_calib,
+                 ctx->fullScale, ch->gainValue);
+    acq_ConvertRing(&conv, raw_buffer, ADC_BUFFER_SIZE, pos, *size, out->ch_i[channel], out->ch_f[channel], out->ch_d[channel]);
 
     return RP_OK;
 }
 
+int acq_GetDataInBuffer(rp_channel_t channel, uint32_t pos, uint32_t* size,buffers_t *out){
+    acq_context_t ctx;
+    acq_GetContext(&ctx);
+    return acq_GetDataInBufferEx(&ctx, channel, pos, size, out);
+}
+
 int acq_GetData(uint32_t pos,buffers_t *out)
 {
-    uint8_t channels = 0;
-    if (rp_HPGetFastADCChannelsCount(&channels) != RP_HP_OK){
-        channels = 0;
+    acq_context_t ctx;
+    acq_GetContext(&ctx);
+    if (ctx.status != RP_OK){
+        return ctx.status;
     }
 
-    bool fillData = false;
     out->size = MIN(out->size, ADC_BUFFER_SIZE);
 
-    if (channels > 0){
-        uint32_t size = out->size;
-        int ret = acq_GetDataInBuffer(RP_CH_1,pos,&size,out);
-        if (ret != RP_OK){
-            return ret;
-        }
-        fillData = true;
-    }
-
-    if (channels > 1){
-        uint32_t size = out->size;
-        int ret = acq_GetDataInBuffer(RP_CH_2,pos,&size,out);
-        if (ret != RP_OK){
-            return ret;
-        }
-        fillData = true;
-    }
-
-    if (channels > 2){
+    uint8_t channels = MIN(ctx.channels, 4);
+    for (uint8_t ch = 0; ch < channels; ch++){
         uint32_t size = out->size;
-        int ret = acq_GetDataInBuffer(RP_CH_3,pos,&size,out);
+        int ret = acq_GetDataInBufferEx(&ctx, (rp_channel_t)ch, pos, &size, out);
         if (ret != RP_OK){
             return ret;
         }
-        fillData = true;
     }
 
-    if (channels > 3){
-        uint32_t size = out->size;
-        int ret = acq_GetDataInBuffer(RP_CH_4,pos,&size,out);
-        if (ret != RP_OK){
-            return ret;
-        }
-        fillData = true;
-    }
-
-    if (!fillData){
+    if (channels == 0){
         return RP_EOOR;
     }
 
@@ -1367,153 +1563,52 @@ int acq_GetLatestDataRaw(rp_channel_t channel, uint32_t* size, int16_t* buffer)
 
 int acq_GetDataVEx(rp_channel_t channel,  uint32_t pos, uint32_t* size, void* in_buffer,bool is_float){
 
-    CHECK_CHANNEL
+    acq_context_t ctx;
+    int ret = acq_GetChannelContext(channel, &ctx);
+    if (ret != RP_OK){
+        return ret;
+    }
 
     *size = MIN(*size, ADC_BUFFER_SIZE);
 
     const volatile uint32_t* raw_buffer = getRawBuffer(channel);
 
-    float fullScale;
-    float gainValue;
-    rp_pinState_t mode;
-
-    if (acq_GetGainV(channel, &gainValue) != RP_OK){
-        return RP_EOOR;
-    }
-
-    if (rp_HPGetHWADCFullScale(&fullScale) != RP_OK){
-        return RP_EOOR;
-    }
-
-    if (acq_GetGain(channel, &mode) != RP_OK){
-        return RP_EOOR;
-    }
-
-    rp_acq_ac_dc_mode_t power_mode;
-    if (acq_GetAC_DC(channel,&power_mode) != RP_OK){
-        return RP_EOOR;
-    }
-
-    uint8_t bits = 0;
-    uint_gain_calib_t calib;
-    bool is_sign = true;
-
-    int ret = rp_HPGetFastADCBits(&bits);
-    ret |= rp_HPGetFastADCIsSigned(&is_sign);
-
-    switch (mode)
-    {
-        case RP_LOW:
-            ret |= rp_CalibGetFastADCCalibValueI(convertCh(channel),convertPower(power_mode),&calib);
-            break;
-
-        case RP_HIGH:
-            ret |= rp_CalibGetFastADCCalibValue_1_20I(convertCh(channel),convertPower(power_mode),&calib);
-            break;
-
-        default:
-            ERROR("Unknown mode: %d",mode);
-            return RP_EOOR;
-            break;
-    }
+    float *buffer_f = is_float ? (float*)in_buffer: NULL;
+    double *buffer_d = !is_float ? (double*)in_buffer: NULL;
 
-    if (ret != RP_HW_CALIB_OK){
-        ERROR("Get calibaration: %d",ret);
+    if (!raw_buffer) {
         return RP_EOOR;
     }
 
-    float *buffer_f = is_float ? (float*)in_buffer: NULL;
-    double *buffer_d = !is_float ? (double*)in_buffer: NULL;
-    uint32_t cnts;
+    const acq_channel_context_t *ch = &ctx.ch[channel];
 
-    uint32_t mask = ((uint64_t)1 << bits) - 1;
-
-    for (uint32_t i = 0; i < (*size); ++i) {
-        cnts = raw_buffer[(pos + i) % ADC_BUFFER_SIZE] & mask;
-        float value = cmn_convertToVoltSigned(cnts,bits,fullScale,calib.gain,calib.base,calib.offset) * gainValue;
-        if (buffer_f) buffer_f[i] = value;
-        if (buffer_d) buffer_d[i] = value;
-    }
+    acq_conv_t conv;
+    acq_InitConv(&conv, ctx.bits, true, &ch->calib, &ch->calib, ctx.fullScale, ch->gainValue);
+    acq_ConvertRing(&conv, raw_buffer, ADC_BUFFER_SIZE, pos, *size, NULL, buffer_f, buffer_d);
 
     return RP_OK;
 }
 
 int acq_axi_GetDataVEx(rp_channel_t channel,  uint32_t pos, uint32_t* size, void* in_buffer, bool is_float){
 
-    CHECK_CHANNEL
-
-    const volatile uint16_t* raw_buffer = getAxiRawBuffer(channel);
-    uint32_t buffer_size = 0;
-    switch (channel)
-    {
-    case RP_CH_1:
-        buffer_size = axi_ch_buffer_size_in_samples[0];
-        break;
-    case RP_CH_2:
-        buffer_size = axi_ch_buffer_size_in_samples[1];
-        break;
-    case RP_CH_3:
-        buffer_size = axi_ch_buffer_size_in_samples[2];
-        break;
-    case RP_CH_4:
-        buffer_size = axi_ch_buffer_size_in_samples[3];
-        break;
-    default:
-        return RP_EIPV;
-    }
-
-    float fullScale;
-    float gainValue;
-    rp_pinState_t mode;
-
-    if (acq_GetGainV(channel, &gainValue) != RP_OK){
-        return RP_EOOR;
-    }
-
-    if (rp_HPGetHWADCFullScale(&fullScale) != RP_OK){
-        return RP_EOOR;
-    }
-
-    if (acq_GetGain(channel, &mode) != RP_OK){
-        return RP_EOOR;
+    acq_context_t ctx;
+    int ret = acq_GetChannelContext(channel, &ctx);
+    if (ret != RP_OK){
+        return ret;
     }
 
-    rp_acq_ac_dc_mode_t power_mode;
-    if (acq_GetAC_DC(channel,&power_mode) != RP_OK){
-        return RP_EOOR;
-    }
+    const volatile uint16_t* raw_buffer = getAxiRawBuffer(channel);
+    uint32_t buffer_size = axi_ch_buffer_size_in_samples[channel];
 
     if (!raw_buffer) {
         return RP_EOOR;
     }
 
-    uint8_t bits = 0;
-    uint_gain_calib_t calib;
-    bool is_sign = true;
-
-    int ret = rp_HPGetFastADCBits(&bits);
-    ret |= rp_HPGetFastADCIsSigned(&is_sign);
-
-    switch (mode)
-    {
-        case RP_LOW:
-            ret |= rp_CalibGetFastADCCalibValueI(convertCh(channel),convertPower(power_mode),&calib);
-            break;
-
-        case RP_HIGH:
-            ret |= rp_CalibGetFastADCCalibValue_1_20I(convertCh(channel),convertPower(power_mode),&calib);
-            break;
-
-        default:
-            ERROR("Unknown mode: %d",mode);
-            return RP_EOOR;
-            break;
-    }
-
-    if (ret != RP_HW_CALIB_OK){
-        ERROR("Get calibaration: %d",ret);
-        return RP_EOOR;
-    }
+    const acq_channel_context_t *ch = &ctx.ch[channel];
+    const uint_gain_calib_t *calib = &ch->calib;
+    uint8_t bits = ctx.bits;
+    float fullScale = ctx.fullScale;
+    float gainValue = ch->gainValue;
 
     float *buffer_f = is_float ? (float*)in_buffer: NULL;
     double *buffer_d = !is_float ? (double*)in_buffer: NULL;
@@ -1522,7 +1617,7 @@ int acq_axi_GetDataVEx(rp_channel_t channel,  uint32_t pos, uint32_t* size, void
 
     for (uint32_t i = 0; i < (*size); ++i) {
         cnts = raw_buffer[(pos + i) % buffer_size] & mask;
-        float value = cmn_convertToVoltSigned(cnts,bits,fullScale,calib.gain,calib.base,calib.offset) * gainValue;
+        float value = cmn_convertToVoltSigned(cnts,bits,fullScale,calib->gain,calib->base,calib->offset) * gainValue;
         if (buffer_f) buffer_f[i] = value;
         if (buffer_d) buffer_d[i] = value;
     }
@@ -1716,6 +1811,7 @@ int acq_SetAC_DC(rp_channel_t channel,rp_acq_ac_dc_mode_t mode){
     }
 
     *power_mode = status == RP_OK ? mode : RP_DC;
+    acq_InvalidateContext();
 
     return status;
 }
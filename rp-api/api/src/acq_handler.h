@@ -27,6 +27,7 @@
 int acq_SetArmKeep(bool enable);
 int acq_GetArmKeep(bool* state);
 int acq_GetBufferFillState(bool* state);
+int acq_WaitBufferFull(uint32_t timeout_us, bool* state);
 int acq_axi_GetBufferFillState(rp_channel_t channel, bool* state);
 int acq_SetGain(rp_channel_t channel, rp_pinState_t state);
 int acq_GetGain(rp_channel_t channel, rp_pinState_t* state);
@@ -44,6 +45,7 @@ int acq_GetAveraging(bool* enable);
 int acq_SetTriggerSrc(rp_acq_trig_src_t source);
 int acq_GetTriggerSrc(rp_acq_trig_src_t* source);
 int acq_GetTriggerState(rp_acq_trig_state_t* state);
+int acq_WaitTriggered(uint32_t timeout_us, bool* state);
 int acq_SetTriggerDelay(int32_t decimated_data_num);
 int acq_GetTriggerDelay(int32_t* decimated_data_num);
 int acq_SetTriggerDelayNs(int64_t time_ns);
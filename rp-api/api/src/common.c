@@ -12,8 +12,11 @@
  * for more details on the language used herein.
  */
 
+#define _GNU_SOURCE
 #include <fcntl.h>
 #include <unistd.h>
+#include <poll.h>
+#include <time.h>
 #include <sys/mman.h>
 #include <stdio.h>
 #include <math.h>
@@ -25,6 +28,9 @@ int fd = -1;
 
 bool g_DebugReg = false;
 
+/* Cleared when the UIO device has no interrupt */
+static bool g_IrqAvailable = true;
+
 int cmn_Init()
 {
     if (fd == -1) {
@@ -46,6 +52,29 @@ int cmn_Release()
     return RP_OK;
 }
 
+int cmn_WaitInterrupt(uint32_t timeout_us, bool *interrupted)
+{
+    *interrupted = false;
+    if (fd == -1 || !g_IrqAvailable) {
+        return RP_NOTS;
+    }
+
+    /* Unmask the interrupt. UIO without an interrupt rejects the write */
+    uint32_t enable = 1;
+    if (write(fd, &enable, sizeof(enable)) != sizeof(enable)) {
+        g_IrqAvailable = false;
+        return RP_NOTS;
+    }
+
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    struct timespec ts = { .tv_sec = timeout_us / 1000000, .tv_nsec = (timeout_us % 1000000) * 1000 };
+    if (ppoll(&pfd, 1, &ts, NULL) > 0) {
+        uint32_t count = 0;
+        *interrupted = read(fd, &count, sizeof(count)) == sizeof(count);
+    }
+    return RP_OK;
+}
+
 int cmn_Map(size_t size, size_t offset, void** mapped)
 {
     if(fd == -1) {
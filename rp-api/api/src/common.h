@@ -83,6 +83,10 @@ void cmn_enableDebugReg();
 int cmn_Map(size_t size, size_t offset, void** mapped);
 int cmn_Unmap(size_t size, void** mapped);
 
+/* Waits at most timeout_us for the interrupt of the UIO device. Returns RP_NOTS if the device has no interrupt.
+ * The interrupt only wakes up the caller, the caller must check the state it waits for. */
+int cmn_WaitInterrupt(uint32_t timeout_us, bool *interrupted);
+
 int cmn_SetBits(volatile uint32_t* field, uint32_t bits, uint32_t mask);
 int cmn_UnsetBits(volatile uint32_t* field, uint32_t bits, uint32_t mask);
 int cmn_SetValue(volatile uint32_t* field, uint32_t value, uint32_t mask,uint32_t *settedValue);
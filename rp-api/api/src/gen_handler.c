@@ -13,6 +13,7 @@
 */
 
 #include <float.h>
+#include <string.h>
 #include "math.h"
 #include "common.h"
 #include "generate.h"
@@ -65,6 +66,45 @@ bool          ch_LatchTempAlarm[2]       = {0,0};
 rp_gen_gain_t ch_gain[2] = {RP_GAIN_1X,RP_GAIN_1X};
 
 float ch_arbitraryData[2][DAC_BUFFER_SIZE];
+uint32_t ch_arbVersion[2] = {0, 0};
+
+/*
+ * Cache of waveform tables already converted to DAC counts. Amplitude and
+ * offset are applied by the FPGA, frequency and phase only change how the
+ * table is played back, so a table depends on the waveform and its shape
+ * parameters only. The key holds just the parameters that shape the given
+ * waveform, everything else stays zero.
+ */
+#define GEN_TABLE_CACHE_SIZE 4
+
+typedef struct {
+    rp_waveform_t waveform;
+    float dutyCycle;
+    uint16_t riseTimeSamples;
+    uint16_t fallTimeSamples;
+    float frequency;
+    float sweepStartFreq;
+    float sweepEndFreq;
+    float phaseRad;
+    rp_gen_sweep_mode_t sweepMode;
+    rp_gen_sweep_dir_t sweepDir;
+    rp_channel_t channel;
+    uint32_t arbVersion;
+} gen_table_key_t;
+
+typedef struct {
+    bool valid;
+    uint32_t lastUse;
+    gen_table_key_t key;
+    int32_t cnts[DAC_BUFFER_SIZE];
+} gen_table_t;
+
+static gen_table_t g_tables[GEN_TABLE_CACHE_SIZE];
+static uint32_t g_tableUse = 0;
+
+// Open configuration transactions, synthesis is postponed to the last commit
+static uint32_t ch_configDepth[2] = {0, 0};
+static bool     ch_configPending[2] = {false, false};
 
 int gen_SetDefaultValues() {
 
@@ -82,6 +122,10 @@ int gen_SetDefaultValues() {
 
     for(int ch_i = 0; ch_i < channels; ch_i++){
         rp_channel_t ch = convertChFromIndex(ch_i);
+        // Reset drops open transactions and applies the defaults with a single synthesis
+        ch_configDepth[ch] = 0;
+        ch_configPending[ch] = false;
+        gen_beginConfig(ch);
         gen_Disable(ch);
         gen_setFrequency(ch, 1000);
         gen_setRiseFallMin(ch, 0.1);
@@ -101,12 +145,14 @@ int gen_SetDefaultValues() {
         float fs = 0;
         if (rp_HPGetFastDACGain(convertCh(ch), &fs) != RP_HP_OK){
             ERROR("Can't get fast DAC gain");
+            gen_commitConfig(ch);
             return RP_NOTS;
         }
 
         float fsBase = 0;
         if (rp_HPGetHWDACFullScale(&fsBase) != RP_HP_OK){
             ERROR("Can't get fast HW DAC full scale");
+            gen_commitConfig(ch);
             return RP_NOTS;
         }
 
@@ -121,7 +167,7 @@ int gen_SetDefaultValues() {
         gen_setInitGenValue(ch,0);
         if (x5_gain)
             gen_setGainOut(ch,RP_GAIN_1X);
-
+        gen_commitConfig(ch);
     }
 
     generate_ResetSM();
@@ -492,6 +538,7 @@ int gen_setArbWaveform(rp_channel_t channel, float *data, uint32_t length) {
     }
 
     ch_arb_size[channel] = length;
+    ch_arbVersion[channel]++;
     if(ch_waveform[channel ] == RP_WAVEFORM_ARBITRARY){
       	return synthesize_signal(channel);
     }
@@ -811,11 +858,66 @@ int gen_SynchroniseSM() {
     return generate_ResetSM();
 }
 
+static void gen_squareEdges(float frequency, float riseTime, float fallTime, uint16_t buffSize, uint16_t *riseTimeSamples, uint16_t *fallTimeSamples) {
+    float period_us = 1000000.0 / frequency;
+    *riseTimeSamples = (uint16_t) (riseTime / period_us * buffSize);
+    if (*riseTimeSamples == 0) *riseTimeSamples = 1;
+    *fallTimeSamples = (uint16_t) (fallTime / period_us * buffSize);
+    if (*fallTimeSamples == 0) *fallTimeSamples = 1;
+}
+
+static gen_table_t* gen_getTable(const gen_table_key_t *key, bool *found) {
+    gen_table_t *table = &g_tables[0];
+    for (int i = 0; i < GEN_TABLE_CACHE_SIZE; i++) {
+        if (g_tables[i].valid && memcmp(&g_tables[i].key, key, sizeof(gen_table_key_t)) == 0) {
+            g_tables[i].lastUse = ++g_tableUse;
+            *found = true;
+            return &g_tables[i];
+        }
+        // Replace an empty or the least recently used table
+        if (table->valid && (!g_tables[i].valid || g_tables[i].lastUse < table->lastUse)) {
+            table = &g_tables[i];
+        }
+    }
+    table->valid = false;
+    memcpy(&table->key, key, sizeof(gen_table_key_t));
+    table->lastUse = ++g_tableUse;
+    *found = false;
+    return table;
+}
+
+int gen_beginConfig(rp_channel_t channel) {
+
+    CHECK_CHANNEL
+
+    ch_configDepth[channel]++;
+    return RP_OK;
+}
+
+int gen_commitConfig(rp_channel_t channel) {
+
+    CHECK_CHANNEL
+
+    if (ch_configDepth[channel] == 0) {
+        ERROR("Configuration transaction was not started");
+        return RP_EIPV;
+    }
+    if (--ch_configDepth[channel] > 0)
+        return RP_OK;
+    if (!ch_configPending[channel])
+        return RP_OK;
+    ch_configPending[channel] = false;
+    return synthesize_signal(channel);
+}
+
 int synthesize_signal(rp_channel_t channel) {
 
     CHECK_CHANNEL
 
-    float data[DAC_BUFFER_SIZE];
+    if (ch_configDepth[channel]) {
+        ch_configPending[channel] = true;
+        return RP_OK;
+    }
 
     rp_waveform_t waveform = ch_waveform[channel];
     float dutyCycle = ch_dutyCycle[channel];
@@ -833,26 +935,85 @@ int synthesize_signal(rp_channel_t channel) {
     uint16_t buf_size = DAC_BUFFER_SIZE;
     if(waveform == RP_WAVEFORM_SWEEP) phase = 0;
 
-    float scale = 1;
-
+    gen_table_key_t key;
+    memset(&key, 0, sizeof(key));
+    key.waveform = waveform;
     switch (waveform) {
-        case RP_WAVEFORM_SINE     : synthesis_sin      (scale,data,buf_size);                 break;
-        case RP_WAVEFORM_TRIANGLE : synthesis_triangle (scale,data,buf_size);                 break;
-        case RP_WAVEFORM_SQUARE   : synthesis_square   (scale,frequency, riseTime, fallTime, data,buf_size);      break;
-        case RP_WAVEFORM_RAMP_UP  : synthesis_rampUp   (scale,data,buf_size);                 break;
-        case RP_WAVEFORM_RAMP_DOWN: synthesis_rampDown (scale,data,buf_size);                 break;
-        case RP_WAVEFORM_DC       : synthesis_DC       (scale,data,buf_size);                 break;
-        case RP_WAVEFORM_DC_NEG   : synthesis_DC_NEG   (scale,data,buf_size);                 break;
-        case RP_WAVEFORM_PWM      : synthesis_PWM      (scale,dutyCycle, data,buf_size);      break;
-        case RP_WAVEFORM_ARBITRARY: synthesis_arbitrary(scale,channel, data, &size);          break;
-        case RP_WAVEFORM_SWEEP    : synthesis_sweep(scale,frequency,sweepStartFreq,sweepEndFreq,phaseRad,sweep_mode,sweep_dir, data, buf_size);break;
-        default:                    return RP_EIPV;
-    }
-    if (waveform != RP_WAVEFORM_ARBITRARY) size = buf_size;
-    return generate_writeData(channel, data, phase, size);
+        case RP_WAVEFORM_SINE:
+        case RP_WAVEFORM_TRIANGLE:
+        case RP_WAVEFORM_RAMP_UP:
+        case RP_WAVEFORM_RAMP_DOWN:
+        case RP_WAVEFORM_DC:
+        case RP_WAVEFORM_DC_NEG:
+            break;
+        case RP_WAVEFORM_SQUARE:
+            gen_squareEdges(frequency, riseTime, fallTime, buf_size, &key.riseTimeSamples, &key.fallTimeSamples);
+            break;
+        case RP_WAVEFORM_PWM:
+            key.dutyCycle = dutyCycle;
+            break;
+        case RP_WAVEFORM_ARBITRARY:
+            key.channel = channel;
+            key.arbVersion = ch_arbVersion[channel];
+            break;
+        case RP_WAVEFORM_SWEEP:
+            key.frequency = frequency;
+            key.sweepStartFreq = sweepStartFreq;
+            key.sweepEndFreq = sweepEndFreq;
+            key.phaseRad = phaseRad;
+            key.sweepMode = sweep_mode;
+            key.sweepDir = sweep_dir;
+            break;
+        default:
+            return RP_EIPV;
+    }
+
+    if (waveform == RP_WAVEFORM_ARBITRARY)
+        size = ch_arb_size[channel];
+    else
+        size = buf_size;
+
+    bool found = false;
+    gen_table_t *table = gen_getTable(&key, &found);
+    if (!found) {
+        float data[DAC_BUFFER_SIZE];
+        float scale = 1;
+
+        switch (waveform) {
+            case RP_WAVEFORM_SINE     : synthesis_sin      (scale,data,buf_size);                 break;
+            case RP_WAVEFORM_TRIANGLE : synthesis_triangle (scale,data,buf_size);                 break;
+            case RP_WAVEFORM_SQUARE   : synthesis_square   (scale,frequency, riseTime, fallTime, data,buf_size);      break;
+            case RP_WAVEFORM_RAMP_UP  : synthesis_rampUp   (scale,data,buf_size);                 break;
+            case RP_WAVEFORM_RAMP_DOWN: synthesis_rampDown (scale,data,buf_size);                 break;
+            case RP_WAVEFORM_DC       : synthesis_DC       (scale,data,buf_size);                 break;
+            case RP_WAVEFORM_DC_NEG   : synthesis_DC_NEG   (scale,data,buf_size);                 break;
+            case RP_WAVEFORM_PWM      : synthesis_PWM      (scale,dutyCycle, data,buf_size);      break;
+            case RP_WAVEFORM_ARBITRARY: synthesis_arbitrary(scale,channel, data, &size);          break;
+            case RP_WAVEFORM_SWEEP    : synthesis_sweep(scale,frequency,sweepStartFreq,sweepEndFreq,phaseRad,sweep_mode,sweep_dir, data, buf_size);break;
+            default:                    return RP_EIPV;
+        }
+
+        int ret = generate_convertData(data, table->cnts);
+        if (ret != RP_OK)
+            return ret;
+        table->valid = true;
+    }
+    return generate_writeCounts(channel, table->cnts, phase, size);
 }
 
 int synthesis_sin(float scale,float *data_out,uint16_t buffSize) {
+    if (buffSize == DAC_BUFFER_SIZE) {
+        // Only a quarter of the period is computed, the rest is mirrored from it
+        const int quarter = DAC_BUFFER_SIZE / 4;
+        for(int i = 0; i <= quarter; i++) {
+            float v = (float) (sin(2 * M_PI * (float) i / (float) buffSize)) * scale;
+            data_out[i] = v;
+            data_out[2 * quarter - i] = v;
+            data_out[2 * quarter + i] = -v;
+            if (i) data_out[DAC_BUFFER_SIZE - i] = -v;
+        }
+        return RP_OK;
+    }
     for(int unsigned i = 0; i < DAC_BUFFER_SIZE; i++) {
         data_out[i] = (float) (sin(2 * M_PI * (float) i / (float) buffSize)) * scale;
     }
@@ -860,23 +1021,33 @@ int synthesis_sin(float scale,float *data_out,uint16_t buffSize) {
 }
 
 int synthesis_triangle(float scale,float *data_out,uint16_t buffSize) {
+    // Closed form of asin(sin(2*pi*x))*2/pi
     for(int unsigned i = 0; i < DAC_BUFFER_SIZE; i++) {
-        data_out[i] = (float) ((asin(sin(2 * M_PI * (float) i / (float) buffSize)) / M_PI * 2)) * scale;
+        float x = (float) (i % buffSize) / (float) buffSize;
+        float v;
+        if (x < 0.25f)
+            v = 4.0f * x;
+        else if (x < 0.75f)
+            v = 2.0f - 4.0f * x;
+        else
+            v = 4.0f * x - 4.0f;
+        data_out[i] = v * scale;
     }
     return RP_OK;
 }
 
 int synthesis_rampUp(float scale,float *data_out,uint16_t buffSize) {
+    // Closed form of -(acos(cos(pi*x))/pi - 1) = 1 - x, written in reverse order
     data_out[DAC_BUFFER_SIZE -1] = 0;
     for(int unsigned i = 0; i < DAC_BUFFER_SIZE-1; i++) {
-        data_out[DAC_BUFFER_SIZE - i-2] = (float) (-1.0 * (acos(cos(M_PI * (float) i / (float) buffSize)) / M_PI - 1)) * scale;
+        data_out[DAC_BUFFER_SIZE - i-2] = (1.0f - (float) i / (float) buffSize) * scale;
     }
     return RP_OK;
 }
 
 int synthesis_rampDown(float scale,float *data_out,uint16_t buffSize) {
     for(int unsigned i = 0; i < DAC_BUFFER_SIZE; i++) {
-        data_out[i] = (float) (-1.0 * (acos(cos(M_PI * (float) i / (float) buffSize)) / M_PI - 1)) * scale;
+        data_out[i] = (1.0f - (float) i / (float) buffSize) * scale;
     }
     return RP_OK;
 }
@@ -926,11 +1097,9 @@ int synthesis_arbitrary(float scale,rp_channel_t channel, float *data_out, uint3
 
 int synthesis_square(float scale,float frequency, float riseTime, float fallTime, float *data_out, uint16_t buffSize) {
 
-    float period_us = 1000000.0 / frequency;
-    uint16_t riseTimeSamples = (uint16_t) (riseTime / period_us * buffSize);
-    if (riseTimeSamples == 0) riseTimeSamples = 1;
-    uint16_t fallTimeSamples = (uint16_t) (fallTime / period_us * buffSize);
-    if (fallTimeSamples == 0) fallTimeSamples = 1;
+    uint16_t riseTimeSamples = 0;
+    uint16_t fallTimeSamples = 0;
+    gen_squareEdges(frequency, riseTime, fallTime, buffSize, &riseTimeSamples, &fallTimeSamples);
 
     for(int unsigned i = 0; i < DAC_BUFFER_SIZE; i++) {
         int x = (i % buffSize);
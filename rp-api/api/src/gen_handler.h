@@ -79,6 +79,9 @@ int gen_SynchroniseSM();
 int gen_ResetChannelSM(rp_channel_t channel);
 int triggerIfInternal(rp_channel_t channel);
 
+int gen_beginConfig(rp_channel_t channel);
+int gen_commitConfig(rp_channel_t channel);
+
 int synthesize_signal(rp_channel_t channel);
 int synthesis_sin(float scale, float *data_out,uint16_t buffSize);
 int synthesis_sweep(float scale,float frequency,float frequency_start,float frequency_end,float phaseRad,rp_gen_sweep_mode_t mode,rp_gen_sweep_dir_t dir,float *data_out,uint16_t buffSize);
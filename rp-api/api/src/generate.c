@@ -235,33 +235,54 @@ int generate_ResetChannelSM(rp_channel_t channel){
 }
 
 
-int generate_writeData(rp_channel_t channel, float *data, int32_t start, uint32_t length) {
+int generate_convertData(const float *data, int32_t *cnts) {
 
     uint8_t bits = 0;
     if (rp_HPGetFastDACBits(&bits) != RP_HP_OK){
-        fprintf(stderr,"[Error:generate_writeData] Can't get fast DAC bits\n");
+        fprintf(stderr,"[Error:generate_convertData] Can't get fast DAC bits\n");
         return RP_NOTS;
     }
 
     bool is_sign = false;
     if (rp_HPGetFastDACIsSigned(&is_sign) != RP_HP_OK){
-        fprintf(stderr,"[Error:generate_writeData] Can't get fast DAC sign value\n");
+        fprintf(stderr,"[Error:generate_convertData] Can't get fast DAC sign value\n");
         return RP_NOTS;
     }
 
+    for(int i = 0; i < DAC_BUFFER_SIZE; i++) {
+        cnts[i] = cmn_convertToCnt(data[i],bits,1.0,is_sign,1,0);
+    }
+    return RP_OK;
+}
+
+int generate_writeCounts(rp_channel_t channel, const int32_t *cnts, int32_t start, uint32_t length) {
+
     volatile int32_t *dataOut = data_ch[channel];
 
-    volatile ch_properties_t *properties;
-    getChannelPropertiesAddress(&properties, channel);
     generate_setWrapCounter(channel, length);
 
+    start %= DAC_BUFFER_SIZE;
     if (start < 0) start += DAC_BUFFER_SIZE;
-    for(int i = start; i < start + DAC_BUFFER_SIZE; i++) {
-        dataOut[i % DAC_BUFFER_SIZE] =  cmn_convertToCnt(data[i-start],bits,1.0,is_sign,1,0);
+    // The table is written rotated by start, as two plain copies
+    int first = DAC_BUFFER_SIZE - start;
+    for(int i = 0; i < first; i++) {
+        dataOut[start + i] = cnts[i];
+    }
+    for(int i = first; i < DAC_BUFFER_SIZE; i++) {
+        dataOut[i - first] = cnts[i];
     }
     return RP_OK;
 }
 
+int generate_writeData(rp_channel_t channel, float *data, int32_t start, uint32_t length) {
+
+    int32_t cnts[DAC_BUFFER_SIZE];
+    int ret = generate_convertData(data, cnts);
+    if (ret != RP_OK)
+        return ret;
+    return generate_writeCounts(channel, cnts, start, length);
+}
+
 int generate_setAmplitude(rp_channel_t channel,rp_gen_gain_t gain, float amplitude) {
 
     float fsBase = 0;
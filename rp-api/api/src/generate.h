@@ -136,6 +136,10 @@ int generate_ResetSM();
 int generate_ResetChannelSM(rp_channel_t channel);
 
 int generate_writeData(rp_channel_t channel, float *data, int32_t start, uint32_t length);
+// Converts a normalized DAC_BUFFER_SIZE table to DAC counts
+int generate_convertData(const float *data, int32_t *cnts);
+// Writes DAC counts converted by generate_convertData, rotated by start samples
+int generate_writeCounts(rp_channel_t channel, const int32_t *cnts, int32_t start, uint32_t length);
 
 int generate_setAmplitude(rp_channel_t channel, rp_gen_gain_t gain,  float amplitude);
 // int generate_getAmplitude(rp_channel_t channel, rp_gen_gain_t gain, float *amplitude);
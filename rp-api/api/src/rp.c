@@ -864,6 +864,10 @@ int rp_AcqGetBufferFillState(bool* state){
     return acq_GetBufferFillState(state);
 }
 
+int rp_AcqWaitBufferFull(uint32_t timeout_us, bool* state){
+    return acq_WaitBufferFull(timeout_us, state);
+}
+
 int rp_AcqAxiGetBufferFillState(rp_channel_t channel, bool* state){
     if (!rp_HPGetIsDMAinv0_94OrDefault())
         return RP_NOTS;
@@ -936,6 +940,11 @@ int rp_AcqGetTriggerState(rp_acq_trig_state_t* state)
     return acq_GetTriggerState(state);
 }
 
+int rp_AcqWaitTriggered(uint32_t timeout_us, bool* state)
+{
+    return acq_WaitTriggered(timeout_us, state);
+}
+
 int rp_AcqSetTriggerDelay(int32_t decimated_data_num)
 {
     return acq_SetTriggerDelay(decimated_data_num);
@@ -1494,6 +1503,18 @@ int rp_GenResetChannelSM(rp_channel_t channel){
     return gen_ResetChannelSM(channel);
 }
 
+int rp_GenConfigBegin(rp_channel_t channel){
+    if (!rp_HPIsFastDAC_PresentOrDefault())
+        return RP_NOTS;
+    return gen_beginConfig(channel);
+}
+
+int rp_GenConfigCommit(rp_channel_t channel){
+    if (!rp_HPIsFastDAC_PresentOrDefault())
+        return RP_NOTS;
+    return gen_commitConfig(channel);
+}
+
 int rp_GenOutEnableSync(bool enable){
     if (!rp_HPIsFastDAC_PresentOrDefault())
         return RP_NOTS;
@@ -747,6 +747,38 @@ scpi_result_t RP_GenTriggerBoth(scpi_t *context) {
 }
 
 
+/* Sets amplitude and offset in volts at the output and selects the x5 gain where it is present */
+static scpi_result_t RP_GenSetAmpOffset(scpi_t *context, rp_channel_t channel, float amp, float offs) {
+
+    rp_gen_gain_t gain = RP_GAIN_1X;
+    if (rp_HPGetIsGainDACx5OrDefault()){
+        if (fabs(offs) + fabs(amp) > 1.0) {
+            gain = RP_GAIN_5X;
+        }
+    }
+
+    auto result = rp_GenAmp(channel, amp / (gain == RP_GAIN_5X ? 5.0 : 1.0));
+    if(result != RP_OK){
+        RP_LOG_CRIT("Failed to set amplitude: %s", rp_GetError(result));
+        return SCPI_RES_ERR;
+    }
+
+    result = rp_GenOffset(channel, offs / (gain == RP_GAIN_5X ? 5.0 : 1.0));
+    if(result != RP_OK){
+        RP_LOG_CRIT("Failed to set offset: %s", rp_GetError(result));
+        return SCPI_RES_ERR;
+    }
+    if (rp_HPGetIsGainDACx5OrDefault()){
+        result = rp_GenSetGainOut(channel, gain);
+        if(result != RP_OK){
+            RP_LOG_CRIT("Failed to set gain out: %s", rp_GetError(result));
+            return SCPI_RES_ERR;
+        }
+    }
+    RP_LOG_INFO("%s",rp_GetError(result))
+    return SCPI_RES_OK;
+}
+
 scpi_result_t RP_GenAmplitude(scpi_t *context) {
 
     rp_channel_t channel;
@@ -781,12 +813,6 @@ scpi_result_t RP_GenAmplitude(scpi_t *context) {
     if (rp_HPGetIsGainDACx5OrDefault()){
         if (gain == RP_GAIN_5X)
             offset *= 5;
-
-        if (fabs(offset) + fabs(amp) > 1.0) {
-            gain = RP_GAIN_5X;
-        }else{
-            gain = RP_GAIN_1X;
-        }
     }else{
         if (gain == RP_GAIN_5X){
             RP_LOG_CRIT("Failed. Wrong gain out: %s", rp_GetError(result));
@@ -794,26 +820,7 @@ scpi_result_t RP_GenAmplitude(scpi_t *context) {
         }
     }
 
-    result = rp_GenAmp(channel, amp / (gain == RP_GAIN_5X ? 5.0 : 1.0));
-    if(result != RP_OK){
-        RP_LOG_CRIT("Failed to set amplitude: %s", rp_GetError(result));
-        return SCPI_RES_ERR;
-    }
-
-    result = rp_GenOffset(channel, offset / (gain == RP_GAIN_5X ? 5.0 : 1.0));
-    if(result != RP_OK){
-        RP_LOG_CRIT("Failed to set offset: %s", rp_GetError(result));
-        return SCPI_RES_ERR;
-    }
-    if (rp_HPGetIsGainDACx5OrDefault()){
-        result = rp_GenSetGainOut(channel, gain);
-        if(result != RP_OK){
-            RP_LOG_CRIT("Failed to set gain out: %s", rp_GetError(result));
-            return SCPI_RES_ERR;
-        }
-    }
-    RP_LOG_INFO("%s",rp_GetError(result))
-    return SCPI_RES_OK;
+    return RP_GenSetAmpOffset(context, channel, amp, offset);
 }
 
 scpi_result_t RP_GenAmplitudeQ(scpi_t *context) {
@@ -885,12 +892,6 @@ scpi_result_t RP_GenOffset(scpi_t *context) {
 
     if (rp_HPGetIsGainDACx5OrDefault()){
         if (gain == RP_GAIN_5X) amp *= 5;
-
-        if (fabs(offs) + fabs(amp) > 1.0) {
-            gain = RP_GAIN_5X;
-        }else{
-            gain = RP_GAIN_1X;
-        }
     }else{
         if (gain == RP_GAIN_5X){
             RP_LOG_CRIT("Failed. Wrong gain out: %s", rp_GetError(result));
@@ -898,27 +899,108 @@ scpi_result_t RP_GenOffset(scpi_t *context) {
         }
     }
 
+    return RP_GenSetAmpOffset(context, channel, amp, offs);
+}
 
-    result = rp_GenAmp(channel, amp / (gain == RP_GAIN_5X ? 5.0 : 1.0));
-    if(result != RP_OK){
-        RP_LOG_CRIT("Failed to set amplitude: %s", rp_GetError(result));
+/*
+ * SOUR#:APPL <waveform>,<frequency>,<amplitude>[,<offset>[,<phase>]]
+ * Sets the whole channel configuration in one transaction, so the signal is
+ * synthesized and written to the generator only once. Omitted offset and
+ * phase keep their current values.
+ */
+scpi_result_t RP_GenApply(scpi_t *context) {
+
+    rp_channel_t channel;
+    int32_t wave_form;
+    scpi_number_t frequency;
+    scpi_number_t amplitude;
+    scpi_number_t offset;
+    scpi_number_t phase;
+
+    if (RP_ParseChArgvDAC(context, &channel) != RP_OK){
         return SCPI_RES_ERR;
     }
 
-    result = rp_GenOffset(channel, offs / (gain == RP_GAIN_5X ? 5.0 : 1.0));
-    if(result != RP_OK){
-        RP_LOG_CRIT("Failed to set offset: %s", rp_GetError(result));
+    if(!SCPI_ParamChoice(context, scpi_RpWForm, &wave_form, true)){
+        SCPI_LOG_ERR(SCPI_ERROR_MISSING_PARAMETER,"Missing first parameter.");
         return SCPI_RES_ERR;
     }
-    if (rp_HPGetIsGainDACx5OrDefault()){
-        result = rp_GenSetGainOut(channel, gain);
+
+    if (!SCPI_ParamNumber(context, scpi_special_numbers_def, &frequency, true)) {
+        SCPI_LOG_ERR(SCPI_ERROR_MISSING_PARAMETER,"Missing second parameter.");
+        return SCPI_RES_ERR;
+    }
+
+    if (!SCPI_ParamNumber(context, scpi_special_numbers_def, &amplitude, true)) {
+        SCPI_LOG_ERR(SCPI_ERROR_MISSING_PARAMETER,"Missing third parameter.");
+        return SCPI_RES_ERR;
+    }
+
+    bool set_offset = SCPI_ParamNumber(context, scpi_special_numbers_def, &offset, false);
+    bool set_phase = set_offset && SCPI_ParamNumber(context, scpi_special_numbers_def, &phase, false);
+
+    float offs = 0;
+    if (set_offset){
+        offs = offset.content.value;
+    }else{
+        rp_gen_gain_t gain;
+        auto result = rp_GenGetOffset(channel, &offs);
         if(result != RP_OK){
-            RP_LOG_CRIT("Failed to set gain out: %s", rp_GetError(result));
+            RP_LOG_CRIT("Failed to get offset: %s", rp_GetError(result));
             return SCPI_RES_ERR;
         }
+        result = rp_GenGetGainOut(channel, &gain);
+        if(result != RP_OK){
+            RP_LOG_CRIT("Failed to get gain out: %s", rp_GetError(result));
+            return SCPI_RES_ERR;
+        }
+        if (gain == RP_GAIN_5X)
+            offs *= 5;
     }
-    RP_LOG_INFO("%s",rp_GetError(result))
-    return SCPI_RES_OK;
+
+    auto result = rp_GenConfigBegin(channel);
+    if(result != RP_OK){
+        RP_LOG_CRIT("Failed to begin generator configuration: %s", rp_GetError(result));
+        return SCPI_RES_ERR;
+    }
+
+    auto res = SCPI_RES_OK;
+    result = rp_GenWaveform(channel, (rp_waveform_t)wave_form);
+    if(result != RP_OK){
+        RP_LOG_CRIT("Failed to set generate wave form: %s", rp_GetError(result));
+        res = SCPI_RES_ERR;
+    }
+
+    if (res == SCPI_RES_OK){
+        result = rp_GenFreq(channel, frequency.content.value);
+        if(result != RP_OK){
+            RP_LOG_CRIT("Failed to set frequency: %s", rp_GetError(result));
+            res = SCPI_RES_ERR;
+        }
+    }
+
+    if (res == SCPI_RES_OK){
+        res = RP_GenSetAmpOffset(context, channel, amplitude.content.value, offs);
+    }
+
+    if (res == SCPI_RES_OK && set_phase){
+        result = rp_GenPhase(channel, phase.content.value);
+        if(result != RP_OK){
+            RP_LOG_CRIT("Failed to set generate phase. %s", rp_GetError(result));
+            res = SCPI_RES_ERR;
+        }
+    }
+
+    // The transaction is closed even after an error, the parameters set so far are applied
+    result = rp_GenConfigCommit(channel);
+    if(result != RP_OK){
+        RP_LOG_CRIT("Failed to commit generator configuration: %s", rp_GetError(result));
+        return SCPI_RES_ERR;
+    }
+    if (res == SCPI_RES_OK){
+        RP_LOG_INFO("%s",rp_GetError(result))
+    }
+    return res;
 }
 
 scpi_result_t RP_GenOffsetQ(scpi_t *context) {
@@ -29,6 +29,7 @@ scpi_result_t RP_GenAmplitude(scpi_t * context);
 scpi_result_t RP_GenAmplitudeQ(scpi_t * context);
 scpi_result_t RP_GenOffset(scpi_t * context);
 scpi_result_t RP_GenOffsetQ(scpi_t * context);
+scpi_result_t RP_GenApply(scpi_t * context);
 scpi_result_t RP_GenPhase(scpi_t * context);
 scpi_result_t RP_GenPhaseQ(scpi_t * context);
 scpi_result_t RP_GenDutyCycle(scpi_t * context);
@@ -300,6 +300,7 @@ static const scpi_command_t scpi_commands[] = {
     {.pattern = "SOUR#:VOLT?", .callback                = RP_GenAmplitudeQ,},
     {.pattern = "SOUR#:VOLT:OFFS", .callback            = RP_GenOffset,},
     {.pattern = "SOUR#:VOLT:OFFS?", .callback           = RP_GenOffsetQ,},
+    {.pattern = "SOUR#:APPL", .callback                 = RP_GenApply,},
     {.pattern = "SOUR#:PHAS", .callback                 = RP_GenPhase,},
     {.pattern = "SOUR#:PHAS?", .callback                = RP_GenPhaseQ,},
     {.pattern = "SOUR#:DCYC", .callback                 = RP_GenDutyCycle,},